@@ -0,0 +1,197 @@
+#include "activeregion.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const float ActiveRegion::m_cellSize = 512.0f;
+	//////////////////////////////////////////////////////////////////////////
+	ActiveRegion::ActiveRegion(EntityStore& entities)
+		: m_entities(entities), m_columns(1), m_rows(1), m_size(0), m_order(0), m_visit(0), m_time(0.0f)
+	{
+		m_cells.resize(1);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	sf::IntRect ActiveRegion::getCells(const sf::FloatRect& bounds) const
+	{
+		// границы ограничиваются сеткой до перевода в целые: область может быть сколь угодно большой
+		const auto cell = [this](float position, int count)
+		{
+			return static_cast<int>(std::min(std::max(std::floor(position / m_cellSize), 0.0f), static_cast<float>(count - 1)));
+		};
+		const int left = cell(bounds.left, m_columns);
+		const int top = cell(bounds.top, m_rows);
+		const int right = cell(bounds.left + bounds.width, m_columns);
+		const int bottom = cell(bounds.top + bounds.height, m_rows);
+		return sf::IntRect(left, top, right - left + 1, bottom - top + 1);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::place(Entity entity)
+	{
+		const sf::IntRect& cells = m_entries[entity].m_cells;
+		for (int y = cells.top; y < cells.top + cells.height; ++y)
+		{
+			for (int x = cells.left; x < cells.left + cells.width; ++x)
+			{
+				m_cells[y * m_columns + x].push_back(entity);
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::unplace(Entity entity)
+	{
+		const sf::IntRect& cells = m_entries[entity].m_cells;
+		for (int y = cells.top; y < cells.top + cells.height; ++y)
+		{
+			for (int x = cells.left; x < cells.left + cells.width; ++x)
+			{
+				std::vector<Entity>& cell = m_cells[y * m_columns + x];
+				cell.erase(std::remove(cell.begin(), cell.end(), entity), cell.end());
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::reset(const sf::Vector2f& size)
+	{
+		clear();
+		m_columns = std::max(1, static_cast<int>(std::ceil(size.x / m_cellSize)));
+		m_rows = std::max(1, static_cast<int>(std::ceil(size.y / m_cellSize)));
+		m_cells.assign(static_cast<size_t>(m_columns) * m_rows, std::vector<Entity>());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::clear()
+	{
+		m_entries.clear();
+		for (auto& cell : m_cells)
+		{
+			cell.clear();
+		}
+		m_active.clear();
+		m_size = 0;
+		m_order = 0;
+		m_time = 0.0f;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::add(Entity entity)
+	{
+		if (entity >= m_entries.size())
+		{
+			m_entries.resize(entity + 1);
+		}
+		Entry& entry = m_entries[entity];
+		assert(!entry.m_present);
+		entry.m_present = true;
+		entry.m_order = m_order++;
+		entry.m_bounds = m_entities.getBounds(entity);
+		entry.m_cells = getCells(entry.m_bounds);
+		entry.m_active = false;
+		entry.m_moving = m_entities.isMovable(entity);
+		entry.m_visit = 0;
+		entry.m_sleptAt = m_time;
+		place(entity);
+		m_entities.sleep(entity);
+		++m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::remove(Entity entity)
+	{
+		if (entity >= m_entries.size() || !m_entries[entity].m_present)
+		{
+			return;
+		}
+		Entry& entry = m_entries[entity];
+		if (entry.m_active)
+		{
+			m_active.erase(std::find(m_active.begin(), m_active.end(), entity));
+		}
+		unplace(entity);
+		entry.m_present = false;
+		--m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::update(const sf::FloatRect& region, float delta)
+	{
+		m_time += delta;
+		++m_visit;
+
+		// сущность в нескольких клетках проверяется один раз
+		std::vector<Entity> active;
+		active.reserve(m_active.size());
+		const sf::IntRect cells(getCells(region));
+		for (int y = cells.top; y < cells.top + cells.height; ++y)
+		{
+			for (int x = cells.left; x < cells.left + cells.width; ++x)
+			{
+				for (const Entity entity : m_cells[y * m_columns + x])
+				{
+					Entry& entry = m_entries[entity];
+					if (entry.m_visit == m_visit)
+					{
+						continue;
+					}
+					entry.m_visit = m_visit;
+					if (entry.m_bounds.intersects(region))
+					{
+						active.push_back(entity);
+					}
+				}
+			}
+		}
+
+		for (const Entity entity : m_active)
+		{
+			Entry& entry = m_entries[entity];
+			if (entry.m_visit != m_visit || !entry.m_bounds.intersects(region))
+			{
+				entry.m_active = false;
+				entry.m_sleptAt = m_time;
+				m_entities.sleep(entity);
+			}
+		}
+		for (const Entity entity : active)
+		{
+			Entry& entry = m_entries[entity];
+			if (!entry.m_active)
+			{
+				entry.m_active = true;
+				m_entities.wake(entity, m_time - entry.m_sleptAt);
+			}
+		}
+
+		std::sort(active.begin(), active.end(), [this](Entity a, Entity b)
+		{
+			return m_entries[a].m_order < m_entries[b].m_order;
+		});
+		m_active.swap(active);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ActiveRegion::refresh()
+	{
+		for (const Entity entity : m_active)
+		{
+			Entry& entry = m_entries[entity];
+			if (!entry.m_moving)
+			{
+				continue;
+			}
+			entry.m_bounds = m_entities.getBounds(entity);
+			const sf::IntRect cells(getCells(entry.m_bounds));
+			if (cells != entry.m_cells)
+			{
+				unplace(entity);
+				entry.m_cells = cells;
+				place(entity);
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::vector<ActiveRegion::Entity>& ActiveRegion::getActive() const
+	{
+		return m_active;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t ActiveRegion::getSize() const
+	{
+		return m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef ACTIVEREGION_H
+#define ACTIVEREGION_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+
+#include <SFML/Graphics.hpp>
+
+#include "entitystore.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	активная область мира вокруг камеры
+				объекты разложены по клеткам равномерной сетки, поэтому поиск объектов
+				рядом с камерой и обработка шага зависят от числа объектов рядом, а не от размера уровня
+				объект, покинувший область, засыпает, вернувшийся - просыпается и наверстывает время сна
+				спящий объект не движется, поэтому перекладывать по клеткам нужно только активные
+	*/
+	class ActiveRegion final
+	{
+		typedef EntityStore::Entity Entity;
+		// @brief сущность в сетке
+		struct Entry
+		{
+			bool m_present;			// сущность добавлена
+			size_t m_order;			// порядок добавления, он же порядок отрисовки
+			sf::FloatRect m_bounds;	// границы при последней раскладке по клеткам
+			sf::IntRect m_cells;	// занятые клетки: левая верхняя и число по осям
+			bool m_active;
+			bool m_moving;			// может двигаться, перекладывается после шага
+			size_t m_visit;			// номер обновления, в котором объект уже проверен
+			float m_sleptAt;		// время засыпания
+		};
+		static const float m_cellSize;
+
+		EntityStore& m_entities;
+		std::vector<Entry> m_entries;		// по номеру сущности
+		std::vector<std::vector<Entity>> m_cells;
+		int m_columns, m_rows;
+		std::vector<Entity> m_active;		// по порядку добавления
+		size_t m_size;
+		size_t m_order;
+		size_t m_visit;
+		float m_time;					// игровое время с начала уровня
+
+		ActiveRegion(const ActiveRegion&) = delete;
+		ActiveRegion& operator=(const ActiveRegion&) = delete;
+		/*
+			@brief клетки, которые занимает прямоугольник, крайние клетки принимают все за краем сетки
+		*/
+		sf::IntRect getCells(const sf::FloatRect& bounds) const;
+		/*
+			@brief кладет сущность в занятые ей клетки
+		*/
+		void place(Entity entity);
+		/*
+			@brief убирает сущность из ее клеток
+		*/
+		void unplace(Entity entity);
+	public:
+		/*
+			@param entities хранилище сущностей: границы, тела и поведение
+		*/
+		explicit ActiveRegion(EntityStore& entities);
+		~ActiveRegion() = default;
+		/*
+			@brief удаляет все объекты и задает размер сетки
+			@param size размер уровня в пикселях
+		*/
+		void reset(const sf::Vector2f& size);
+		/*
+			@brief удаляет все объекты
+		*/
+		void clear();
+		/*
+			@brief	добавляет сущность спящей, проснется при обновлении в области
+			@param entity сущность
+		*/
+		void add(Entity entity);
+		/*
+			@brief убирает сущность, которая удаляется из мира
+		*/
+		void remove(Entity entity);
+		/*
+			@brief	усыпляет объекты вне области и будит объекты в ней
+			@param region область в пикселях
+			@param delta игровое время с прошлого обновления в секундах
+		*/
+		void update(const sf::FloatRect& region, float delta);
+		/*
+			@brief перекладывает по клеткам сдвинувшиеся активные объекты, вызывается после шага физики
+		*/
+		void refresh();
+		/*
+			@brief активные сущности в порядке добавления
+		*/
+		const std::vector<Entity>& getActive() const;
+		/*
+			@brief количество всех объектов
+		*/
+		size_t getSize() const;
+	};
+}
+
+#endif // !ACTIVEREGION_H
\ No newline at end of file
@@ -21,6 +21,20 @@ namespace GameSpace
 		m_animations[state].second.push_back(frame);
 	}
 	//////////////////////////////////////////////////////////////////////////
+	void Animation::translate(int dx, int dy)
+	{
+		m_defaultFrame.left += dx;
+		m_defaultFrame.top += dy;
+		for (auto& itAnimation : m_animations)
+		{
+			for (auto& itFrame : itAnimation.second.second)
+			{
+				itFrame.left += dx;
+				itFrame.top += dy;
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
 	void Animation::animate(MoveState state, float delta)
 	{
 		if (m_currentState == state)
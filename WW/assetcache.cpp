@@ -0,0 +1,326 @@
+#include "assetcache.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		const char* kindNames[AssetCache::RK_COUNT] = { "levels", "images", "textures", "fonts", "sounds" };
+	}
+	//////////////////////////////////////////////////////////////////////////
+	AssetCache::AssetCache() : m_useCounter(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	template<class T>
+	std::shared_ptr<const T> AssetCache::get(	std::map<std::string, Entry<T>>& entries, Kind kind, const std::string& path,
+												const std::function<std::shared_ptr<const T>(size_t& bytes)>& decode)
+	{
+		std::int64_t modified = 0;
+		Resources::getModifiedTime(path, modified);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto itEntry = entries.find(path);
+			if (itEntry != entries.end() && itEntry->second.m_modified == modified)
+			{
+				++m_report.m_kinds[kind].m_hits;
+				itEntry->second.m_lastUse = ++m_useCounter;
+				return itEntry->second.m_asset;
+			}
+			++m_report.m_kinds[kind].m_misses;
+		}
+
+		// декодирование идет без блокировки, чтобы не останавливать другие потоки;
+		// если два потока декодируют один файл, запомнится последний результат
+		Entry<T> entry;
+		entry.m_bytes = 0;
+		entry.m_asset = decode(entry.m_bytes);
+		entry.m_modified = modified;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		entry.m_lastUse = ++m_useCounter;
+		const std::shared_ptr<const T> asset = entry.m_asset;
+		put(entries, kind, path, std::move(entry));
+		return asset;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	template<class E>
+	void AssetCache::put(std::map<std::string, E>& entries, Kind kind, const std::string& path, E&& entry)
+	{
+		Stats& stats = m_report.m_kinds[kind];
+		stats.m_bytes += entry.m_bytes;
+		auto itEntry = entries.find(path);
+		if (itEntry != entries.end())
+		{
+			stats.m_bytes -= itEntry->second.m_bytes;
+			itEntry->second = std::move(entry);
+		}
+		else
+		{
+			entries.insert(std::make_pair(path, std::move(entry)));
+			++stats.m_count;
+		}
+		evict(entries, kind);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	template<class E>
+	void AssetCache::evict(std::map<std::string, E>& entries, Kind kind)
+	{
+		Stats& stats = m_report.m_kinds[kind];
+		while (stats.m_budget && stats.m_bytes > stats.m_budget)
+		{
+			// записей немного (сотни), поэтому самая давняя ищется перебором
+			auto oldest = entries.end();
+			for (auto itEntry = entries.begin(); itEntry != entries.end(); ++itEntry)
+			{
+				if (itEntry->second.m_asset.use_count() == 1 &&
+					(oldest == entries.end() || itEntry->second.m_lastUse < oldest->second.m_lastUse))
+				{
+					oldest = itEntry;
+				}
+			}
+			if (oldest == entries.end())
+			{	// все записи используются: бюджет превышен, пока их не отпустят
+				break;
+			}
+			stats.m_bytes -= oldest->second.m_bytes;
+			--stats.m_count;
+			++stats.m_evictions;
+			entries.erase(oldest);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	template<class E>
+	void AssetCache::drop(std::map<std::string, E>& entries, Kind kind, const std::string& path)
+	{
+		auto itEntry = entries.find(path);
+		if (itEntry == entries.end())
+		{
+			return;
+		}
+		Stats& stats = m_report.m_kinds[kind];
+		stats.m_bytes -= itEntry->second.m_bytes;
+		--stats.m_count;
+		entries.erase(itEntry);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool AssetCache::isCurrent(const LevelData& level)
+	{
+		for (const auto& source : level.m_sources)
+		{
+			std::int64_t modified = 0;
+			if (!Resources::getModifiedTime(source.m_path, modified) || modified != source.m_modified)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	LevelPtr AssetCache::getLevel(const std::string& path)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto itLevel = m_levels.find(path);
+			if (itLevel != m_levels.end() && isCurrent(*itLevel->second.m_asset))
+			{
+				++m_report.m_kinds[RK_LEVEL].m_hits;
+				itLevel->second.m_lastUse = ++m_useCounter;
+				return itLevel->second.m_asset;
+			}
+			++m_report.m_kinds[RK_LEVEL].m_misses;
+		}
+
+		Entry<LevelData> entry;
+		entry.m_asset = std::make_shared<LevelData>(LevelFile::load(path));
+		entry.m_modified = 0;	// уровень проверяется по всем исходным файлам
+		// основную память уровня занимают слои тайлов
+		entry.m_bytes = sizeof(LevelData);
+		for (const auto& layer : entry.m_asset->m_layers)
+		{
+			entry.m_bytes += layer.m_gids.size() * sizeof(std::uint32_t);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		entry.m_lastUse = ++m_useCounter;
+		const LevelPtr level = entry.m_asset;
+		put(m_levels, RK_LEVEL, path, std::move(entry));
+		return level;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	ImagePtr AssetCache::getImage(const std::string& path)
+	{
+		return get<sf::Image>(m_images, RK_IMAGE, path, [&path](size_t& bytes) -> ImagePtr
+		{
+			auto image = std::make_shared<sf::Image>();
+			if (!Resources::load(*image, path))
+			{
+				throw std::runtime_error("GameSpace::AssetCache::getImage if (!Resources::load(*image, path))");
+			}
+			bytes = static_cast<size_t>(image->getSize().x) * image->getSize().y * 4;
+			return image;
+		});
+	}
+	//////////////////////////////////////////////////////////////////////////
+	FontPtr AssetCache::getFont(const std::string& path)
+	{
+		return get<sf::Font>(m_fonts, RK_FONT, path, [&path](size_t& bytes) -> FontPtr
+		{
+			// шрифт читает данные по мере надобности, поэтому владеет ресурсом
+			const ResourcePtr data = Resources::open(path);
+			std::shared_ptr<sf::Font> font(new sf::Font, [data](sf::Font* font)
+			{
+				delete font;
+			});
+			if (!data || !font->loadFromMemory(data->getData(), data->getSize()))
+			{
+				throw std::runtime_error("GameSpace::AssetCache::getFont if (!font->loadFromMemory(...))");
+			}
+			bytes = data->getSize();
+			return font;
+		});
+	}
+	//////////////////////////////////////////////////////////////////////////
+	SoundBufferPtr AssetCache::getSound(const std::string& path)
+	{
+		return get<sf::SoundBuffer>(m_sounds, RK_SOUND, path, [&path](size_t& bytes) -> SoundBufferPtr
+		{
+			auto sound = std::make_shared<sf::SoundBuffer>();
+			if (!Resources::load(*sound, path))
+			{
+				throw std::runtime_error("GameSpace::AssetCache::getSound if (!Resources::load(*sound, path))");
+			}
+			bytes = static_cast<size_t>(sound->getSampleCount()) * sizeof(sf::Int16);
+			return sound;
+		});
+	}
+	//////////////////////////////////////////////////////////////////////////
+	AtlasPtr AssetCache::findAtlas(const std::string& name, const std::vector<ImagePtr>& images)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto itAtlas = m_atlases.find(name);
+		// изображения из кэша сравниваются по адресу: новый файл - новый объект,
+		// удаленное по бюджету изображение тоже означает новый объект
+		bool isSame = itAtlas != m_atlases.end() && itAtlas->second.m_images.size() == images.size();
+		for (size_t i = 0; isSame && i < images.size(); ++i)
+		{
+			isSame = itAtlas->second.m_images[i].lock() == images[i];
+		}
+		if (isSame)
+		{
+			++m_report.m_kinds[RK_TEXTURE].m_hits;
+			itAtlas->second.m_lastUse = ++m_useCounter;
+			return itAtlas->second.m_asset;
+		}
+		++m_report.m_kinds[RK_TEXTURE].m_misses;
+		return nullptr;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::putAtlas(const std::string& name, const std::vector<ImagePtr>& images, const AtlasPtr& atlas)
+	{
+		AtlasEntry entry;
+		entry.m_asset = atlas;
+		entry.m_modified = 0;
+		entry.m_bytes = atlas->getByteSize();
+		entry.m_images.assign(images.begin(), images.end());
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		entry.m_lastUse = ++m_useCounter;
+		put(m_atlases, RK_TEXTURE, name, std::move(entry));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::setBudget(Kind kind, size_t bytes)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_report.m_kinds[kind].m_budget = bytes;
+		}
+		trim();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::trim()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		evict(m_levels, RK_LEVEL);
+		evict(m_images, RK_IMAGE);
+		evict(m_atlases, RK_TEXTURE);
+		evict(m_fonts, RK_FONT);
+		evict(m_sounds, RK_SOUND);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::invalidate(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		drop(m_images, RK_IMAGE, path);
+		drop(m_fonts, RK_FONT, path);
+		drop(m_sounds, RK_SOUND, path);
+		// атлас из прежнего изображения не найдется сам: изображение будет новым объектом
+		std::vector<std::string> levels;
+		for (const auto& level : m_levels)
+		{
+			for (const auto& source : level.second.m_asset->m_sources)
+			{
+				if (source.m_path == path)
+				{
+					levels.push_back(level.first);
+					break;
+				}
+			}
+		}
+		for (const auto& level : levels)
+		{
+			drop(m_levels, RK_LEVEL, level);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_levels.clear();
+		m_images.clear();
+		m_fonts.clear();
+		m_sounds.clear();
+		m_atlases.clear();
+		for (auto& stats : m_report.m_kinds)
+		{
+			stats.m_count = 0;
+			stats.m_bytes = 0;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	AssetCache::Report AssetCache::getReport() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_report;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::resetReport()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& stats : m_report.m_kinds)
+		{
+			stats.m_hits = 0;
+			stats.m_misses = 0;
+			stats.m_evictions = 0;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void AssetCache::printReport(std::ostream& out) const
+	{
+		const Report report = getReport();
+		out << "Assets:" << std::endl;
+		for (size_t kind = 0; kind < RK_COUNT; ++kind)
+		{
+			const Stats& stats = report.m_kinds[kind];
+			out << "  " << kindNames[kind] << ": " << stats.m_count << " entries, " << stats.m_bytes / 1024 << " KB";
+			if (stats.m_budget)
+			{
+				out << " of " << stats.m_budget / 1024 << " KB";
+			}
+			out << ", " << stats.m_hits << " hits, " << stats.m_misses << " loaded, "
+				<< stats.m_evictions << " evicted" << std::endl;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <ostream>
+#include <cstdint>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+
+#include "leveldata.h"
+#include "levelfile.h"
+#include "resources.h"
+#include "atlas.h"
+#include "hud.h"
+#include "music.h"
+
+namespace GameSpace
+{
+	// @brief декодированное изображение, общее для всех загрузок
+	typedef std::shared_ptr<const sf::Image> ImagePtr;
+	// @brief разобранный уровень, включая описания игроков и анимаций
+	typedef std::shared_ptr<const LevelData> LevelPtr;
+	// @brief собранный атлас уровня вместе с его страницами в видеопамяти
+	typedef std::shared_ptr<const TextureAtlas> AtlasPtr;
+	/*
+		@brief	ресурсы, переживающие загрузку уровня
+				запись действительна, пока не изменилось время изменения файла,
+				поэтому повторный запуск уровня обходится без чтения и декодирования,
+				методы можно вызывать из нескольких потоков одновременно
+				для каждого вида ресурсов задается бюджет памяти: при превышении
+				удаляются давно не использованные записи, на которые никто не ссылается
+	*/
+	class AssetCache final
+	{
+	public:
+		// @brief вид ресурса, у каждого свой бюджет и статистика
+		enum Kind {	RK_LEVEL,		// разобранные уровни
+					RK_IMAGE,		// изображения в памяти процесса
+					RK_TEXTURE,		// страницы атласов в видеопамяти
+					RK_FONT,		// шрифты вместе с данными файла
+					RK_SOUND,		// звуковые буферы
+					RK_COUNT
+				};
+		// @brief статистика одного вида ресурсов
+		struct Stats
+		{
+			size_t m_count;		// записей сейчас
+			size_t m_bytes;		// занято записями сейчас
+			size_t m_budget;	// бюджет в байтах, 0 - без ограничения
+			size_t m_hits;		// ресурсов выдано из кэша
+			size_t m_misses;	// ресурсов прочитано с диска
+			size_t m_evictions;	// записей удалено по бюджету
+			Stats() : m_count(0), m_bytes(0), m_budget(0), m_hits(0), m_misses(0), m_evictions(0)
+			{}
+		};
+		// @brief статистика всех видов ресурсов
+		struct Report
+		{
+			Stats m_kinds[RK_COUNT];
+		};
+	private:
+		// @brief ресурс, время изменения файла, из которого он получен, и учет памяти
+		template<class T>
+		struct Entry
+		{
+			std::shared_ptr<const T> m_asset;
+			std::int64_t m_modified;
+			size_t m_bytes;
+			std::uint64_t m_lastUse;	// отметка последнего обращения для LRU
+		};
+		// @brief атлас и изображения, из которых он собран
+		struct AtlasEntry : Entry<TextureAtlas>
+		{
+			// слабые ссылки: изображения можно удалить раньше атласа
+			std::vector<std::weak_ptr<const sf::Image>> m_images;
+		};
+
+		mutable std::mutex m_mutex;
+		std::map<std::string, Entry<LevelData>> m_levels;
+		std::map<std::string, Entry<sf::Image>> m_images;
+		std::map<std::string, Entry<sf::Font>> m_fonts;
+		std::map<std::string, Entry<sf::SoundBuffer>> m_sounds;
+		std::map<std::string, AtlasEntry> m_atlases;
+		Report m_report;
+		std::uint64_t m_useCounter;
+
+		AssetCache(const AssetCache&) = delete;
+		AssetCache& operator=(const AssetCache&) = delete;
+		/*
+			@brief	выдает ресурс из записей или декодирует его вне блокировки
+			@param entries записи ресурсов данного вида
+			@param kind вид ресурса
+			@param path путь к файлу
+			@param decode загрузка ресурса при промахе, возвращает и занятую память
+		*/
+		template<class T>
+		std::shared_ptr<const T> get(	std::map<std::string, Entry<T>>& entries, Kind kind, const std::string& path,
+										const std::function<std::shared_ptr<const T>(size_t& bytes)>& decode);
+		/*
+			@brief	заменяет запись с учетом памяти и освобождает место по бюджету,
+					вызывается под блокировкой
+		*/
+		template<class E>
+		void put(std::map<std::string, E>& entries, Kind kind, const std::string& path, E&& entry);
+		/*
+			@brief	удаляет самые давние записи без внешних ссылок, пока вид не уложится в бюджет,
+					вызывается под блокировкой
+		*/
+		template<class E>
+		void evict(std::map<std::string, E>& entries, Kind kind);
+		/*
+			@brief удаляет запись файла, если она есть, вызывается под блокировкой
+		*/
+		template<class E>
+		void drop(std::map<std::string, E>& entries, Kind kind, const std::string& path);
+		/*
+			@brief не изменились ли файлы, из которых собран уровень
+		*/
+		static bool isCurrent(const LevelData& level);
+	public:
+		AssetCache();
+		~AssetCache() = default;
+		/*
+			@brief	уровень по пути к tmx
+					при промахе читается через LevelFile::load
+		*/
+		LevelPtr getLevel(const std::string& path);
+		/*
+			@brief декодированное изображение
+		*/
+		ImagePtr getImage(const std::string& path);
+		/*
+			@brief загруженный шрифт
+		*/
+		FontPtr getFont(const std::string& path);
+		/*
+			@brief загруженный звуковой буфер
+		*/
+		SoundBufferPtr getSound(const std::string& path);
+		/*
+			@brief	атлас, собранный ранее из тех же изображений
+			@param name имя уровня
+			@param images изображения в порядке добавления в атлас
+			@ret   атлас или nullptr
+		*/
+		AtlasPtr findAtlas(const std::string& name, const std::vector<ImagePtr>& images);
+		/*
+			@brief	запоминает собранный атлас уровня
+					вызывается из потока отрисовки: удаление атласов освобождает видеопамять
+		*/
+		void putAtlas(const std::string& name, const std::vector<ImagePtr>& images, const AtlasPtr& atlas);
+		/*
+			@brief	задает бюджет памяти вида ресурсов
+			@param kind вид ресурса
+			@param bytes бюджет в байтах, 0 - без ограничения
+		*/
+		void setBudget(Kind kind, size_t bytes);
+		/*
+			@brief	освобождает записи сверх бюджета, на которые больше никто не ссылается
+					вызывается из потока отрисовки, например после сборки уровня
+		*/
+		void trim();
+		/*
+			@brief	удаляет записи, полученные из файла, и уровни, собранные из него
+					время изменения файла хранится в секундах, поэтому сохранение
+					дважды за секунду не видно по нему, и перезагрузка уровня
+					сбрасывает измененные файлы явно
+			@param path путь к файлу
+		*/
+		void invalidate(const std::string& path);
+		/*
+			@brief удаляет все записи
+		*/
+		void clear();
+		/*
+			@brief статистика: текущие записи и счетчики с момента последнего сброса
+		*/
+		Report getReport() const;
+		/*
+			@brief сбрасывает счетчики обращений и удалений
+		*/
+		void resetReport();
+		/*
+			@brief выводит статистику в поток
+		*/
+		void printReport(std::ostream& out) const;
+	};
+}
+
+#endif // !ASSETCACHE_H
\ No newline at end of file
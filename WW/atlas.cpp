@@ -0,0 +1,192 @@
+#include "atlas.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const unsigned TextureAtlas::m_defaultPageSize = 2048;
+	const unsigned TextureAtlas::m_padding = 1;
+	//////////////////////////////////////////////////////////////////////////
+	TextureAtlas::TextureAtlas()
+		: m_packedPixels(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureAtlas::add(const std::string& key, const sf::Image& image)
+	{
+		if (contains(key))
+		{
+			return;
+		}
+		Pending pending;
+		pending.m_key = key;
+		pending.m_image = image;
+		m_pending.push_back(pending);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool TextureAtlas::contains(const std::string& key) const
+	{
+		if (m_regions.find(key) != m_regions.end())
+		{
+			return true;
+		}
+		return std::find_if(m_pending.begin(), m_pending.end(),
+							[&key](const Pending& pending){ return pending.m_key == key; }) != m_pending.end();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	sf::Vector2u TextureAtlas::place(	std::vector<Page>& pages, unsigned pageSize,
+										unsigned width, unsigned height, size_t& pageIndex)
+	{
+		for (pageIndex = 0; pageIndex < pages.size(); ++pageIndex)
+		{
+			Page& page = pages[pageIndex];
+			for (auto& shelf : page.m_shelves)
+			{
+				if (height <= shelf.m_height && shelf.m_usedWidth + width <= page.m_width)
+				{
+					const sf::Vector2u position(shelf.m_usedWidth, shelf.m_top);
+					shelf.m_usedWidth += width;
+					page.m_usedWidth = std::max(page.m_usedWidth, shelf.m_usedWidth);
+					return position;
+				}
+			}
+			if (page.m_usedHeight + height <= page.m_height && width <= page.m_width)
+			{	// новая полка под последней
+				Shelf shelf = { page.m_usedHeight, height, width };
+				page.m_shelves.push_back(shelf);
+				page.m_usedHeight += height;
+				page.m_usedWidth = std::max(page.m_usedWidth, width);
+				return sf::Vector2u(0, shelf.m_top);
+			}
+		}
+		// изображение больше страницы получает собственную страницу
+		Page page;
+		page.m_width = std::max(pageSize, width);
+		page.m_height = std::max(pageSize, height);
+		Shelf shelf = { 0, height, width };
+		page.m_shelves.push_back(shelf);
+		page.m_usedWidth = width;
+		page.m_usedHeight = height;
+		pages.push_back(page);
+		pageIndex = pages.size() - 1;
+		return sf::Vector2u(0, 0);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureAtlas::build(TextureCache& cache, const std::string& name)
+	{
+		using namespace std;
+
+		if (m_pending.empty())
+		{
+			return;
+		}
+
+		const unsigned maxSize = cache.getMaximumSize();
+		const unsigned pageSize = min(maxSize, m_defaultPageSize);
+
+		// высокие изображения первыми: полки заполняются плотнее
+		stable_sort(m_pending.begin(), m_pending.end(), [](const Pending& a, const Pending& b)
+		{
+			return a.m_image.getSize().y > b.m_image.getSize().y;
+		});
+
+		vector<Page> pages;
+		vector<pair<size_t, sf::Vector2u>> placement(m_pending.size());
+		for (size_t i = 0; i < m_pending.size(); ++i)
+		{
+			const auto size = m_pending[i].m_image.getSize();
+			if (size.x + 2 * m_padding > maxSize || size.y + 2 * m_padding > maxSize)
+			{
+				throw runtime_error("GameSpace::TextureAtlas::build if (size > maxSize)");
+			}
+			placement[i].second = place(pages, pageSize, size.x + 2 * m_padding, size.y + 2 * m_padding, placement[i].first);
+		}
+
+		vector<sf::Image> pageImages(pages.size());
+		for (size_t i = 0; i < pages.size(); ++i)
+		{
+			pageImages[i].create(pages[i].m_usedWidth, pages[i].m_usedHeight, sf::Color::Transparent);
+		}
+
+		vector<sf::IntRect> rects(m_pending.size());
+		for (size_t i = 0; i < m_pending.size(); ++i)
+		{
+			const sf::Image& image = m_pending[i].m_image;
+			sf::Image& pageImage = pageImages[placement[i].first];
+			const unsigned width = image.getSize().x;
+			const unsigned height = image.getSize().y;
+			const unsigned x = placement[i].second.x + m_padding;
+			const unsigned y = placement[i].second.y + m_padding;
+
+			pageImage.copy(image, x, y);
+			if (width > 0 && height > 0)
+			{	// края продублированы в поля, чтобы при фильтрации не захватывать соседей
+				pageImage.copy(image, x - 1, y, sf::IntRect(0, 0, 1, height));
+				pageImage.copy(image, x + width, y, sf::IntRect(width - 1, 0, 1, height));
+				pageImage.copy(image, x, y - 1, sf::IntRect(0, 0, width, 1));
+				pageImage.copy(image, x, y + height, sf::IntRect(0, height - 1, width, 1));
+			}
+			rects[i] = sf::IntRect(x, y, width, height);
+			m_packedPixels += static_cast<size_t>(width) * height;
+		}
+
+		const size_t firstPage = m_pages.size();
+		for (size_t i = 0; i < pageImages.size(); ++i)
+		{
+			m_pages.push_back(cache.get(name + "#atlas" + to_string(firstPage + i), pageImages[i]));
+		}
+
+		for (size_t i = 0; i < m_pending.size(); ++i)
+		{
+			TextureRegion& region = m_regions[m_pending[i].m_key];
+			region.m_texture = m_pages[firstPage + placement[i].first];
+			region.m_rect = rects[i];
+		}
+		m_pending.clear();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const TextureRegion& TextureAtlas::get(const std::string& key) const
+	{
+		const auto itRegion = m_regions.find(key);
+		if (itRegion == m_regions.end())
+		{
+			throw std::runtime_error("GameSpace::TextureAtlas::get if (itRegion == m_regions.end())");
+		}
+		return itRegion->second;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureAtlas::clear()
+	{
+		m_pending.clear();
+		m_regions.clear();
+		m_pages.clear();
+		m_packedPixels = 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t TextureAtlas::getPageCount() const
+	{
+		return m_pages.size();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t TextureAtlas::getByteSize() const
+	{
+		size_t bytes = 0;
+		for (const auto& page : m_pages)
+		{
+			bytes += static_cast<size_t>(page->getSize().x) * page->getSize().y * 4;
+		}
+		return bytes;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureAtlas::printReport(std::ostream& out) const
+	{
+		size_t pagePixels = 0;
+		for (const auto& page : m_pages)
+		{
+			pagePixels += static_cast<size_t>(page->getSize().x) * page->getSize().y;
+		}
+		out << "Atlas: " << m_regions.size() << " images in " << m_pages.size() << " pages, "
+			<< (pagePixels ? m_packedPixels * 100 / pagePixels : 0) << "% used" << std::endl;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+
+#include "texturecache.h"
+
+namespace GameSpace
+{
+	// @brief участок текстуры: страница атласа и прямоугольник на ней
+	struct TextureRegion
+	{
+		TexturePtr m_texture;
+		sf::IntRect m_rect;
+	};
+	/*
+		@brief	атлас текстур
+				изображения уровня собираются в несколько больших страниц,
+				объекты ссылаются на участки страниц, что позволяет
+				рисовать их без смены текстуры
+	*/
+	class TextureAtlas final
+	{
+		// @brief изображение, ожидающее упаковки
+		struct Pending
+		{
+			std::string m_key;
+			sf::Image m_image;
+		};
+		// @brief полка страницы: ряд изображений одной высоты
+		struct Shelf
+		{
+			unsigned m_top, m_height, m_usedWidth;
+		};
+		// @brief страница во время упаковки
+		struct Page
+		{
+			std::vector<Shelf> m_shelves;
+			unsigned m_width, m_height;			// размер страницы
+			unsigned m_usedWidth, m_usedHeight;	// занятая область
+		};
+
+		static const unsigned m_defaultPageSize;
+		static const unsigned m_padding;
+
+		std::vector<Pending> m_pending;
+		std::map<std::string, TextureRegion> m_regions;
+		std::vector<TexturePtr> m_pages;
+		size_t m_packedPixels;
+
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+		/*
+			@brief размещает прямоугольник на одной из страниц
+			@param pages страницы
+			@param pageSize размер новой страницы
+			@param width ширина с полями
+			@param height высота с полями
+			@param pageIndex номер страницы, на которую помещен прямоугольник
+			@ret   позиция на странице
+		*/
+		static sf::Vector2u place(	std::vector<Page>& pages, unsigned pageSize,
+									unsigned width, unsigned height, size_t& pageIndex);
+	public:
+		TextureAtlas();
+		~TextureAtlas() = default;
+		/*
+			@brief добавляет изображение в очередь упаковки
+			@param key ключ изображения (путь к файлу)
+			@param image изображение
+		*/
+		void add(const std::string& key, const sf::Image& image);
+		/*
+			@brief проверяет, было ли изображение уже добавлено
+			@param key ключ изображения
+		*/
+		bool contains(const std::string& key) const;
+		/*
+			@brief упаковывает добавленные изображения и загружает страницы в видеопамять
+			@param cache реестр, через который загружаются страницы
+			@param name имя атласа, используется в ключах страниц
+		*/
+		void build(TextureCache& cache, const std::string& name);
+		/*
+			@brief участок страницы для изображения
+			@param key ключ изображения
+			@ret   страница и прямоугольник на ней
+		*/
+		const TextureRegion& get(const std::string& key) const;
+		/*
+			@brief удаляет все страницы и ожидающие изображения
+		*/
+		void clear();
+		/*
+			@brief количество страниц
+		*/
+		size_t getPageCount() const;
+		/*
+			@brief память страниц в видеопамяти, байт
+		*/
+		size_t getByteSize() const;
+		/*
+			@brief выводит сведения об упаковке в поток
+			@param out поток для вывода
+		*/
+		void printReport(std::ostream& out) const;
+	};
+}
+
+#endif // !ATLAS_H
\ No newline at end of file
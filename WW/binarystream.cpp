@@ -0,0 +1,168 @@
+#include "binarystream.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeU32(std::uint32_t value)
+	{
+		writeBytes(&value, sizeof(value));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeI32(std::int32_t value)
+	{
+		writeBytes(&value, sizeof(value));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeU64(std::uint64_t value)
+	{
+		writeBytes(&value, sizeof(value));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeI64(std::int64_t value)
+	{
+		writeBytes(&value, sizeof(value));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeFloat(float value)
+	{
+		writeBytes(&value, sizeof(value));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeString(const std::string& value)
+	{
+		writeU32(static_cast<std::uint32_t>(value.size()));
+		writeBytes(value.data(), value.size());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::writeBytes(const void* data, size_t size)
+	{
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+		m_data.insert(m_data.end(), bytes, bytes + size);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::align(size_t alignment)
+	{
+		while (m_data.size() % alignment)
+		{
+			m_data.push_back(0);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t BinaryWriter::beginSection(std::uint32_t tag)
+	{
+		writeU32(tag);
+		const size_t position = m_data.size();
+		writeU32(0);
+		return position;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryWriter::endSection(size_t position)
+	{
+		const std::uint32_t size = static_cast<std::uint32_t>(m_data.size() - position - sizeof(std::uint32_t));
+		std::memcpy(&m_data[position], &size, sizeof(size));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::vector<std::uint8_t>& BinaryWriter::getData() const
+	{
+		return m_data;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	BinaryReader::BinaryReader(const std::uint8_t* data, size_t size)
+		: m_data(data), m_size(size), m_pos(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryReader::require(size_t size) const
+	{
+		if (m_size - m_pos < size)
+		{
+			throw std::runtime_error("GameSpace::BinaryReader::require if (m_size - m_pos < size)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint32_t BinaryReader::readU32()
+	{
+		std::uint32_t value;
+		readBytes(&value, sizeof(value));
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::int32_t BinaryReader::readI32()
+	{
+		std::int32_t value;
+		readBytes(&value, sizeof(value));
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint64_t BinaryReader::readU64()
+	{
+		std::uint64_t value;
+		readBytes(&value, sizeof(value));
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::int64_t BinaryReader::readI64()
+	{
+		std::int64_t value;
+		readBytes(&value, sizeof(value));
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	float BinaryReader::readFloat()
+	{
+		float value;
+		readBytes(&value, sizeof(value));
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::string BinaryReader::readString()
+	{
+		const std::uint32_t size = readU32();
+		require(size);
+		const std::string value(reinterpret_cast<const char*>(m_data + m_pos), size);
+		m_pos += size;
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryReader::readBytes(void* data, size_t size)
+	{
+		require(size);
+		std::memcpy(data, m_data + m_pos, size);
+		m_pos += size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void BinaryReader::align(size_t alignment)
+	{
+		const size_t padding = (alignment - m_pos % alignment) % alignment;
+		require(padding);
+		m_pos += padding;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	BinaryReader BinaryReader::readSection(std::uint32_t tag)
+	{
+		if (readU32() != tag)
+		{
+			throw std::runtime_error("GameSpace::BinaryReader::readSection if (readU32() != tag)");
+		}
+		const std::uint32_t size = readU32();
+		require(size);
+		// смещения внутри раздела отсчитываются от начала всего буфера,
+		// поэтому выравнивание в разделе совпадает с выравниванием в файле
+		BinaryReader section(m_data, m_pos + size);
+		section.m_pos = m_pos;
+		m_pos += size;
+		return section;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool BinaryReader::isEnd() const
+	{
+		return m_pos == m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t BinaryReader::getRemaining() const
+	{
+		return m_size - m_pos;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace GameSpace
+{
+	/*
+		@brief	запись двоичных данных в буфер
+				числа пишутся в порядке байт платформы (little-endian на x86)
+	*/
+	class BinaryWriter final
+	{
+		std::vector<std::uint8_t> m_data;
+	public:
+		BinaryWriter() = default;
+		~BinaryWriter() = default;
+
+		void writeU32(std::uint32_t value);
+		void writeI32(std::int32_t value);
+		void writeU64(std::uint64_t value);
+		void writeI64(std::int64_t value);
+		void writeFloat(float value);
+		/*
+			@brief пишет длину строки и ее байты
+		*/
+		void writeString(const std::string& value);
+		void writeBytes(const void* data, size_t size);
+		/*
+			@brief дополняет буфер нулями до границы alignment байт
+		*/
+		void align(size_t alignment);
+		/*
+			@brief	начинает раздел: тег и место под его длину
+			@ret	позиция для endSection
+		*/
+		size_t beginSection(std::uint32_t tag);
+		/*
+			@brief записывает длину раздела, начатого beginSection
+		*/
+		void endSection(size_t position);
+
+		const std::vector<std::uint8_t>& getData() const;
+	};
+	/*
+		@brief	чтение двоичных данных из памяти с проверкой границ
+				при выходе за границы бросает исключение
+	*/
+	class BinaryReader final
+	{
+		const std::uint8_t* m_data;
+		size_t m_size;
+		size_t m_pos;
+
+		/*
+			@brief проверяет, что можно прочитать size байт
+		*/
+		void require(size_t size) const;
+	public:
+		BinaryReader(const std::uint8_t* data, size_t size);
+
+		std::uint32_t readU32();
+		std::int32_t readI32();
+		std::uint64_t readU64();
+		std::int64_t readI64();
+		float readFloat();
+		std::string readString();
+		void readBytes(void* data, size_t size);
+		void align(size_t alignment);
+		/*
+			@brief	читает заголовок раздела и проверяет тег
+			@ret	читатель, ограниченный содержимым раздела
+		*/
+		BinaryReader readSection(std::uint32_t tag);
+		/*
+			@brief прочитаны ли все данные
+		*/
+		bool isEnd() const;
+		/*
+			@brief сколько байт осталось прочитать
+		*/
+		size_t getRemaining() const;
+	};
+}
+
+#endif // !BINARYSTREAM_H
\ No newline at end of file
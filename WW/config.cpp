@@ -3,137 +3,242 @@
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
-	std::string Config::readValFromXml(TiXmlElement* element, const std::string& name) const
+	std::string Config::readValFromXml(XmlReader& reader, const char* name)
 	{
-		const char* value = element->Attribute(name.c_str());
-		if (!value)
+		StringView value;
+		if (!reader.findAttribute(reader.intern(name), value))
 		{
 			throw std::runtime_error("GameSpace::Config::readValFromXml if (!value)");
 		}
-		return std::string(value);
+		return value.toString();
 	}
 	//////////////////////////////////////////////////////////////////////////
 	Config::Config(const char* config) : m_configName(config)
 	{
-		TiXmlDocument document(config);
-		if (!document.LoadFile())
+		XmlReader reader(config);
+		if (!reader.nextChild(0) || reader.getName() != reader.intern("game"))
 		{
-			throw std::runtime_error("GameSpace::Config::Config if (!document.LoadFile())");
+			throw std::runtime_error("GameSpace::Config::Config if (!gameRoot)");
 		}
-		TiXmlElement* gameRoot = document.FirstChildElement("game");
-		if (!gameRoot)
+		m_screenConfig = readScreenConfig(reader);
+
+		const XmlReader::Name menu = reader.intern("menu");
+		const XmlReader::Name levels = reader.intern("levels");
+		const XmlReader::Name win = reader.intern("win");
+		const XmlReader::Name fail = reader.intern("fail");
+		const XmlReader::Name memory = reader.intern("memory");
+		const XmlReader::Name startup = reader.intern("startup");
+		const XmlReader::Name simulation = reader.intern("simulation");
+		const XmlReader::Name develop = reader.intern("develop");
+		bool hasMenu = false, hasLevels = false, hasWin = false, hasFail = false;
+
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
 		{
-			throw std::runtime_error("GameSpace::Config::Config if (!gameRoot)");
+			const XmlReader::Name item = reader.getName();
+			if (item == menu)
+			{
+				readMenuConfig(reader);
+				hasMenu = true;
+			}
+			else if (item == levels)
+			{
+				readLevelsConfig(reader);
+				hasLevels = true;
+			}
+			else if (item == win)
+			{
+				readInfoConfig(reader, m_winConfig);
+				hasWin = true;
+			}
+			else if (item == fail)
+			{
+				readInfoConfig(reader, m_failConfig);
+				hasFail = true;
+			}
+			else if (item == memory)
+			{
+				readMemoryConfig(reader);
+			}
+			else if (item == startup)
+			{
+				readStartupConfig(reader);
+			}
+			else if (item == simulation)
+			{
+				m_simulationConfig = readSimulationConfig(reader);
+			}
+			else if (item == develop)
+			{
+				readDevelopConfig(reader);
+			}
+		}
+
+		if (!hasMenu)
+		{
+			throw std::runtime_error("GameSpace::Config::Config if (!menuRoot)");
+		}
+		if (!hasLevels)
+		{
+			throw std::runtime_error("GameSpace::Config::Config if (!levelRoot)");
+		}
+		if (!hasWin || !hasFail)
+		{
+			throw std::runtime_error("GameSpace::Config::Config if (!infoItem)");
+		}
+
+		// атрибут completed в config.xml остается начальным прогрессом
+		m_progress.reset(new ProgressStore(m_levelsConfig.m_progress));
+		for (auto& level : m_levelsConfig.m_levels)
+		{
+			level.m_isCompleted = level.m_isCompleted || m_progress->isCompleted(level.m_levelFile);
 		}
-		readScreenConfig(gameRoot);
-		readMenuConfig(gameRoot);
-		readLevelsConfig(gameRoot);
-		readInfoConfig(gameRoot, "win", m_winConfig);
-		readInfoConfig(gameRoot, "fail", m_failConfig);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void Config::readScreenConfig(TiXmlElement* rootElement)
+	Config::ScreenConfig Config::readScreenConfig(XmlReader& reader)
 	{
-		using namespace std;
-		m_screenConfig = ScreenConfig(
-								stoi(readValFromXml(rootElement, "width")),
-								stoi(readValFromXml(rootElement, "height")),
-								readValFromXml(rootElement, "caption"),
-								(readValFromXml(rootElement, "fullscreen") == "1")
-							);
+		return ScreenConfig(
+					reader.getAttribute(reader.intern("width")).toInt(),
+					reader.getAttribute(reader.intern("height")).toInt(),
+					readValFromXml(reader, "caption"),
+					(readValFromXml(reader, "fullscreen") == "1")
+				);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Config::readSimulation(const char* config, ScreenConfig& screen, SimulationConfig& simulation)
+	{
+		XmlReader reader(config);
+		if (!reader.nextChild(0) || reader.getName() != reader.intern("game"))
+		{
+			throw std::runtime_error("GameSpace::Config::readSimulation if (!gameRoot)");
+		}
+		screen = readScreenConfig(reader);
+		simulation = SimulationConfig();
+
+		const XmlReader::Name item = reader.intern("simulation");
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			if (reader.getName() == item)
+			{
+				simulation = readSimulationConfig(reader);
+			}
+		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void Config::readMenuConfig(TiXmlElement* rootElement)
+	void Config::readMenuConfig(XmlReader& reader)
 	{
-		TiXmlElement* menuRoot = rootElement->FirstChildElement("menu");
-		if (!menuRoot)
+		const std::string background(readValFromXml(reader, "bgimg"));
+		const std::string sound(readValFromXml(reader, "sound"));
+		std::string startImage, exitImage;
+
+		const XmlReader::Name start = reader.intern("start");
+		const XmlReader::Name exit = reader.intern("exit");
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
 		{
-			throw std::runtime_error("GameSpace::Config::getMenuConfig if (!menuRoot)");
+			if (reader.getName() == start)
+			{
+				startImage = readValFromXml(reader, "img");
+			}
+			else if (reader.getName() == exit)
+			{
+				exitImage = readValFromXml(reader, "img");
+			}
 		}
-		TiXmlElement* startButton = menuRoot->FirstChildElement("start");
-		if (!startButton)
+		if (startImage.empty())
 		{
 			throw std::runtime_error("GameSpace::Config::getMenuConfig if (!startButton)");
 		}
-		TiXmlElement* exitButton = menuRoot->FirstChildElement("exit");
-		if (!exitButton)
+		if (exitImage.empty())
 		{
 			throw std::runtime_error("GameSpace::Config::getMenuConfig if (!exitButton)");
 		}
-		m_menuConfig = MenuConfig(	readValFromXml(menuRoot, "bgimg"), 
-									readValFromXml(startButton, "img"), 
-									readValFromXml(exitButton, "img"),
-									readValFromXml(menuRoot, "sound")	);
+		m_menuConfig = MenuConfig(background, startImage, exitImage, sound);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void Config::readLevelsConfig(TiXmlElement* rootElement)
+	void Config::readLevelsConfig(XmlReader& reader)
 	{
-		using namespace std;
-		TiXmlElement* levelRoot = rootElement->FirstChildElement("levels");
-		if (!levelRoot)
-		{
-			throw std::runtime_error("GameSpace::Config::getLevelsConfig if (!levelRoot)");
-		}
-		m_levelsConfig = LevelsConfig(	readValFromXml(levelRoot, "bgimg"),
-										stoi(readValFromXml(levelRoot, "blockPerLine")),
-										stoi(readValFromXml(levelRoot, "linePerScreen")),
-										readValFromXml(levelRoot, "loadimg"),
-										readValFromXml(levelRoot, "sound"));
-		for (TiXmlElement* lvl = levelRoot->FirstChildElement();
-			lvl;
-			lvl = lvl->NextSiblingElement())
+		m_levelsConfig = LevelsConfig(	readValFromXml(reader, "bgimg"),
+										reader.getAttribute(reader.intern("blockPerLine")).toInt(),
+										reader.getAttribute(reader.intern("linePerScreen")).toInt(),
+										readValFromXml(reader, "loadimg"),
+										readValFromXml(reader, "sound"));
+		m_levelsConfig.m_index = reader.getAttribute(reader.intern("index"), StringView()).toString();
+		m_levelsConfig.m_progress = reader.getAttribute(reader.intern("progress"), StringView("progress.wwp", 12)).toString();
+
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
 		{
-			const std::string image(readValFromXml(lvl, "img"));
-			const std::string file(readValFromXml(lvl, "file"));
-			const std::string sound(readValFromXml(lvl, "sound"));
-			const bool compl = (readValFromXml(lvl, "completed") == "1");
+			const std::string image(readValFromXml(reader, "img"));
+			const std::string file(readValFromXml(reader, "file"));
+			const std::string sound(readValFromXml(reader, "sound"));
+			const bool compl = (readValFromXml(reader, "completed") == "1");
 
 			m_levelsConfig.m_levels.emplace_back(image, file, sound, compl);
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
+	void Config::readMemoryConfig(XmlReader& reader)
+	{
+		// бюджеты задаются в мегабайтах
+		const size_t megabyte = 1024 * 1024;
+		m_memoryConfig.m_imageBytes = reader.getAttribute(reader.intern("images"), StringView("0", 1)).toUInt() * megabyte;
+		m_memoryConfig.m_textureBytes = reader.getAttribute(reader.intern("textures"), StringView("0", 1)).toUInt() * megabyte;
+		m_memoryConfig.m_soundBytes = reader.getAttribute(reader.intern("sounds"), StringView("0", 1)).toUInt() * megabyte;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Config::readStartupConfig(XmlReader& reader)
+	{
+		m_startupConfig.m_preload = reader.getAttribute(reader.intern("preload"), StringView("1", 1)) != "0";
+	}
+	//////////////////////////////////////////////////////////////////////////
+	Config::SimulationConfig Config::readSimulationConfig(XmlReader& reader)
+	{
+		SimulationConfig result;
+		result.m_activeMargin = reader.getAttribute(reader.intern("margin"), StringView("256", 3)).toFloat();
+		return result;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Config::readDevelopConfig(XmlReader& reader)
+	{
+		m_developConfig.m_hotReload = reader.getAttribute(reader.intern("hotreload"), StringView("0", 1)) == "1";
+		m_developConfig.m_diagnostics = reader.getAttribute(reader.intern("diagnostics"), StringView("0", 1)) == "1";
+		m_developConfig.m_record = reader.getAttribute(reader.intern("record"), StringView()).toString();
+		m_developConfig.m_replay = reader.getAttribute(reader.intern("replay"), StringView()).toString();
+	}
+	//////////////////////////////////////////////////////////////////////////
 	void Config::markLevelAsCompleted(const std::string& levelFile)
 	{
-		TiXmlDocument document(m_configName.c_str());
-		if (!document.LoadFile())
-		{
-			throw std::runtime_error("GameSpace::Config::markLevelAsCompleted if (!document.LoadFile())");
-		}
-		TiXmlElement* gameRoot = document.FirstChildElement("game");
-		if (!gameRoot)
-		{
-			throw std::runtime_error("GameSpace::Config::markLevelAsCompleted if (!gameRoot)");
-		}
-		TiXmlElement* levelRoot = gameRoot->FirstChildElement("levels");
-		if (!levelRoot)
-		{
-			throw std::runtime_error("GameSpace::Config::markLevelAsCompleted if (!levelRoot)");
-		}
-		for (TiXmlElement* lvl = levelRoot->FirstChildElement();
-			lvl;
-			lvl = lvl->NextSiblingElement())
+		m_progress->markCompleted(levelFile);
+		for (auto& level : m_levelsConfig.m_levels)
 		{
-			if (readValFromXml(lvl, "file") == levelFile)
+			if (level.m_levelFile == levelFile)
 			{
-				lvl->SetAttribute("completed", "1");
-				break;
+				level.m_isCompleted = true;
 			}
 		}
-		document.SaveFile();
-
-		readLevelsConfig(gameRoot);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void Config::readInfoConfig(TiXmlElement* rootElement, const std::string& info, InfoConfig& result)
+	const Config::LevelsConfig::Level* Config::getNextLevel() const
 	{
-		TiXmlElement* infoItem = rootElement->FirstChildElement(info.c_str());
-		if (!infoItem)
+		const auto& levels = m_levelsConfig.m_levels;
+		size_t next = 0;
+		for (size_t i = 0; i < levels.size(); ++i)
 		{
-			throw std::runtime_error("GameSpace::Config::getWinConfig if (!infoItem)");
+			if (levels[i].m_isCompleted)
+			{
+				next = i + 1;
+			}
 		}
-		result = InfoConfig(readValFromXml(infoItem, "bgimg"),
-							readValFromXml(infoItem, "img"),
-							readValFromXml(infoItem, "sound"));
+		return next < levels.size() ? &levels[next] : nullptr;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Config::readInfoConfig(XmlReader& reader, InfoConfig& result)
+	{
+		result = InfoConfig(readValFromXml(reader, "bgimg"),
+							readValFromXml(reader, "img"),
+							readValFromXml(reader, "sound"));
 	}
 	//////////////////////////////////////////////////////////////////////////
 }
\ No newline at end of file
@@ -4,21 +4,24 @@
 #include <string>
 #include <stdexcept>
 #include <vector>
+#include <memory>
 
-#include <tinyxml.h>
+#include "xmlreader.h"
+#include "progressstore.h"
 
 namespace GameSpace
 {
 	/*
-		@brief	  
-				     
-				     
-				  
+		@brief	описывает конфигурацию игры
+				читает конфигурацию из конфигурационного файла игры
+				прогресс прохождения хранится отдельно в журнале (ProgressStore),
+				config.xml только читается
+				все настройки кэшируются
 	*/
 	class Config final
 	{
 	public:
-		// @brief   
+		// @brief описывает настройки экрана
 		struct ScreenConfig
 		{
 			unsigned int m_width, m_height;
@@ -29,7 +32,7 @@ namespace GameSpace
 			{}
 			ScreenConfig() = default;
 		};
-		// @brief   
+		// @brief описывает настройки меню
 		struct MenuConfig
 		{
 			std::string m_backgroundImage;
@@ -47,7 +50,7 @@ namespace GameSpace
 			{}
 			MenuConfig() = default;
 		};
-		//   
+		// описывает настройки уровней
 		struct LevelsConfig
 		{
 			std::string m_backgroundImage;
@@ -72,6 +75,8 @@ namespace GameSpace
 				{}
 			};
 			std::vector<Level> m_levels;
+			std::string m_index;	// оглавление уровней (LevelIndex), пустое - без него
+			std::string m_progress;	// журнал прогресса (ProgressStore)
 			LevelsConfig(	const std::string backgroundImage, int blockPerLine, int linePerScreen, 
 							const std::string& loadImage, const std::string& sound)
 				:	m_backgroundImage(backgroundImage), 
@@ -82,7 +87,7 @@ namespace GameSpace
 			{}
 			LevelsConfig() = default;
 		};
-		//    
+		// описывает настройки информационных экранов
 		struct InfoConfig
 		{
 			std::string m_backgroundImage;
@@ -97,63 +102,143 @@ namespace GameSpace
 			{}
 			InfoConfig() = default;
 		};
+		// @brief бюджеты памяти ресурсов в байтах, 0 - без ограничения
+		struct MemoryConfig
+		{
+			size_t m_imageBytes;	// изображения в памяти процесса
+			size_t m_textureBytes;	// текстуры в видеопамяти
+			size_t m_soundBytes;	// звуковые буферы
+			MemoryConfig() : m_imageBytes(0), m_textureBytes(0), m_soundBytes(0)
+			{}
+		};
+		// @brief настройки запуска
+		struct StartupConfig
+		{
+			bool m_preload;	// декодировать изображения остальных экранов в фоне после показа меню
+			StartupConfig() : m_preload(true)
+			{}
+		};
+		// @brief настройки симуляции мира
+		struct SimulationConfig
+		{
+			float m_activeMargin;	// поле активной области вокруг вида в пикселях, отрицательное - активны все объекты
+			SimulationConfig() : m_activeMargin(256.0f)
+			{}
+		};
+		// @brief настройки разработки
+		struct DevelopConfig
+		{
+			bool m_hotReload;		// перезагружать уровень при изменении его файлов
+			bool m_diagnostics;		// писать в stdout времена загрузки и отчеты кэшей
+			std::string m_record;	// файл, в который записывается управление каждого уровня
+			std::string m_replay;	// файл повтора, управление берется из него
+			DevelopConfig() : m_hotReload(false), m_diagnostics(false)
+			{}
+		};
 		/*
-			@brief   
-			@param config    
+			@brief открывает файл конфигурации
+			@param config путь к файлу конфигурации
 		*/
 		Config(const char* config);
 		/*
-			@brief   
-			@ret    
+			@brief читает настройки экрана
+			@ret   настройки экрана
 		*/
 		const ScreenConfig& getScreenConfig() const
 		{ return m_screenConfig; }
 		/*
-			@brief   
-			@ret    
+			@brief читает настройки меню
+			@ret   настройки меню
 		*/
 		const MenuConfig& getMenuConfig() const
 		{ return m_menuConfig; }
 		/*
-			@brief   
-			@ret    
+			@brief считывает настройки уровней
+			@ret   настройки уровней
 		*/
 		const LevelsConfig& getLevelsConfig() const
 		{ return m_levelsConfig; }
 		/*
-			@brief   
+			@brief настройки окна выйгрыша
 		*/
 		const InfoConfig& getWinConfig() const
 		{ return m_winConfig; }
 		/*
-			@brief   
+			@brief настройки окна проигрыша
 		*/
 		const InfoConfig& getFailConfig() const
 		{ return m_failConfig; }
 		/*
-		@brief    
+			@brief бюджеты памяти ресурсов, элемент memory необязателен
+		*/
+		const MemoryConfig& getMemoryConfig() const
+		{ return m_memoryConfig; }
+		/*
+			@brief настройки запуска, элемент startup необязателен
+		*/
+		const StartupConfig& getStartupConfig() const
+		{ return m_startupConfig; }
+		/*
+			@brief настройки симуляции мира, элемент simulation необязателен
+		*/
+		const SimulationConfig& getSimulationConfig() const
+		{ return m_simulationConfig; }
+		/*
+			@brief настройки разработки, элемент develop необязателен
+		*/
+		const DevelopConfig& getDevelopConfig() const
+		{ return m_developConfig; }
+		/*
+			@brief	отметить уровень как пройденный
+					не ждет диска: журнал дописывается в фоне
+			@param levelFile файл уровня
 		*/
 		void markLevelAsCompleted(const std::string& levelFile);
+		/*
+			@brief	следующий уровень для прохождения: первый после последнего пройденного
+			@ret   уровень или nullptr, если пройден последний
+		*/
+		const LevelsConfig::Level* getNextLevel() const;
+		/*
+			@brief	читает только настройки окна и симуляции, без остальных разделов и журнала прогресса
+			@param config путь к config.xml
+			@param screen настройки окна
+			@param simulation настройки симуляции, без элемента simulation - по умолчанию
+		*/
+		static void readSimulation(const char* config, ScreenConfig& screen, SimulationConfig& simulation);
 	private:
 		std::string m_configName;
 
-		ScreenConfig m_screenConfig; //  
-		MenuConfig m_menuConfig; //   
-		LevelsConfig m_levelsConfig; //    
-		InfoConfig m_winConfig; //   
-		InfoConfig m_failConfig; //   
+		Config(const Config&) = delete;
+		Config& operator=(const Config&) = delete;
+
+		ScreenConfig m_screenConfig; // настройки окна
+		MenuConfig m_menuConfig; // настройки экрана меню
+		LevelsConfig m_levelsConfig; // настройки экрана выбора уровня
+		InfoConfig m_winConfig; // настройки экрана выйгрыша
+		InfoConfig m_failConfig; // настройка экрана проигрыша
+		MemoryConfig m_memoryConfig; // бюджеты памяти ресурсов
+		StartupConfig m_startupConfig; // настройки запуска
+		SimulationConfig m_simulationConfig; // настройки симуляции мира
+		DevelopConfig m_developConfig; // настройки разработки
+		std::unique_ptr<ProgressStore> m_progress; // пройденные уровни
 		
-		void readScreenConfig(TiXmlElement* rootElement);
-		void readMenuConfig(TiXmlElement* rootElement);
-		void readLevelsConfig(TiXmlElement* rootElement);
-		void readInfoConfig(TiXmlElement* rootElement, const std::string& info, InfoConfig& result);
+		// методы чтения вызываются, когда читатель стоит в начале своего элемента
+		static ScreenConfig readScreenConfig(XmlReader& reader);
+		void readMenuConfig(XmlReader& reader);
+		void readLevelsConfig(XmlReader& reader);
+		void readInfoConfig(XmlReader& reader, InfoConfig& result);
+		void readMemoryConfig(XmlReader& reader);
+		void readStartupConfig(XmlReader& reader);
+		static SimulationConfig readSimulationConfig(XmlReader& reader);
+		void readDevelopConfig(XmlReader& reader);
 		/*
-			@brief    XML
-			@param element     
-			@param name    
-			@ret    
+			@brief читает параметр из XML
+			@param reader читатель в начале элемента
+			@param name имя параметра для чтения
+			@ret   считанное значение
 		*/
-		std::string readValFromXml(TiXmlElement* element, const std::string& name) const;
+		static std::string readValFromXml(XmlReader& reader, const char* name);
 	};
 }
 
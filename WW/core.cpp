@@ -13,34 +13,175 @@ namespace GameSpace
 									static_cast<float>(mainConfig->getScreenConfig().m_width), 
 									static_cast<float>(mainConfig->getScreenConfig().m_height))),
 			m_currentState(GameState::GS_MENU),
-			m_mainConfig(mainConfig)
+			m_mainConfig(mainConfig),
+			m_cancelPreload(false)
 	{
 		m_mainRender.setView(m_mainView);
 		m_mainRender.setFramerateLimit(m_optimalFPS);
 
-		m_states[GameState::GS_MENU] = std::make_shared<StateMenu>(&m_mainRender, &m_musicPlayer, m_mainConfig);
-		m_states[GameState::GS_LEVEL] = std::make_shared<StateLevel>(&m_mainRender, &m_musicPlayer, m_mainConfig, &m_gameWorld);
-		m_states[GameState::GS_GAME] = std::make_shared<StateGame>(&m_mainRender, &m_musicPlayer, m_mainConfig, &m_gameWorld);
-		m_states[GameState::GS_GAMEFAIL] = std::make_shared<StateFail>(&m_mainRender, &m_musicPlayer, m_mainConfig);
-		m_states[GameState::GS_GAMEWIN] = std::make_shared<StateWin>(&m_mainRender, &m_musicPlayer, m_mainConfig);
+		const Config::MemoryConfig& memory = mainConfig->getMemoryConfig();
+		m_gameWorld.getAssetCache().setBudget(AssetCache::RK_IMAGE, memory.m_imageBytes);
+		m_gameWorld.getAssetCache().setBudget(AssetCache::RK_TEXTURE, memory.m_textureBytes);
+		m_gameWorld.getAssetCache().setBudget(AssetCache::RK_SOUND, memory.m_soundBytes);
+		m_gameWorld.setActiveMargin(mainConfig->getSimulationConfig().m_activeMargin);
+		m_gameWorld.setViewSize(m_mainView.getSize());
+		const Config::DevelopConfig& develop = mainConfig->getDevelopConfig();
+		Diagnostics::setEnabled(develop.m_diagnostics);
+		m_gameWorld.setHotReload(develop.m_hotReload);
+		if (!develop.m_replay.empty())
+		{
+			m_gameWorld.setInput(std::make_shared<ReplayInput>(develop.m_replay));
+		}
+		else if (!develop.m_record.empty())
+		{
+			m_gameWorld.setInput(std::make_shared<InputRecorder>(std::make_shared<KeyboardInput>(), develop.m_record));
+		}
+
+		// состояния создаются при первом входе, а не все до первого кадра
+		AssetCache* assets = &m_gameWorld.getAssetCache();
+		StateEntry menu = { "menu", [this, assets]()
+		{
+			return std::make_shared<StateMenu>(&m_mainRender, &m_musicPlayer, assets, m_mainConfig);
+		}, StateMenu::getImages(*m_mainConfig) };
+		StateEntry level = { "level", [this, assets]()
+		{
+			return std::make_shared<StateLevel>(&m_mainRender, &m_musicPlayer, assets, m_mainConfig, &m_gameWorld);
+		}, StateLevel::getImages(*m_mainConfig) };
+		StateEntry game = { "game", [this, assets]()
+		{
+			return std::make_shared<StateGame>(&m_mainRender, &m_musicPlayer, assets, m_mainConfig, &m_gameWorld);
+		}, std::vector<std::string>() };
+		StateEntry fail = { "fail", [this, assets]()
+		{
+			return std::make_shared<StateFail>(&m_mainRender, &m_musicPlayer, assets, m_mainConfig);
+		}, StateFail::getImages(*m_mainConfig) };
+		StateEntry win = { "win", [this, assets]()
+		{
+			return std::make_shared<StateWin>(&m_mainRender, &m_musicPlayer, assets, m_mainConfig, &m_gameWorld);
+		}, StateWin::getImages(*m_mainConfig) };
+		m_entries[GameState::GS_MENU] = menu;
+		m_entries[GameState::GS_LEVEL] = level;
+		m_entries[GameState::GS_GAME] = game;
+		m_entries[GameState::GS_GAMEFAIL] = fail;
+		m_entries[GameState::GS_GAMEWIN] = win;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	GameCore::~GameCore()
+	{
+		m_cancelPreload = true;
+		if (m_preload.joinable())
+		{
+			m_preload.join();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	State& GameCore::getState(GameState state)
+	{
+		const auto itState = m_states.find(state);
+		if (itState != m_states.end())
+		{
+			return *itState->second;
+		}
+		const auto itEntry = m_entries.find(state);
+		if (itEntry == m_entries.end())
+		{
+			throw std::runtime_error("GameSpace::GameCore::getState if (itEntry == m_entries.end())");
+		}
+
+		sf::Clock clock;
+		// изображения, уже декодированные фоновой загрузкой, берутся из кэша
+		const StateEntry& entry = itEntry->second;
+		AssetCache& assets = m_gameWorld.getAssetCache();
+		WorkerPool::forEach(entry.m_images.size(), [&entry, &assets](size_t i)
+		{
+			assets.getImage(entry.m_images[i]);
+		});
+		const sf::Time decodeTime = clock.getElapsedTime();
+
+		const std::shared_ptr<State> result(entry.m_create());
+		m_states[state] = result;
+		if (Diagnostics::isEnabled())
+		{
+			std::cout	<< "State: " << entry.m_name << " built in " << clock.getElapsedTime().asMilliseconds()
+						<< " ms (decode " << decodeTime.asMilliseconds() << " ms, " << entry.m_images.size() << " images)" << std::endl;
+		}
+		return *result;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void GameCore::startPreload()
+	{
+		std::set<std::string> unique;
+		std::vector<std::string> images;
+		for (const auto& entry : m_entries)
+		{
+			if (m_states.find(entry.first) != m_states.end())
+			{
+				continue;
+			}
+			for (const auto& image : entry.second.m_images)
+			{
+				if (unique.insert(image).second)
+				{
+					images.push_back(image);
+				}
+			}
+		}
+		if (images.empty())
+		{
+			return;
+		}
+
+		AssetCache* assets = &m_gameWorld.getAssetCache();
+		const std::atomic<bool>* cancel = &m_cancelPreload;
+		m_preload = std::thread([images, assets, cancel]()
+		{
+			sf::Clock clock;
+			try
+			{
+				WorkerPool::forEach(images.size(), [&images, assets](size_t i)
+				{
+					assets->getImage(images[i]);
+				}, cancel);
+				if (Diagnostics::isEnabled())
+				{
+					std::cout << "Preload: " << images.size() << " images in " << clock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+				}
+			}
+			catch (const std::exception& e)
+			{	// ошибка повторится при создании состояния, где ее и покажут
+				std::cerr << "Preload: " << e.what() << std::endl;
+			}
+		});
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void GameCore::runGameLoop()
 	{
-		assert(m_states.find(m_currentState) != m_states.end());
 		auto prevState = m_currentState;
-		m_states[m_currentState]->statePrepare();
+		getState(m_currentState).statePrepare();
+		bool firstFrame = true;
 
 		while (	m_mainRender.isOpen() && 
 				m_currentState != GameState::GS_EXIT)
 		{
-			assert(m_states.find(m_currentState) != m_states.end());
 			if (m_currentState != prevState)
 			{
-				m_states[m_currentState]->statePrepare();
+				getState(m_currentState).statePrepare();
 				prevState = m_currentState;
 			}
-			m_currentState = m_states[m_currentState]->update();
+			m_currentState = getState(prevState).update();
+
+			if (firstFrame)
+			{
+				firstFrame = false;
+				if (Diagnostics::isEnabled())
+				{
+					std::cout << "Startup: first frame in " << m_startClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+				}
+				if (m_mainConfig->getStartupConfig().m_preload)
+				{
+					startPreload();
+				}
+			}
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
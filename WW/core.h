@@ -5,6 +5,12 @@
 #include <iostream>
 #include <memory>
 #include <map>
+#include <vector>
+#include <set>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <exception>
 #include <cassert>
 
 #include <SFML/Graphics.hpp>
@@ -13,45 +19,73 @@
 #include "state.h"
 #include "world.h"
 #include "music.h"
+#include "workerpool.h"
 
 namespace GameSpace
 {
 	class GameCore final
 	{
-		// @brief  FPS  
+		// @brief оптимальный FPS для игры
 		static const int m_optimalFPS;
 
-		// @brief   
+		// @brief время с начала создания ядра, до открытия окна
+		sf::Clock m_startClock;
+
+		// @brief главный оконный рендер
 		sf::RenderWindow m_mainRender;
 
-		// @brief  
+		// @brief главный вид
 		sf::View m_mainView;
 
-		// @brief   ,    
+		// @brief описывает текущее состояние, в котором пребывает ядро
 		GameState m_currentState;
-		// @brief  
+		// @brief способ создания состояния и изображения, которые оно загрузит
+		struct StateEntry
+		{
+			const char* m_name;
+			std::function<std::shared_ptr<State>()> m_create;
+			std::vector<std::string> m_images;
+		};
+		std::map<GameState, StateEntry> m_entries;
+		// @brief реестр созданных состояний, состояние создается при первом входе
 		std::map<GameState, std::shared_ptr<State>> m_states;
 
-		// @brief   
+		// @brief описывает конфигурационный файл
 		Config* m_mainConfig;
 
-		// @brief  
+		// @brief игровой мир
 		World m_gameWorld;
 
-		// @brief  
+		// @brief игровой проигрыватель
 		GameSound m_musicPlayer;
 
+		// @brief фоновое декодирование изображений еще не созданных состояний
+		std::thread m_preload;
+		std::atomic<bool> m_cancelPreload;
+
 		GameCore(const GameCore&) = delete;
 		GameCore& operator=(const GameCore&) = delete;
+		/*
+			@brief	возвращает состояние, создавая его при первом обращении
+					изображения состояния декодируются параллельно до создания,
+					в самом конструкторе остается передача текстур в видеопамять
+			@param state состояние
+		*/
+		State& getState(GameState state);
+		/*
+			@brief	начинает фоновое декодирование изображений еще не созданных состояний,
+					вызывается после первого кадра меню
+		*/
+		void startPreload();
 	public:
 		/*
-			@brief   
-			@param mainConfig   
+			@brief создание ядра игры
+			@param mainConfig конфигурация для экранов
 		*/
 		GameCore(Config* mainConfig);
-		// @brief    
+		// @brief выполняет запуск игрового цикла
 		void runGameLoop();
-		~GameCore() = default;
+		~GameCore();
 	};
 }
 
@@ -0,0 +1,38 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <atomic>
+
+namespace GameSpace
+{
+	/*
+		@brief	переключатель диагностических сообщений: времена загрузки, отчеты кэшей, перезагрузка уровня
+				по умолчанию выключен, включается атрибутом diagnostics элемента develop в config.xml
+				сообщения пишутся в std::cout только при включенном переключателе,
+				его можно читать из фоновых потоков
+	*/
+	class Diagnostics final
+	{
+		Diagnostics() = delete;
+
+		static std::atomic<bool>& flag()
+		{
+			static std::atomic<bool> enabled(false);
+			return enabled;
+		}
+	public:
+		/*
+			@brief включить или выключить диагностические сообщения
+			@param enabled true - сообщения пишутся в std::cout
+		*/
+		static void setEnabled(bool enabled)
+		{ flag().store(enabled, std::memory_order_relaxed); }
+		/*
+			@brief включены ли диагностические сообщения
+		*/
+		static bool isEnabled()
+		{ return flag().load(std::memory_order_relaxed); }
+	};
+}
+
+#endif // !DIAGNOSTICS_H
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "entitystore.h"
+#include "object.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const float EntityStore::m_radToDeg = 57.2957795f;
+	//////////////////////////////////////////////////////////////////////////
+	EntityStore::EntityStore()
+		: m_size(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	EntityStore::Entity EntityStore::create(const sf::Texture& texture, const sf::IntRect& rect, const sf::Vector2f& position)
+	{
+		Entity entity;
+		if (m_free.empty())
+		{	// все массивы растут вместе, номер - индекс в каждом из них
+			entity = static_cast<Entity>(m_alive.size());
+			m_positions.push_back(position);
+			m_rotations.push_back(0.0f);
+			m_sprites.push_back(SpriteRef());
+			m_bodies.push_back(nullptr);
+			m_previous.push_back(PreviousState());
+			m_behaviours.push_back(nullptr);
+			m_alive.push_back(0);
+		}
+		else
+		{
+			entity = m_free.back();
+			m_free.pop_back();
+		}
+		m_positions[entity] = position;
+		m_rotations[entity] = 0.0f;
+		SpriteRef& sprite = m_sprites[entity];
+		sprite.m_texture = &texture;
+		sprite.m_rect = rect;
+		sprite.m_origin = sf::Vector2f(rect.width / 2.0f, rect.height / 2.0f);
+		m_bodies[entity] = nullptr;
+		m_previous[entity].m_position.SetZero();
+		m_previous[entity].m_angle = 0.0f;
+		m_previous[entity].m_valid = false;
+		m_behaviours[entity] = nullptr;
+		m_alive[entity] = 1;
+		++m_size;
+		return entity;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::destroy(Entity entity)
+	{
+		assert(isAlive(entity));
+		m_bodies[entity] = nullptr;
+		m_behaviours[entity] = nullptr;
+		m_alive[entity] = 0;
+		m_free.push_back(entity);
+		--m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::clear()
+	{
+		// объекты освобождают свои номера сами, к этому моменту их уже нет
+		assert(m_size == 0);
+		m_positions.clear();
+		m_rotations.clear();
+		m_sprites.clear();
+		m_bodies.clear();
+		m_previous.clear();
+		m_behaviours.clear();
+		m_alive.clear();
+		m_free.clear();
+		m_size = 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t EntityStore::getSize() const
+	{
+		return m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t EntityStore::getCapacity() const
+	{
+		return m_alive.size();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool EntityStore::isAlive(Entity entity) const
+	{
+		return entity < m_alive.size() && m_alive[entity] != 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const sf::Vector2f& EntityStore::getPosition(Entity entity) const
+	{
+		return m_positions[entity];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::setPosition(Entity entity, const sf::Vector2f& position)
+	{
+		m_positions[entity] = position;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::setRotation(Entity entity, float degrees)
+	{
+		m_rotations[entity] = degrees;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const sf::IntRect& EntityStore::getTextureRect(Entity entity) const
+	{
+		return m_sprites[entity].m_rect;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::setTextureRect(Entity entity, const sf::IntRect& rect)
+	{
+		// точка привязки остается прежней, как у sf::Sprite
+		m_sprites[entity].m_rect = rect;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	b2Body*& EntityStore::getBody(Entity entity)
+	{
+		return m_bodies[entity];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	b2Body* EntityStore::getBody(Entity entity) const
+	{
+		return m_bodies[entity];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::removeBody(Entity entity)
+	{
+		b2Body*& body = m_bodies[entity];
+		if (body)
+		{
+			body->GetWorld()->DestroyBody(body);
+			body = nullptr;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::setPrevious(Entity entity, const b2Vec2& position, float32 angle)
+	{
+		m_previous[entity].m_position = position;
+		m_previous[entity].m_angle = angle;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::setBehaviour(Entity entity, Object* behaviour)
+	{
+		m_behaviours[entity] = behaviour;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	Object* EntityStore::getBehaviour(Entity entity) const
+	{
+		return m_behaviours[entity];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	sf::FloatRect EntityStore::getBounds(Entity entity) const
+	{
+		const SpriteRef& sprite = m_sprites[entity];
+		const float width = static_cast<float>(std::abs(sprite.m_rect.width));
+		const float height = static_cast<float>(std::abs(sprite.m_rect.height));
+		sf::FloatRect bounds(-sprite.m_origin.x, -sprite.m_origin.y, width, height);
+		const float rotation = m_rotations[entity];
+		if (rotation != 0.0f)
+		{	// прямоугольник, описанный вокруг повернутого кадра
+			const float radians = rotation / m_radToDeg;
+			const float c = std::abs(std::cos(radians));
+			const float s = std::abs(std::sin(radians));
+			const sf::Vector2f center(bounds.left + width / 2.0f, bounds.top + height / 2.0f);
+			const sf::Vector2f rotated(	std::cos(radians) * center.x - std::sin(radians) * center.y,
+										std::sin(radians) * center.x + std::cos(radians) * center.y);
+			bounds.width = width * c + height * s;
+			bounds.height = width * s + height * c;
+			bounds.left = rotated.x - bounds.width / 2.0f;
+			bounds.top = rotated.y - bounds.height / 2.0f;
+		}
+		const b2Body* body = m_bodies[entity];
+		if (body)
+		{	// положение ставится на место тела только перед отрисовкой
+			bounds.left = PhysicObject::mapPhysicToPixel(body->GetPosition().x) - bounds.width / 2.0f;
+			bounds.top = PhysicObject::mapPhysicToPixel(body->GetPosition().y) - bounds.height / 2.0f;
+		}
+		else
+		{
+			bounds.left += m_positions[entity].x;
+			bounds.top += m_positions[entity].y;
+		}
+		return bounds;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool EntityStore::isMovable(Entity entity) const
+	{
+		const b2Body* body = m_bodies[entity];
+		return body && body->GetType() != b2_staticBody;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::sleep(Entity entity)
+	{
+		if (isMovable(entity))
+		{	// выключенное тело не участвует в шаге и не имеет контактов
+			m_bodies[entity]->SetActive(false);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::wake(Entity entity, float sleptTime)
+	{
+		if (isMovable(entity))
+		{
+			m_bodies[entity]->SetActive(true);
+		}
+		m_previous[entity].m_valid = false;
+		if (m_behaviours[entity])
+		{
+			m_behaviours[entity]->wake(sleptTime);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::runBehaviours(const std::vector<Entity>& entities, float delta)
+	{
+		for (const Entity entity : entities)
+		{
+			Object* const behaviour = m_behaviours[entity];
+			if (behaviour)
+			{
+				behaviour->logic(delta);
+				behaviour->animate(delta);
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::saveBodies(const std::vector<Entity>& entities)
+	{
+		for (const Entity entity : entities)
+		{
+			const b2Body* body = m_bodies[entity];
+			if (body)
+			{
+				PreviousState& previous = m_previous[entity];
+				previous.m_position = body->GetPosition();
+				previous.m_angle = body->GetAngle();
+				previous.m_valid = true;
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::interpolate(const std::vector<Entity>& entities, float alpha)
+	{
+		for (const Entity entity : entities)
+		{
+			const b2Body* body = m_bodies[entity];
+			if (!body)
+			{	// положение без тела задано при создании
+				continue;
+			}
+			b2Vec2 bodyPosition = body->GetPosition();
+			float32 bodyAngle = body->GetAngle();
+			const PreviousState& previous = m_previous[entity];
+			if (previous.m_valid)
+			{
+				bodyPosition = alpha * bodyPosition + (1.0f - alpha) * previous.m_position;
+				bodyAngle = alpha * bodyAngle + (1.0f - alpha) * previous.m_angle;
+			}
+			m_positions[entity] = sf::Vector2f(	std::floor(PhysicObject::mapPhysicToPixel(bodyPosition.x)),
+												std::floor(PhysicObject::mapPhysicToPixel(bodyPosition.y)));
+			m_rotations[entity] = bodyAngle * m_radToDeg;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void EntityStore::draw(const std::vector<Entity>& entities, sf::RenderTarget& render)
+	{
+		m_vertices.clear();
+		const sf::Texture* texture = nullptr;
+		const auto flush = [this, &render, &texture]()
+		{
+			if (!m_vertices.empty())
+			{
+				render.draw(m_vertices.data(), m_vertices.size(), sf::Quads, sf::RenderStates(texture));
+				m_vertices.clear();
+			}
+		};
+
+		for (const Entity entity : entities)
+		{
+			const SpriteRef& sprite = m_sprites[entity];
+			if (sprite.m_texture != texture)
+			{
+				flush();
+				texture = sprite.m_texture;
+			}
+
+			// вершины и координаты текстуры считаются так же, как в sf::Sprite
+			const sf::IntRect& rect = sprite.m_rect;
+			const float width = static_cast<float>(std::abs(rect.width));
+			const float height = static_cast<float>(std::abs(rect.height));
+			const float left = static_cast<float>(rect.left);
+			const float top = static_cast<float>(rect.top);
+			const float right = left + rect.width;
+			const float bottom = top + rect.height;
+			sf::Vector2f corners[4] = {	sf::Vector2f(0.0f, 0.0f) - sprite.m_origin,
+										sf::Vector2f(width, 0.0f) - sprite.m_origin,
+										sf::Vector2f(width, height) - sprite.m_origin,
+										sf::Vector2f(0.0f, height) - sprite.m_origin };
+			const float rotation = m_rotations[entity];
+			if (rotation != 0.0f)
+			{
+				const float radians = rotation / m_radToDeg;
+				const float c = std::cos(radians);
+				const float s = std::sin(radians);
+				for (auto& corner : corners)
+				{
+					corner = sf::Vector2f(c * corner.x - s * corner.y, s * corner.x + c * corner.y);
+				}
+			}
+			const sf::Vector2f& position = m_positions[entity];
+			m_vertices.push_back(sf::Vertex(position + corners[0], sf::Color::White, sf::Vector2f(left, top)));
+			m_vertices.push_back(sf::Vertex(position + corners[1], sf::Color::White, sf::Vector2f(right, top)));
+			m_vertices.push_back(sf::Vertex(position + corners[2], sf::Color::White, sf::Vector2f(right, bottom)));
+			m_vertices.push_back(sf::Vertex(position + corners[3], sf::Color::White, sf::Vector2f(left, bottom)));
+		}
+		flush();
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef ENTITYSTORE_H
+#define ENTITYSTORE_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+#include <Box2D/Box2D.h>
+
+namespace GameSpace
+{
+	class Object;
+	/*
+		@brief	хранилище сущностей мира по компонентам
+				каждая часть состояния объекта лежит в своем непрерывном массиве
+				по номеру сущности: положения, участки текстур, тела, положения
+				до шага физики, поведение. Шаг, интерполяция и отрисовка проходят
+				по массивам подряд, без обхода узлов списка и виртуальных вызовов,
+				а объекты с логикой (игрок, платформы, эффекты) вызываются только
+				через компонент поведения
+	*/
+	class EntityStore final
+	{
+	public:
+		typedef std::uint32_t Entity;
+	private:
+		// @brief участок текстуры, которым рисуется сущность
+		struct SpriteRef
+		{
+			const sf::Texture* m_texture;
+			sf::IntRect m_rect;		// отрицательный размер отражает кадр, как у sf::Sprite
+			sf::Vector2f m_origin;	// точка привязки относительно левого верхнего угла кадра
+		};
+		// @brief положение тела до последнего шага физики
+		struct PreviousState
+		{
+			b2Vec2 m_position;
+			float32 m_angle;
+			bool m_valid;		// шаг с запоминанием уже был
+		};
+
+		std::vector<sf::Vector2f> m_positions;	// положение в пикселях, у тел - на последней отрисовке
+		std::vector<float> m_rotations;			// поворот в градусах
+		std::vector<SpriteRef> m_sprites;
+		std::vector<b2Body*> m_bodies;
+		std::vector<PreviousState> m_previous;
+		std::vector<Object*> m_behaviours;		// объект с логикой или nullptr
+		std::vector<std::uint8_t> m_alive;
+		std::vector<Entity> m_free;				// освобожденные номера, занимаются первыми
+		size_t m_size;
+		std::vector<sf::Vertex> m_vertices;		// вершины отрисовки, память переиспользуется
+
+		EntityStore(const EntityStore&) = delete;
+		EntityStore& operator=(const EntityStore&) = delete;
+		static const float m_radToDeg;
+	public:
+		EntityStore();
+		~EntityStore() = default;
+		/*
+			@brief	создает сущность без тела и поведения
+			@param texture текстура, должна жить дольше сущности
+			@param rect участок текстуры
+			@param position положение центра в пикселях
+			@ret   номер сущности
+		*/
+		Entity create(const sf::Texture& texture, const sf::IntRect& rect, const sf::Vector2f& position);
+		/*
+			@brief	освобождает номер сущности, тело при этом не удаляется
+			@param entity сущность
+		*/
+		void destroy(Entity entity);
+		/*
+			@brief сбрасывает номера, вызывается после удаления всех объектов
+		*/
+		void clear();
+		/*
+			@brief количество живых сущностей
+		*/
+		size_t getSize() const;
+		/*
+			@brief число номеров, все номера меньше него
+		*/
+		size_t getCapacity() const;
+		/*
+			@brief жива ли сущность с этим номером
+		*/
+		bool isAlive(Entity entity) const;
+
+		const sf::Vector2f& getPosition(Entity entity) const;
+		void setPosition(Entity entity, const sf::Vector2f& position);
+		void setRotation(Entity entity, float degrees);
+		const sf::IntRect& getTextureRect(Entity entity) const;
+		void setTextureRect(Entity entity, const sf::IntRect& rect);
+		/*
+			@brief тело сущности, ссылка позволяет задать его при создании
+		*/
+		b2Body*& getBody(Entity entity);
+		b2Body* getBody(Entity entity) const;
+		/*
+			@brief удаляет тело из мира физики
+		*/
+		void removeBody(Entity entity);
+		/*
+			@brief	задает положение до шага, чтобы перенос тела не интерполировался
+			@param position положение тела
+			@param angle угол тела
+		*/
+		void setPrevious(Entity entity, const b2Vec2& position, float32 angle);
+		/*
+			@brief	задает объект, логика которого выполняется на каждом шаге
+			@param behaviour объект или nullptr
+		*/
+		void setBehaviour(Entity entity, Object* behaviour);
+		Object* getBehaviour(Entity entity) const;
+		/*
+			@brief границы в пикселях, у тел - вокруг текущего положения тела
+		*/
+		sf::FloatRect getBounds(Entity entity) const;
+		/*
+			@brief есть ли у сущности подвижное тело
+		*/
+		bool isMovable(Entity entity) const;
+		/*
+			@brief сущность вышла из активной области: подвижное тело выключается
+		*/
+		void sleep(Entity entity);
+		/*
+			@brief	сущность вернулась в активную область: тело включается,
+					положение после сна не интерполируется, поведение наверстывает время
+			@param sleptTime игровое время сна в секундах
+		*/
+		void wake(Entity entity, float sleptTime);
+		/*
+			@brief	выполняет логику и анимацию сущностей с поведением
+			@param entities сущности
+			@param delta время шага в секундах
+		*/
+		void runBehaviours(const std::vector<Entity>& entities, float delta);
+		/*
+			@brief запоминает положения тел перед шагом физики
+		*/
+		void saveBodies(const std::vector<Entity>& entities);
+		/*
+			@brief	ставит сущности с телами между двумя последними шагами физики
+			@param alpha доля шага после последнего шага, от 0 до 1
+		*/
+		void interpolate(const std::vector<Entity>& entities, float alpha);
+		/*
+			@brief	рисует сущности в порядке списка
+					подряд идущие сущности с одной текстурой рисуются одним вызовом,
+					объекты атласа обычно лежат на одной странице
+			@param entities сущности
+			@param render объект, в котором будет отрисовка
+		*/
+		void draw(const std::vector<Entity>& entities, sf::RenderTarget& render);
+	};
+}
+
+#endif // !ENTITYSTORE_H
\ No newline at end of file
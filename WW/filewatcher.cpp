@@ -0,0 +1,171 @@
+#include "filewatcher.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const sf::Int32 FileWatcher::m_settleMs = 200;
+	const sf::Int32 FileWatcher::m_intervalMs = 500;
+	//////////////////////////////////////////////////////////////////////////
+	FileWatcher::FileWatcher()
+	{
+#ifdef __linux__
+		m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_inotify < 0)
+		{	// без inotify файлы опрашиваются
+			std::cerr << "Watch: inotify is not available, polling files" << std::endl;
+		}
+#endif
+	}
+	//////////////////////////////////////////////////////////////////////////
+	FileWatcher::~FileWatcher()
+	{
+		clear();
+#ifdef __linux__
+		if (m_inotify >= 0)
+		{
+			::close(m_inotify);
+		}
+#endif
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void FileWatcher::watch(const std::vector<std::string>& paths)
+	{
+		clear();
+		m_files.insert(paths.begin(), paths.end());
+		for (const auto& path : m_files)
+		{
+			std::int64_t modified = 0;
+			MappedFile::getModifiedTime(path, modified);
+			m_modified[path] = modified;
+		}
+#ifdef __linux__
+		if (m_inotify < 0)
+		{
+			return;
+		}
+		// редакторы часто сохраняют через временный файл, поэтому отслеживаются каталоги
+		std::set<std::string> directories;
+		for (const auto& path : m_files)
+		{
+			const size_t slash = path.find_last_of('/');
+			directories.insert(slash == std::string::npos ? std::string() : path.substr(0, slash + 1));
+		}
+		for (const auto& directory : directories)
+		{
+			const int watch = inotify_add_watch(m_inotify, directory.empty() ? "." : directory.c_str(),
+												IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+			if (watch < 0)
+			{
+				std::cerr << "Watch: cannot watch " << directory << std::endl;
+				continue;
+			}
+			m_directories[watch] = directory;
+		}
+#endif
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void FileWatcher::clear()
+	{
+#ifdef __linux__
+		for (const auto& directory : m_directories)
+		{
+			inotify_rm_watch(m_inotify, directory.first);
+		}
+		m_directories.clear();
+		if (m_inotify >= 0)
+		{	// события удаленных наблюдений
+			collect();
+		}
+#endif
+		m_files.clear();
+		m_modified.clear();
+		m_pending.clear();
+		m_reported.clear();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool FileWatcher::collect()
+	{
+		bool changed = false;
+#ifdef __linux__
+		if (m_inotify >= 0)
+		{
+			// буфер выровнен под структуру события
+			alignas(inotify_event) char buffer[4096];
+			for (;;)
+			{
+				const ssize_t size = read(m_inotify, buffer, sizeof(buffer));
+				if (size <= 0)
+				{	// EAGAIN - событий больше нет
+					break;
+				}
+				for (ssize_t offset = 0; offset < size;)
+				{
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					offset += sizeof(inotify_event) + event->len;
+					const auto itDirectory = m_directories.find(event->wd);
+					if (itDirectory == m_directories.end() || !event->len)
+					{
+						continue;
+					}
+					const std::string path(itDirectory->second + event->name);
+					if (m_files.find(path) != m_files.end())
+					{
+						m_pending.insert(path);
+						changed = true;
+					}
+				}
+			}
+			return changed;
+		}
+#endif
+		if (m_sincePoll.getElapsedTime().asMilliseconds() < m_intervalMs)
+		{
+			return false;
+		}
+		m_sincePoll.restart();
+		for (auto& file : m_modified)
+		{
+			std::int64_t modified = 0;
+			MappedFile::getModifiedTime(file.first, modified);
+			if (modified != file.second)
+			{
+				file.second = modified;
+				m_pending.insert(file.first);
+				changed = true;
+			}
+		}
+		return changed;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool FileWatcher::poll()
+	{
+		if (m_files.empty())
+		{
+			return false;
+		}
+		if (collect())
+		{	// запись еще может продолжаться, отсчет паузы начинается заново
+			m_sinceChange.restart();
+			return false;
+		}
+		if (!m_pending.empty() && m_sinceChange.getElapsedTime().asMilliseconds() >= m_settleMs)
+		{
+			m_reported.swap(m_pending);
+			m_pending.clear();
+			return true;
+		}
+		return false;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::set<std::string>& FileWatcher::getChanged() const
+	{
+		return m_reported;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include <iostream>
+
+#include <SFML/System.hpp>
+
+#include "mappedfile.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	следит за изменением файлов на диске для перезагрузки уровня на лету
+				в Linux изменения приходят от inotify по каталогам файлов,
+				поэтому замечается и сохранение через временный файл с переименованием,
+				на остальных системах время изменения опрашивается с небольшим периодом
+				об изменении сообщается после паузы, когда редактор закончил запись
+	*/
+	class FileWatcher final
+	{
+		static const sf::Int32 m_settleMs;		// пауза после последнего изменения
+		static const sf::Int32 m_intervalMs;	// период опроса без inotify
+
+		std::set<std::string> m_files;
+		std::map<std::string, std::int64_t> m_modified;	// время изменения при опросе
+		std::set<std::string> m_pending;	// изменения, о которых еще не сообщено
+		std::set<std::string> m_reported;	// изменения из последнего сообщения
+		sf::Clock m_sinceChange;
+		sf::Clock m_sincePoll;
+#ifdef __linux__
+		int m_inotify;
+		std::map<int, std::string> m_directories;	// дескриптор наблюдения - каталог с разделителем
+#endif
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		/*
+			@brief	собирает изменения с прошлого вызова в m_pending
+			@ret   изменился ли какой-нибудь файл
+		*/
+		bool collect();
+	public:
+		FileWatcher();
+		~FileWatcher();
+		/*
+			@brief заменяет набор отслеживаемых файлов, накопленные изменения сбрасываются
+			@param paths пути к файлам
+		*/
+		void watch(const std::vector<std::string>& paths);
+		/*
+			@brief перестает следить за файлами
+		*/
+		void clear();
+		/*
+			@brief	вызывается каждый кадр
+			@ret   изменились ли файлы и закончилась ли запись, сообщается один раз
+		*/
+		bool poll();
+		/*
+			@brief файлы, изменение которых сообщил последний poll
+		*/
+		const std::set<std::string>& getChanged() const;
+	};
+}
+
+#endif // !FILEWATCHER_H
\ No newline at end of file
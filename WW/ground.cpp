@@ -0,0 +1,224 @@
+#include "ground.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	GroundBuilder::GroundBuilder(unsigned width, unsigned height, unsigned tileWidth, unsigned tileHeight)
+		:	m_width(width), m_height(height), m_tileWidth(tileWidth), m_tileHeight(tileHeight),
+			m_solid(static_cast<size_t>(width) * height, 0),
+			m_outlineCount(0), m_vertexCount(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool GroundBuilder::isSolid(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= static_cast<int>(m_width) || y >= static_cast<int>(m_height))
+		{
+			return false;
+		}
+		return m_solid[y * m_width + x] != 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void GroundBuilder::addLayer(const TileLayer& layer, const TileSet& tiles)
+	{
+		for (unsigned y = 0; y < layer.m_height && y < m_height; ++y)
+		{
+			for (unsigned x = 0; x < layer.m_width && x < m_width; ++x)
+			{
+				const TextureRegion* region = tiles.get(layer.at(x, y));
+				if (!region)
+				{
+					continue;
+				}
+				const int width = std::abs(region->m_rect.width);
+				const int height = std::abs(region->m_rect.height);
+				if (width == static_cast<int>(m_tileWidth) && height == static_cast<int>(m_tileHeight))
+				{
+					m_solid[y * m_width + x] = 1;
+				}
+				else
+				{	// тайл не совпадает с клеткой, для него остается отдельный контур
+					Box box = { static_cast<int>(x * m_tileWidth), static_cast<int>(y * m_tileHeight), width, height };
+					m_boxes.push_back(box);
+				}
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::vector<std::vector<sf::Vector2i>> GroundBuilder::traceOutlines() const
+	{
+		using namespace std;
+
+		// направления: вправо, вниз, влево, вверх (ось У направлена вниз)
+		static const int stepX[4] = { 1, 0, -1, 0 };
+		static const int stepY[4] = { 0, 1, 0, -1 };
+
+		const int cornersX = static_cast<int>(m_width) + 1;
+		const int cornersY = static_cast<int>(m_height) + 1;
+		// для каждого угла клеток набор исходящих граничных ребер
+		vector<uint8_t> outgoing(static_cast<size_t>(cornersX) * cornersY, 0);
+		auto corner = [cornersX](int x, int y) { return static_cast<size_t>(y) * cornersX + x; };
+
+		// ребра идут по часовой стрелке вокруг твердой области
+		for (int y = 0; y < static_cast<int>(m_height); ++y)
+		{
+			for (int x = 0; x < static_cast<int>(m_width); ++x)
+			{
+				if (!isSolid(x, y))
+				{
+					continue;
+				}
+				if (!isSolid(x, y - 1))
+				{
+					outgoing[corner(x, y)] |= 1 << 0;
+				}
+				if (!isSolid(x + 1, y))
+				{
+					outgoing[corner(x + 1, y)] |= 1 << 1;
+				}
+				if (!isSolid(x, y + 1))
+				{
+					outgoing[corner(x + 1, y + 1)] |= 1 << 2;
+				}
+				if (!isSolid(x - 1, y))
+				{
+					outgoing[corner(x, y + 1)] |= 1 << 3;
+				}
+			}
+		}
+
+		vector<vector<sf::Vector2i>> outlines;
+		for (int startY = 0; startY < cornersY; ++startY)
+		{
+			for (int startX = 0; startX < cornersX; ++startX)
+			{
+				while (outgoing[corner(startX, startY)])
+				{
+					int startDir = 0;
+					while (!(outgoing[corner(startX, startY)] & (1 << startDir)))
+					{
+						++startDir;
+					}
+					outgoing[corner(startX, startY)] &= ~(1 << startDir);
+
+					vector<sf::Vector2i> points;
+					vector<int> dirs;
+					int x = startX, y = startY, dir = startDir;
+					for (;;)
+					{
+						points.push_back(sf::Vector2i(x, y));
+						dirs.push_back(dir);
+						x += stepX[dir];
+						y += stepY[dir];
+
+						// сначала поворот по часовой стрелке: области,
+						// касающиеся углами, обходятся раздельно
+						const int candidates[3] = { (dir + 1) % 4, dir, (dir + 3) % 4 };
+						const bool atStart = (x == startX && y == startY);
+						int nextDir = -1;
+						bool closed = false;
+						for (int candidate : candidates)
+						{
+							if (atStart && candidate == startDir)
+							{
+								closed = true;
+								break;
+							}
+							if (outgoing[corner(x, y)] & (1 << candidate))
+							{
+								nextDir = candidate;
+								break;
+							}
+						}
+						if (closed || nextDir < 0)
+						{
+							break;
+						}
+						outgoing[corner(x, y)] &= ~(1 << nextDir);
+						dir = nextDir;
+					}
+
+					// вершины остаются только там, где контур поворачивает
+					vector<sf::Vector2i> outline;
+					for (size_t i = 0; i < points.size(); ++i)
+					{
+						const int prevDir = dirs[(i + dirs.size() - 1) % dirs.size()];
+						if (dirs[i] != prevDir)
+						{
+							outline.push_back(points[i]);
+						}
+					}
+					if (outline.size() >= 3)
+					{
+						outlines.push_back(outline);
+					}
+				}
+			}
+		}
+		return outlines;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	b2Body* GroundBuilder::build(b2World* world, float friction, PhysicObject::Collision* collision)
+	{
+		using namespace std;
+		assert(world);
+
+		b2BodyDef groundBodyDef;
+		groundBodyDef.position.Set(0.0f, 0.0f);
+		b2Body* body = world->CreateBody(&groundBodyDef);
+
+		b2FixtureDef groundFixtureDef;
+		groundFixtureDef.density = 0.0f;	// масса бесконечна
+		groundFixtureDef.friction = friction;
+		groundFixtureDef.userData = collision;
+
+		const auto outlines = traceOutlines();
+		m_outlineCount = outlines.size();
+		m_vertexCount = 0;
+		for (const auto& outline : outlines)
+		{
+			vector<b2Vec2> vertices;
+			vertices.reserve(outline.size());
+			for (const auto& point : outline)
+			{
+				vertices.push_back(b2Vec2(	PhysicObject::mapPixelToPhysic(static_cast<int>(point.x * m_tileWidth)),
+											PhysicObject::mapPixelToPhysic(static_cast<int>(point.y * m_tileHeight))));
+			}
+			b2ChainShape chain;
+			chain.CreateLoop(vertices.data(), static_cast<int32>(vertices.size()));
+			groundFixtureDef.shape = &chain;
+			body->CreateFixture(&groundFixtureDef);
+			m_vertexCount += vertices.size();
+		}
+
+		for (const auto& box : m_boxes)
+		{
+			const float left = PhysicObject::mapPixelToPhysic(box.m_left);
+			const float top = PhysicObject::mapPixelToPhysic(box.m_top);
+			const float right = PhysicObject::mapPixelToPhysic(box.m_left + box.m_width);
+			const float bottom = PhysicObject::mapPixelToPhysic(box.m_top + box.m_height);
+			const b2Vec2 vertices[4] = { b2Vec2(left, top), b2Vec2(right, top), b2Vec2(right, bottom), b2Vec2(left, bottom) };
+
+			b2ChainShape chain;
+			chain.CreateLoop(vertices, 4);
+			groundFixtureDef.shape = &chain;
+			body->CreateFixture(&groundFixtureDef);
+			++m_outlineCount;
+			m_vertexCount += 4;
+		}
+
+		return body;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t GroundBuilder::getOutlineCount() const
+	{
+		return m_outlineCount;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t GroundBuilder::getVertexCount() const
+	{
+		return m_vertexCount;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef GROUND_H
+#define GROUND_H
+
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+
+#include <SFML/Graphics.hpp>
+#include <Box2D/Box2D.h>
+
+#include "object.h"
+#include "tilelayer.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	строит столкновения твердых слоев
+				связные области твердых клеток обводятся контурами,
+				каждый контур становится одной цепочкой на общем статическом теле,
+				поэтому внутренних граней между соседними тайлами нет
+	*/
+	class GroundBuilder final
+	{
+		// @brief тайл, изображение которого не совпадает с клеткой
+		struct Box
+		{
+			int m_left, m_top, m_width, m_height;	// в пикселях
+		};
+
+		unsigned m_width, m_height;			// размер сетки в клетках
+		unsigned m_tileWidth, m_tileHeight;	// размер клетки в пикселях
+		std::vector<std::uint8_t> m_solid;	// 1 - клетка твердая
+		std::vector<Box> m_boxes;
+
+		size_t m_outlineCount;
+		size_t m_vertexCount;
+		/*
+			@brief твердая ли клетка, за пределами сетки пусто
+		*/
+		bool isSolid(int x, int y) const;
+		/*
+			@brief обходит границы твердых областей
+			@ret   замкнутые контуры в координатах углов клеток
+		*/
+		std::vector<std::vector<sf::Vector2i>> traceOutlines() const;
+	public:
+		/*
+			@brief создает пустую сетку
+			@param width ширина в клетках
+			@param height высота в клетках
+			@param tileWidth ширина клетки в пикселях
+			@param tileHeight высота клетки в пикселях
+		*/
+		GroundBuilder(unsigned width, unsigned height, unsigned tileWidth, unsigned tileHeight);
+		/*
+			@brief отмечает непустые клетки слоя как твердые
+			@param layer слой тайлов
+			@param tiles набор тайлов
+		*/
+		void addLayer(const TileLayer& layer, const TileSet& tiles);
+		/*
+			@brief создает статическое тело с цепочками по контурам
+			@param world мир физики
+			@param friction коэффицент трения
+			@param collision дескриптор столкновений для всех цепочек
+			@ret   созданное тело
+		*/
+		b2Body* build(b2World* world, float friction, PhysicObject::Collision* collision);
+		/*
+			@brief количество контуров после build
+		*/
+		size_t getOutlineCount() const;
+		/*
+			@brief количество вершин во всех контурах после build
+		*/
+		size_t getVertexCount() const;
+	};
+}
+
+#endif // !GROUND_H
\ No newline at end of file
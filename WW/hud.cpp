@@ -3,17 +3,17 @@
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
-	HUD::HUD(	const std::string& font, int fontSize, const sf::Image& source,
+	HUD::HUD(	const FontPtr& font, int fontSize, const TexturePtr& texture,
 				const sf::IntRect& liveRect, const sf::IntRect& coinRect)
-		:	m_fontSize(fontSize), m_liveRect(liveRect), m_coinRect(coinRect)
+		:	m_font(font), m_fontSize(fontSize), m_texture(texture), m_liveRect(liveRect), m_coinRect(coinRect)
 	{
-		if (!m_font.loadFromFile(font))
+		if (!m_font)
 		{
-			throw std::runtime_error("GameSpace::HUD::HUD if (!m_font.loadFromFile(font))");
+			throw std::runtime_error("GameSpace::HUD::HUD if (!m_font)");
 		}
-		if (!m_texture.loadFromImage(source))
+		if (!m_texture)
 		{
-			throw std::runtime_error("GameSpace::HUD::HUD if (!m_texture.loadFromImage(source))");
+			throw std::runtime_error("GameSpace::HUD::HUD if (!m_texture)");
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
@@ -26,7 +26,7 @@ namespace GameSpace
 		const int topBorder = 0;
 		const sf::Color decorColor(sf::Color::Black);
 
-		sf::Sprite liveSprite(m_texture, m_liveRect);
+		sf::Sprite liveSprite(*m_texture, m_liveRect);
 		for (int i = 0; i < totalLive; ++i)
 		{
 			liveSprite.setPosition(
@@ -41,8 +41,8 @@ namespace GameSpace
 			render.draw(liveSprite);
 		}
 
-		sf::Sprite coinSprite(m_texture, m_coinRect);
-		sf::Text coinCountText(std::to_string(coin) + " x ", m_font, m_fontSize);
+		sf::Sprite coinSprite(*m_texture, m_coinRect);
+		sf::Text coinCountText(std::to_string(coin) + " x ", *m_font, m_fontSize);
 		coinCountText.setColor(decorColor);
 
 		coinSprite.setPosition(
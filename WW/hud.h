@@ -2,51 +2,56 @@
 #define HUD_H
 
 #include <vector>
+#include <memory>
 #include <stdexcept>
 #include <cassert>
 
 #include <SFML/Graphics.hpp>
 
+#include "texturecache.h"
+
 namespace GameSpace
 {
+	// @brief шрифт, разделяемый копиями HUD
+	typedef std::shared_ptr<const sf::Font> FontPtr;
 	/*
-		@brief     
+		@brief отвечает за отображение пользовательского интерфейса
 	*/
 	class HUD final
 	{
-		sf::Font m_font;
+		FontPtr m_font;
 		int m_fontSize;
 
-		sf::Texture m_texture;
+		TexturePtr m_texture;
 		
 		sf::IntRect m_liveRect;
 		sf::IntRect m_coinRect;
 	public:
 		/*
-			@brief        
-			@param source  
-			@param liveXoffset      
-			@param liveYoffset      
-			@param liveWidth   
-			@param liveHeight   
-			@param font    
+			@brief создает отображение жизней и прочую информацию о игроке
+			@param texture разделяемая текстура
+			@param liveXoffset координата Х единицы жизней на изображении
+			@param liveYoffset координата У единицы жизней на изображении
+			@param liveWidth ширина единицы жизней
+			@param liveHeight высота единицы жизней
+			@param font загруженный шрифт
 			@param coinXoffset
 			@param coinYoffset
-			@param coinWidth 
-			@param coinHeight 
+			@param coinWidth ширина
+			@param coinHeight высота
 		*/
-		HUD(const std::string& font, int fontSize, const sf::Image& source,
+		HUD(const FontPtr& font, int fontSize, const TexturePtr& texture,
 			const sf::IntRect& liveRect, const sf::IntRect& coinRect);
 
 		HUD(const HUD& other) = default;
 		HUD& operator=(const HUD& other) = default;
 		~HUD() = default;
 		/*
-			@brief  HUD
-			@param render   
-			@param curLive  
-			@param totalLive  
-			@param coin  
+			@brief отрисовывает HUD
+			@param render объект для отрисовки
+			@param curLive количество жизней
+			@param totalLive всего жизней
+			@param coin количество монет
 		*/
 		void draw(sf::RenderWindow& render, int curLive, int totalLive, int coin);
 	};
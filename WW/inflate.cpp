@@ -0,0 +1,468 @@
+#include "inflate.h"
+
+namespace GameSpace
+{
+	namespace
+	{
+		// таблица crc32 строится при статической инициализации, до запуска потоков
+		struct CrcTable
+		{
+			std::uint32_t m_values[256];
+
+			CrcTable()
+			{
+				for (std::uint32_t n = 0; n < 256; ++n)
+				{
+					std::uint32_t c = n;
+					for (int k = 0; k < 8; ++k)
+					{
+						c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					}
+					m_values[n] = c;
+				}
+			}
+		};
+		const CrcTable crcTable;
+		//////////////////////////////////////////////////////////////////////////
+		std::uint32_t crc32(const std::uint8_t* data, size_t size)
+		{
+			std::uint32_t crc = 0xFFFFFFFFu;
+			for (size_t i = 0; i < size; ++i)
+			{
+				crc = crcTable.m_values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+			}
+			return crc ^ 0xFFFFFFFFu;
+		}
+		//////////////////////////////////////////////////////////////////////////
+		std::uint32_t adler32(const std::uint8_t* data, size_t size)
+		{
+			std::uint32_t a = 1, b = 0;
+			while (size)
+			{	// 5552 - наибольший блок, при котором сумма не переполняется
+				const size_t block = size < 5552 ? size : 5552;
+				for (size_t i = 0; i < block; ++i)
+				{
+					a += data[i];
+					b += a;
+				}
+				a %= 65521;
+				b %= 65521;
+				data += block;
+				size -= block;
+			}
+			return (b << 16) | a;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	Inflater::Inflater(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out)
+		:	m_data(data), m_size(size), m_pos(0),
+			m_bitBuf(0), m_bitCount(0), m_padBits(0),
+			m_out(out), m_start(out.size())
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::need(unsigned count)
+	{
+		while (m_bitCount < count)
+		{
+			std::uint32_t byte = 0;
+			if (m_pos < m_size)
+			{
+				byte = m_data[m_pos++];
+			}
+			else
+			{	// за концом данных дописываются нули, выход за них проверяется при чтении
+				m_padBits += 8;
+			}
+			m_bitBuf |= byte << m_bitCount;
+			m_bitCount += 8;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint32_t Inflater::bits(unsigned count)
+	{
+		need(count);
+		const std::uint32_t value = m_bitBuf & ((1u << count) - 1);
+		m_bitBuf >>= count;
+		m_bitCount -= count;
+		if (m_bitCount < m_padBits)
+		{
+			throw std::runtime_error("GameSpace::Inflater::bits if (m_bitCount < m_padBits)");
+		}
+		return value;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::alignToByte()
+	{
+		m_bitBuf >>= m_bitCount & 7;
+		m_bitCount -= m_bitCount & 7;
+		if (m_bitCount < m_padBits)
+		{
+			throw std::runtime_error("GameSpace::Inflater::alignToByte if (m_bitCount < m_padBits)");
+		}
+		m_pos -= (m_bitCount - m_padBits) / 8;
+		m_bitBuf = 0;
+		m_bitCount = 0;
+		m_padBits = 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	int Inflater::decode(const Huffman& huffman)
+	{
+		need(m_fastBits);
+		const std::uint16_t entry = huffman.m_fast[m_bitBuf & ((1u << m_fastBits) - 1)];
+		if (entry)
+		{
+			const unsigned length = entry & 0x0F;
+			m_bitBuf >>= length;
+			m_bitCount -= length;
+			if (m_bitCount < m_padBits)
+			{
+				throw std::runtime_error("GameSpace::Inflater::decode if (m_bitCount < m_padBits)");
+			}
+			return entry >> 4;
+		}
+
+		// длинный код читается по одному биту
+		int code = 0, first = 0, index = 0;
+		for (unsigned length = 1; length <= m_maxBits; ++length)
+		{
+			code |= static_cast<int>(bits(1));
+			const int count = huffman.m_counts[length];
+			if (code - count < first)
+			{
+				return huffman.m_symbols[index + (code - first)];
+			}
+			index += count;
+			first += count;
+			first <<= 1;
+			code <<= 1;
+		}
+		throw std::runtime_error("GameSpace::Inflater::decode if (length > m_maxBits)");
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::build(Huffman& huffman, const std::uint8_t* lengths, unsigned count)
+	{
+		std::memset(huffman.m_counts, 0, sizeof(huffman.m_counts));
+		std::memset(huffman.m_fast, 0, sizeof(huffman.m_fast));
+		for (unsigned symbol = 0; symbol < count; ++symbol)
+		{
+			++huffman.m_counts[lengths[symbol]];
+		}
+		huffman.m_counts[0] = 0;
+
+		int left = 1;
+		for (unsigned length = 1; length <= m_maxBits; ++length)
+		{
+			left <<= 1;
+			left -= huffman.m_counts[length];
+			if (left < 0)
+			{
+				throw std::runtime_error("GameSpace::Inflater::build if (left < 0)");
+			}
+		}
+
+		std::uint16_t offsets[m_maxBits + 1];
+		offsets[1] = 0;
+		for (unsigned length = 1; length < m_maxBits; ++length)
+		{
+			offsets[length + 1] = offsets[length] + huffman.m_counts[length];
+		}
+		for (unsigned symbol = 0; symbol < count; ++symbol)
+		{
+			if (lengths[symbol])
+			{
+				huffman.m_symbols[offsets[lengths[symbol]]++] = static_cast<std::uint16_t>(symbol);
+			}
+		}
+
+		// коды в потоке идут старшим битом вперед, поэтому в таблице они развернуты
+		unsigned code = 0, index = 0;
+		for (unsigned length = 1; length <= m_fastBits; ++length)
+		{
+			for (unsigned i = 0; i < huffman.m_counts[length]; ++i, ++code)
+			{
+				unsigned reversed = 0;
+				for (unsigned bit = 0; bit < length; ++bit)
+				{
+					reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+				}
+				const std::uint16_t entry = static_cast<std::uint16_t>((huffman.m_symbols[index++] << 4) | length);
+				for (unsigned slot = reversed; slot < (1u << m_fastBits); slot += 1u << length)
+				{
+					huffman.m_fast[slot] = entry;
+				}
+			}
+			code <<= 1;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::stored()
+	{
+		alignToByte();
+		if (m_size - m_pos < 4)
+		{
+			throw std::runtime_error("GameSpace::Inflater::stored if (m_size - m_pos < 4)");
+		}
+		const unsigned length = m_data[m_pos] | (m_data[m_pos + 1] << 8);
+		const unsigned check = m_data[m_pos + 2] | (m_data[m_pos + 3] << 8);
+		if (length != (~check & 0xFFFF))
+		{
+			throw std::runtime_error("GameSpace::Inflater::stored if (length != (~check & 0xFFFF))");
+		}
+		m_pos += 4;
+		if (m_size - m_pos < length)
+		{
+			throw std::runtime_error("GameSpace::Inflater::stored if (m_size - m_pos < length)");
+		}
+		m_out.insert(m_out.end(), m_data + m_pos, m_data + m_pos + length);
+		m_pos += length;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::codes(const Huffman& lengthCode, const Huffman& distCode)
+	{
+		static const std::uint16_t lengthBase[29] = {	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+														35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static const std::uint8_t lengthExtra[29] = {	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+														3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		static const std::uint16_t distBase[30] = {	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+													257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+													8193, 12289, 16385, 24577 };
+		static const std::uint8_t distExtra[30] = {	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+													7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+		for (;;)
+		{
+			int symbol = decode(lengthCode);
+			if (symbol < 256)
+			{
+				m_out.push_back(static_cast<std::uint8_t>(symbol));
+			}
+			else if (symbol == 256)
+			{
+				return;
+			}
+			else
+			{
+				symbol -= 257;
+				if (symbol >= 29)
+				{
+					throw std::runtime_error("GameSpace::Inflater::codes if (symbol >= 29)");
+				}
+				const size_t length = lengthBase[symbol] + bits(lengthExtra[symbol]);
+
+				symbol = decode(distCode);
+				if (symbol >= 30)
+				{
+					throw std::runtime_error("GameSpace::Inflater::codes if (symbol >= 30)");
+				}
+				const size_t dist = distBase[symbol] + bits(distExtra[symbol]);
+				if (dist > m_out.size() - m_start)
+				{
+					throw std::runtime_error("GameSpace::Inflater::codes if (dist > m_out.size() - m_start)");
+				}
+
+				// источник и приемник могут перекрываться, поэтому копирование побайтное
+				const size_t from = m_out.size() - dist;
+				for (size_t i = 0; i < length; ++i)
+				{
+					m_out.push_back(m_out[from + i]);
+				}
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::fixed()
+	{
+		std::uint8_t lengths[288 + 30];
+		std::memset(lengths, 8, 144);
+		std::memset(lengths + 144, 9, 256 - 144);
+		std::memset(lengths + 256, 7, 280 - 256);
+		std::memset(lengths + 280, 8, 288 - 280);
+		std::memset(lengths + 288, 5, 30);
+
+		Huffman lengthCode, distCode;
+		build(lengthCode, lengths, 288);
+		build(distCode, lengths + 288, 30);
+		codes(lengthCode, distCode);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::dynamic()
+	{
+		static const std::uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+		const unsigned lengthCount = bits(5) + 257;
+		const unsigned distCount = bits(5) + 1;
+		const unsigned codeCount = bits(4) + 4;
+		if (lengthCount > 286 || distCount > 30)
+		{
+			throw std::runtime_error("GameSpace::Inflater::dynamic if (lengthCount > 286 || distCount > 30)");
+		}
+
+		std::uint8_t lengths[286 + 30] = { 0 };
+		for (unsigned i = 0; i < codeCount; ++i)
+		{
+			lengths[order[i]] = static_cast<std::uint8_t>(bits(3));
+		}
+		Huffman lengthCode, distCode;
+		build(lengthCode, lengths, 19);
+
+		// длины кодов литералов и расстояний сами сжаты кодом длин
+		const unsigned total = lengthCount + distCount;
+		unsigned index = 0;
+		while (index < total)
+		{
+			const int symbol = decode(lengthCode);
+			if (symbol < 16)
+			{
+				lengths[index++] = static_cast<std::uint8_t>(symbol);
+				continue;
+			}
+			std::uint8_t length = 0;
+			unsigned repeat = 0;
+			if (symbol == 16)
+			{
+				if (index == 0)
+				{
+					throw std::runtime_error("GameSpace::Inflater::dynamic if (index == 0)");
+				}
+				length = lengths[index - 1];
+				repeat = 3 + bits(2);
+			}
+			else if (symbol == 17)
+			{
+				repeat = 3 + bits(3);
+			}
+			else
+			{
+				repeat = 11 + bits(7);
+			}
+			if (index + repeat > total)
+			{
+				throw std::runtime_error("GameSpace::Inflater::dynamic if (index + repeat > total)");
+			}
+			while (repeat--)
+			{
+				lengths[index++] = length;
+			}
+		}
+		if (lengths[256] == 0)
+		{
+			throw std::runtime_error("GameSpace::Inflater::dynamic if (lengths[256] == 0)");
+		}
+
+		build(lengthCode, lengths, lengthCount);
+		build(distCode, lengths + lengthCount, distCount);
+		codes(lengthCode, distCode);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t Inflater::run()
+	{
+		bool last = false;
+		while (!last)
+		{
+			last = bits(1) != 0;
+			switch (bits(2))
+			{
+			case 0:
+				stored();
+				break;
+			case 1:
+				fixed();
+				break;
+			case 2:
+				dynamic();
+				break;
+			default:
+				throw std::runtime_error("GameSpace::Inflater::run if (type == 3)");
+			}
+		}
+		alignToByte();
+		return m_pos;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t Inflater::inflate(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out)
+	{
+		Inflater inflater(data, size, out);
+		return inflater.run();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::inflateZlib(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out)
+	{
+		if (size < 6)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateZlib if (size < 6)");
+		}
+		const unsigned method = data[0], flags = data[1];
+		if ((method & 0x0F) != 8 || (method * 256 + flags) % 31 != 0 || (flags & 0x20))
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateZlib if (!header)");
+		}
+
+		const size_t start = out.size();
+		const size_t end = 2 + inflate(data + 2, size - 2, out);
+		if (size - end < 4)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateZlib if (size - end < 4)");
+		}
+		const std::uint32_t expected =	(static_cast<std::uint32_t>(data[end]) << 24) | (data[end + 1] << 16) |
+										(data[end + 2] << 8) | data[end + 3];
+		if (adler32(out.data() + start, out.size() - start) != expected)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateZlib if (adler32(...) != expected)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Inflater::inflateGzip(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out)
+	{
+		if (size < 18 || data[0] != 0x1F || data[1] != 0x8B || data[2] != 8)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateGzip if (!header)");
+		}
+		const unsigned flags = data[3];
+		size_t pos = 10;
+		if (flags & 0x04)
+		{	// FEXTRA
+			if (size - pos < 2)
+			{
+				throw std::runtime_error("GameSpace::Inflater::inflateGzip if (size - pos < 2)");
+			}
+			pos += 2 + (data[pos] | (data[pos + 1] << 8));
+		}
+		for (unsigned flag = 0x08; flag <= 0x10; flag <<= 1)
+		{	// FNAME и FCOMMENT - строки, оканчивающиеся нулем
+			if (flags & flag)
+			{
+				while (pos < size && data[pos])
+				{
+					++pos;
+				}
+				++pos;
+			}
+		}
+		if (flags & 0x02)
+		{	// FHCRC
+			pos += 2;
+		}
+		if (pos >= size)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateGzip if (pos >= size)");
+		}
+
+		const size_t start = out.size();
+		const size_t end = pos + inflate(data + pos, size - pos, out);
+		if (size - end < 8)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateGzip if (size - end < 8)");
+		}
+		const std::uint32_t expectedCrc =	data[end] | (data[end + 1] << 8) | (data[end + 2] << 16) |
+											(static_cast<std::uint32_t>(data[end + 3]) << 24);
+		const std::uint32_t expectedSize =	data[end + 4] | (data[end + 5] << 8) | (data[end + 6] << 16) |
+											(static_cast<std::uint32_t>(data[end + 7]) << 24);
+		if (crc32(out.data() + start, out.size() - start) != expectedCrc ||
+			static_cast<std::uint32_t>(out.size() - start) != expectedSize)
+		{
+			throw std::runtime_error("GameSpace::Inflater::inflateGzip if (crc32(...) != expectedCrc)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
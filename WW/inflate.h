@@ -0,0 +1,108 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace GameSpace
+{
+	/*
+		@brief	распаковщик потока deflate (RFC 1951)
+				поддерживает обертки zlib (RFC 1950) и gzip (RFC 1952),
+				коды Хаффмана до m_fastBits бит декодируются одной выборкой из таблицы
+	*/
+	class Inflater final
+	{
+		static const unsigned m_fastBits = 10;	// разрядность быстрой таблицы
+		static const unsigned m_maxBits = 15;	// наибольшая длина кода
+
+		// @brief канонический код Хаффмана
+		struct Huffman
+		{
+			std::uint16_t m_counts[m_maxBits + 1];	// количество кодов каждой длины
+			std::uint16_t m_symbols[288];			// символы в каноническом порядке
+			std::uint16_t m_fast[1 << m_fastBits];	// (символ << 4) | длина, 0 - медленный путь
+		};
+
+		const std::uint8_t* m_data;
+		size_t m_size;
+		size_t m_pos;				// следующий непрочитанный байт
+		std::uint32_t m_bitBuf;
+		unsigned m_bitCount;		// бит в m_bitBuf
+		unsigned m_padBits;			// нулевых бит, дописанных за концом данных
+		std::vector<std::uint8_t>& m_out;
+		size_t m_start;				// размер m_out до распаковки, дальше ссылаться нельзя
+
+		Inflater(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out);
+		Inflater(const Inflater&) = delete;
+		Inflater& operator=(const Inflater&) = delete;
+
+		/*
+			@brief дочитывает в буфер не меньше count бит
+		*/
+		void need(unsigned count);
+		/*
+			@brief извлекает count бит, младшие идут первыми
+		*/
+		std::uint32_t bits(unsigned count);
+		/*
+			@brief отбрасывает биты до границы байта и возвращает непрочитанные байты
+		*/
+		void alignToByte();
+		/*
+			@brief декодирует один символ
+		*/
+		int decode(const Huffman& huffman);
+		/*
+			@brief строит код по длинам
+			@param huffman результат
+			@param lengths длины кодов символов
+			@param count количество символов
+		*/
+		static void build(Huffman& huffman, const std::uint8_t* lengths, unsigned count);
+		/*
+			@brief блок без сжатия
+		*/
+		void stored();
+		/*
+			@brief распаковывает символы блока до кода конца блока
+			@param lengthCode код литералов и длин
+			@param distCode код расстояний
+		*/
+		void codes(const Huffman& lengthCode, const Huffman& distCode);
+		/*
+			@brief блок с фиксированными кодами
+		*/
+		void fixed();
+		/*
+			@brief блок с кодами, переданными в потоке
+		*/
+		void dynamic();
+		/*
+			@brief распаковывает все блоки потока
+			@ret   количество прочитанных байт
+		*/
+		size_t run();
+	public:
+		/*
+			@brief распаковывает поток deflate без обертки
+			@param data сжатые данные
+			@param size размер сжатых данных
+			@param out буфер, к которому дописываются данные
+			@ret   количество прочитанных байт
+		*/
+		static size_t inflate(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out);
+		/*
+			@brief распаковывает поток zlib с проверкой adler32
+		*/
+		static void inflateZlib(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out);
+		/*
+			@brief распаковывает поток gzip с проверкой crc32 и размера
+		*/
+		static void inflateGzip(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out);
+	};
+}
+
+#endif // !INFLATE_H
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "input.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	void InputSource::begin(const std::string&, float)
+	{
+		// источнику без состояния уровень не важен
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void InputSource::end()
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	InputSource::Actions KeyboardInput::next()
+	{
+		Actions actions = 0;
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+		{
+			actions |= IA_LEFT;
+		}
+		else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+		{
+			actions |= IA_RIGHT;
+		}
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
+		{
+			actions |= IA_JUMP;
+		}
+		return actions;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t Replay::m_magic = 0x50525757;	// "WWRP"
+	const std::uint32_t Replay::m_version = 1;
+	//////////////////////////////////////////////////////////////////////////
+	Replay::Replay()
+		: m_stepRate(0.0f)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Replay::push(InputSource::Actions actions)
+	{
+		if (!m_runs.empty() && m_runs.back().m_actions == actions && m_runs.back().m_length != UINT32_MAX)
+		{
+			++m_runs.back().m_length;
+			return;
+		}
+		Run run;
+		run.m_actions = actions;
+		run.m_length = 1;
+		m_runs.push_back(run);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint64_t Replay::getStepCount() const
+	{
+		std::uint64_t count = 0;
+		for (const auto& run : m_runs)
+		{
+			count += run.m_length;
+		}
+		return count;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Replay::write(const std::string& path) const
+	{
+		using namespace std;
+
+		BinaryWriter writer;
+		writer.writeU32(m_magic);
+		writer.writeU32(m_version);
+		writer.writeString(m_level);
+		writer.writeFloat(m_stepRate);
+		writer.writeU32(static_cast<uint32_t>(m_runs.size()));
+		for (const auto& run : m_runs)
+		{
+			writer.writeBytes(&run.m_actions, sizeof(run.m_actions));
+			writer.writeU32(run.m_length);
+		}
+
+		const string temporary(path + ".tmp");
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw runtime_error("GameSpace::Replay::write if (!file)");
+		}
+		const vector<uint8_t>& data = writer.getData();
+		const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+		if (fclose(file) != 0 || !written)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::Replay::write if (!written)");
+		}
+		remove(path.c_str());
+		if (rename(temporary.c_str(), path.c_str()) != 0)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::Replay::write if (rename(...) != 0)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	Replay Replay::read(const std::string& path)
+	{
+		using namespace std;
+
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+		{
+			throw runtime_error("GameSpace::Replay::read if (!file)");
+		}
+		vector<uint8_t> data;
+		uint8_t buffer[4096];
+		size_t count;
+		while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			data.insert(data.end(), buffer, buffer + count);
+		}
+		fclose(file);
+
+		BinaryReader reader(data.data(), data.size());
+		if (reader.readU32() != m_magic)
+		{
+			throw runtime_error("GameSpace::Replay::read if (reader.readU32() != m_magic)");
+		}
+		if (reader.readU32() != m_version)
+		{
+			throw runtime_error("GameSpace::Replay::read if (reader.readU32() != m_version)");
+		}
+		Replay replay;
+		replay.m_level = reader.readString();
+		replay.m_stepRate = reader.readFloat();
+		// число серий не должно превышать оставшиеся данные, иначе поврежденный файл
+		// запросит огромный массив до первой ошибки чтения
+		const uint32_t runCount = reader.readU32();
+		if (runCount > reader.getRemaining() / (sizeof(InputSource::Actions) + sizeof(uint32_t)))
+		{
+			throw runtime_error("GameSpace::Replay::read if (runCount > reader.getRemaining() / runSize)");
+		}
+		replay.m_runs.resize(runCount);
+		for (auto& run : replay.m_runs)
+		{
+			reader.readBytes(&run.m_actions, sizeof(run.m_actions));
+			run.m_length = reader.readU32();
+			if (!run.m_length)
+			{
+				throw runtime_error("GameSpace::Replay::read if (!run.m_length)");
+			}
+		}
+		return replay;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	InputRecorder::InputRecorder(const std::shared_ptr<InputSource>& source, const std::string& path)
+		: m_source(source), m_path(path), m_recording(false)
+	{
+		if (!m_source)
+		{
+			throw std::runtime_error("GameSpace::InputRecorder::InputRecorder if (!m_source)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	InputRecorder::~InputRecorder()
+	{
+		try
+		{
+			end();
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Record: " << e.what() << std::endl;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void InputRecorder::begin(const std::string& level, float stepRate)
+	{
+		end();
+		m_source->begin(level, stepRate);
+		if (stepRate <= 0.0f)
+		{	// шаги зависят от частоты кадров, повтор разойдется с записью
+			std::cerr << "Record: " << level << " has no fixed step, replay will not be exact" << std::endl;
+		}
+		m_replay = Replay();
+		m_replay.m_level = level;
+		m_replay.m_stepRate = stepRate;
+		m_recording = true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void InputRecorder::end()
+	{
+		if (!m_recording)
+		{
+			return;
+		}
+		m_recording = false;
+		m_source->end();
+		m_replay.write(m_path);
+		if (Diagnostics::isEnabled())
+		{
+			std::cout	<< "Record: " << m_replay.m_level << " " << m_replay.getStepCount() << " steps in "
+						<< m_replay.m_runs.size() << " runs to " << m_path << std::endl;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	InputSource::Actions InputRecorder::next()
+	{
+		const Actions actions = m_source->next();
+		if (m_recording)
+		{
+			m_replay.push(actions);
+		}
+		return actions;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	ReplayInput::ReplayInput(const std::string& path)
+		: m_replay(Replay::read(path)), m_active(false), m_run(0), m_step(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ReplayInput::begin(const std::string& level, float stepRate)
+	{
+		m_active = level == m_replay.m_level;
+		m_run = 0;
+		m_step = 0;
+		if (!m_active)
+		{
+			std::cerr << "Replay: recorded for " << m_replay.m_level << ", not " << level << std::endl;
+		}
+		else if (stepRate != m_replay.m_stepRate)
+		{
+			std::cerr << "Replay: step rate " << stepRate << " differs from recorded " << m_replay.m_stepRate << std::endl;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	InputSource::Actions ReplayInput::next()
+	{
+		if (!m_active || isFinished())
+		{
+			return 0;
+		}
+		const Actions actions = m_replay.m_runs[m_run].m_actions;
+		if (++m_step >= m_replay.m_runs[m_run].m_length)
+		{
+			++m_run;
+			m_step = 0;
+		}
+		return actions;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool ReplayInput::isFinished() const
+	{
+		return m_run >= m_replay.m_runs.size();
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
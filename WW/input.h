@@ -0,0 +1,151 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <iostream>
+
+#include <SFML/Window.hpp>
+
+#include "binarystream.h"
+#include "diagnostics.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	источник управления игроком
+				на каждый шаг физики мир запрашивает ровно один снимок действий,
+				поэтому одна и та же последовательность снимков повторяет прохождение
+	*/
+	class InputSource
+	{
+	public:
+		// @brief действия игрока, снимок - их битовая маска
+		enum Action : std::uint8_t
+		{
+			IA_LEFT = 1,
+			IA_RIGHT = 2,
+			IA_JUMP = 4
+		};
+		typedef std::uint8_t Actions;
+
+		virtual ~InputSource() = default;
+		/*
+			@brief	уровень собран, шаги начинаются заново
+			@param level файл уровня
+			@param stepRate шагов физики в секунду, 0 - шаг на кадр
+		*/
+		virtual void begin(const std::string& level, float stepRate);
+		/*
+			@brief уровень удаляется из мира
+		*/
+		virtual void end();
+		/*
+			@brief снимок действий на следующий шаг
+		*/
+		virtual Actions next() = 0;
+	};
+	/*
+		@brief управление с клавиатуры: стрелки влево, вправо и вверх
+	*/
+	class KeyboardInput final : public InputSource
+	{
+	public:
+		virtual Actions next() override;
+	};
+	/*
+		@brief	файл повтора (.wwr)
+				заголовок, уровень, частота шагов и снимки, сжатые по сериям:
+				одинаковые подряд снимки хранятся одной парой (снимок, длина)
+	*/
+	class Replay final
+	{
+		static const std::uint32_t m_magic;
+		static const std::uint32_t m_version;
+	public:
+		// @brief серия одинаковых снимков
+		struct Run
+		{
+			InputSource::Actions m_actions;
+			std::uint32_t m_length;
+		};
+		std::string m_level;
+		float m_stepRate;
+		std::vector<Run> m_runs;
+
+		Replay();
+		/*
+			@brief добавляет снимок, продлевая последнюю серию
+		*/
+		void push(InputSource::Actions actions);
+		/*
+			@brief количество шагов во всех сериях
+		*/
+		std::uint64_t getStepCount() const;
+		/*
+			@brief записывает повтор через временный файл
+			@param path путь к результату
+		*/
+		void write(const std::string& path) const;
+		/*
+			@brief	читает повтор, при отсутствии или повреждении файла бросает исключение
+			@param path путь к файлу
+		*/
+		static Replay read(const std::string& path);
+	};
+	/*
+		@brief	записывает снимки другого источника
+				повтор уровня записывается в файл, когда уровень удаляется из мира
+	*/
+	class InputRecorder final : public InputSource
+	{
+		std::shared_ptr<InputSource> m_source;
+		std::string m_path;
+		Replay m_replay;
+		bool m_recording;	// есть незаписанные шаги
+
+		InputRecorder(const InputRecorder&) = delete;
+		InputRecorder& operator=(const InputRecorder&) = delete;
+	public:
+		/*
+			@param source источник, снимки которого записываются
+			@param path файл повтора, перезаписывается для каждого уровня
+		*/
+		InputRecorder(const std::shared_ptr<InputSource>& source, const std::string& path);
+		/*
+			@brief записывает незаконченный повтор
+		*/
+		~InputRecorder();
+		virtual void begin(const std::string& level, float stepRate) override;
+		virtual void end() override;
+		virtual Actions next() override;
+	};
+	/*
+		@brief	воспроизводит снимки из файла повтора, начиная с первого шага уровня
+				на другом уровне и после конца повтора действий нет
+	*/
+	class ReplayInput final : public InputSource
+	{
+		Replay m_replay;
+		bool m_active;		// идет уровень повтора
+		size_t m_run;		// текущая серия
+		std::uint32_t m_step;	// шаг внутри серии
+	public:
+		/*
+			@param path файл повтора
+		*/
+		explicit ReplayInput(const std::string& path);
+		virtual void begin(const std::string& level, float stepRate) override;
+		virtual Actions next() override;
+		/*
+			@brief закончились ли снимки повтора
+		*/
+		bool isFinished() const;
+	};
+}
+
+#endif // !INPUT_H
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "layerdecoder.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t LayerDecoder::m_gidMask = 0x1FFFFFFF;
+	//////////////////////////////////////////////////////////////////////////
+	void LayerDecoder::decodeCSV(const char* text, size_t size, std::vector<std::uint32_t>& gids)
+	{
+		size_t count = 0;
+		const char* it = text;
+		const char* end = text + size;
+		for (;;)
+		{
+			while (it < end && (*it == ' ' || *it == '\t' || *it == '\r' || *it == '\n'))
+			{
+				++it;
+			}
+			if (it == end)
+			{
+				break;
+			}
+			if (*it < '0' || *it > '9')
+			{
+				throw std::runtime_error("GameSpace::LayerDecoder::decodeCSV if (!digit)");
+			}
+			std::uint32_t gid = 0;
+			while (it < end && *it >= '0' && *it <= '9')
+			{
+				gid = gid * 10 + static_cast<std::uint32_t>(*it - '0');
+				++it;
+			}
+			if (count >= gids.size())
+			{
+				throw std::runtime_error("GameSpace::LayerDecoder::decodeCSV if (count >= gids.size())");
+			}
+			gids[count++] = clearFlags(gid);
+
+			while (it < end && (*it == ' ' || *it == '\t' || *it == '\r' || *it == '\n'))
+			{
+				++it;
+			}
+			if (it < end && *it == ',')
+			{
+				++it;
+			}
+		}
+		if (count != gids.size())
+		{
+			throw std::runtime_error("GameSpace::LayerDecoder::decodeCSV if (count != gids.size())");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LayerDecoder::decodeBase64(const char* text, size_t size, std::vector<std::uint8_t>& bytes)
+	{
+		// 64 - пробельный символ, 65 - недопустимый
+		static const std::uint8_t table[256] = {
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 64, 64, 65, 65, 64, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			64, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 62, 65, 65, 65, 63,
+			52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 65, 65, 65, 65, 65, 65,
+			65,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+			15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 65, 65, 65, 65, 65,
+			65, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+			65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65 };
+
+		std::uint32_t accum = 0;
+		unsigned accumBits = 0;
+		const unsigned char* it = reinterpret_cast<const unsigned char*>(text);
+		const unsigned char* end = it + size;
+		for (; it < end && *it != '='; ++it)
+		{
+			const std::uint8_t value = table[*it];
+			if (value == 64)
+			{
+				continue;
+			}
+			if (value == 65)
+			{
+				throw std::runtime_error("GameSpace::LayerDecoder::decodeBase64 if (value == 65)");
+			}
+			accum = (accum << 6) | value;
+			accumBits += 6;
+			if (accumBits >= 8)
+			{
+				accumBits -= 8;
+				bytes.push_back(static_cast<std::uint8_t>(accum >> accumBits));
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LayerDecoder::unpackGids(const std::vector<std::uint8_t>& bytes, std::vector<std::uint32_t>& gids)
+	{
+		if (bytes.size() != gids.size() * 4)
+		{
+			throw std::runtime_error("GameSpace::LayerDecoder::unpackGids if (bytes.size() != gids.size() * 4)");
+		}
+		for (size_t i = 0; i < gids.size(); ++i)
+		{
+			const std::uint8_t* cell = &bytes[i * 4];
+			gids[i] = clearFlags(	cell[0] | (cell[1] << 8) | (cell[2] << 16) |
+									(static_cast<std::uint32_t>(cell[3]) << 24));
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LayerDecoder::decode(	const char* text, size_t size, const std::string& encoding, const std::string& compression,
+								std::vector<std::uint32_t>& gids)
+	{
+		if (!text)
+		{
+			text = "";
+			size = 0;
+		}
+		if (encoding == "csv")
+		{
+			if (!compression.empty())
+			{
+				throw std::runtime_error("GameSpace::LayerDecoder::decode if (!compression.empty())");
+			}
+			decodeCSV(text, size, gids);
+			return;
+		}
+		if (encoding != "base64")
+		{
+			throw std::runtime_error("GameSpace::LayerDecoder::decode if (encoding != \"base64\")");
+		}
+
+		std::vector<std::uint8_t> encoded;
+		encoded.reserve(size / 4 * 3);
+		decodeBase64(text, size, encoded);
+		if (compression.empty())
+		{
+			unpackGids(encoded, gids);
+			return;
+		}
+
+		std::vector<std::uint8_t> bytes;
+		bytes.reserve(gids.size() * 4);
+		if (compression == "zlib")
+		{
+			Inflater::inflateZlib(encoded.data(), encoded.size(), bytes);
+		}
+		else if (compression == "gzip")
+		{
+			Inflater::inflateGzip(encoded.data(), encoded.size(), bytes);
+		}
+		else
+		{
+			throw std::runtime_error("GameSpace::LayerDecoder::decode if (compression != \"zlib\" && compression != \"gzip\")");
+		}
+		unpackGids(bytes, gids);
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef LAYERDECODER_H
+#define LAYERDECODER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include "inflate.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	разбор данных слоя tmx в форматах csv и base64
+				base64 может быть сжат zlib или gzip,
+				номера тайлов пишутся сразу в целочисленный буфер без промежуточных строк
+	*/
+	class LayerDecoder final
+	{
+		static const std::uint32_t m_gidMask;	// сбрасывает флаги отражения Tiled
+
+		/*
+			@brief разбирает номера, разделенные запятыми
+			@param text текст элемента data
+			@param size длина текста
+			@param gids буфер, заполняемый целиком
+		*/
+		static void decodeCSV(const char* text, size_t size, std::vector<std::uint32_t>& gids);
+		/*
+			@brief декодирует base64, пробельные символы пропускаются
+			@param text текст элемента data
+			@param size длина текста
+			@param bytes результирующие байты
+		*/
+		static void decodeBase64(const char* text, size_t size, std::vector<std::uint8_t>& bytes);
+		/*
+			@brief переводит байты в номера тайлов (32 бита, младший байт первый)
+			@param bytes распакованные данные
+			@param gids буфер, заполняемый целиком
+		*/
+		static void unpackGids(const std::vector<std::uint8_t>& bytes, std::vector<std::uint32_t>& gids);
+	public:
+		/*
+			@brief декодирует данные слоя
+			@param text текст элемента data, может не заканчиваться нулем
+			@param size длина текста
+			@param encoding значение атрибута encoding: "csv" или "base64"
+			@param compression значение атрибута compression: "", "zlib" или "gzip"
+			@param gids буфер размером с слой, заполняется целиком
+		*/
+		static void decode(	const char* text, size_t size, const std::string& encoding, const std::string& compression,
+							std::vector<std::uint32_t>& gids);
+		/*
+			@brief номер тайла без флагов отражения
+		*/
+		static std::uint32_t clearFlags(std::uint32_t gid)
+		{
+			return gid & m_gidMask;
+		}
+	};
+}
+
+#endif // !LAYERDECODER_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "leveldata.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	LevelData::LevelData()
+		:	m_width(0), m_height(0), m_tileWidth(0), m_tileHeight(0),
+			m_bgColor(255, 255, 255, 255),
+			m_gravityX(0.0f), m_gravityY(0.0f), m_timeWarp(1.0f), m_stepRate(60.0f), m_friction(0.0f)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::string& LevelData::getTileImage(std::uint32_t gid) const
+	{
+		auto itTile = m_tiles.find(gid);
+		if (itTile == m_tiles.end() || itTile->second >= m_images.size())
+		{
+			throw std::runtime_error("GameSpace::LevelData::getTileImage if (itTile == m_tiles.end())");
+		}
+		return m_images[itTile->second];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint32_t LevelData::addImage(const std::string& path)
+	{
+		auto itImage = std::find(m_images.begin(), m_images.end(), path);
+		if (itImage != m_images.end())
+		{
+			return static_cast<std::uint32_t>(itImage - m_images.begin());
+		}
+		m_images.push_back(path);
+		return static_cast<std::uint32_t>(m_images.size() - 1);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::string& LevelData::getString(std::uint32_t index) const
+	{
+		if (index >= m_strings.size())
+		{
+			throw std::runtime_error("GameSpace::LevelData::getString if (index >= m_strings.size())");
+		}
+		return m_strings[index];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const LevelProperty* LevelData::findProperty(const LevelObject& object, const std::string& name) const
+	{
+		for (std::uint32_t i = 0; i < object.m_propertyCount; ++i)
+		{
+			const LevelProperty& property = m_properties[object.m_firstProperty + i];
+			if (getString(property.m_name) == name)
+			{
+				return &property;
+			}
+		}
+		return nullptr;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
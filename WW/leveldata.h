@@ -0,0 +1,137 @@
+#ifndef LEVELDATA_H
+#define LEVELDATA_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+
+#include "tilelayer.h"
+#include "animation.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	типизированное свойство объекта карты
+				имя и строковое значение - номера в таблице строк уровня
+	*/
+	struct LevelProperty
+	{
+		enum class Type{	PT_INT,
+							PT_FLOAT,
+							PT_STRING
+						};
+		std::uint32_t m_name;
+		Type m_type;
+		union
+		{
+			std::int32_t m_int;
+			float m_float;
+			std::uint32_t m_string;
+		};
+		LevelProperty() : m_name(0), m_type(Type::PT_INT), m_int(0)
+		{}
+	};
+	/*
+		@brief	объект карты
+				свойства всех объектов лежат подряд в LevelData::m_properties,
+				поэтому объект не владеет памятью
+	*/
+	struct LevelObject
+	{
+		std::uint32_t m_type;			// номер имени типа в таблице строк
+		std::uint32_t m_gid;
+		std::int32_t m_x, m_y;			// левый нижний угол
+		std::uint32_t m_firstProperty;	// первое свойство в LevelData::m_properties
+		std::uint32_t m_propertyCount;
+	};
+	// @brief описание анимации без привязки к текстуре
+	struct AnimationData
+	{
+		struct State
+		{
+			Animation::MoveState m_state;
+			float m_speed;
+			std::vector<sf::IntRect> m_frames;
+		};
+		sf::IntRect m_defaultFrame;
+		Animation::MoveState m_initState;
+		std::vector<State> m_states;
+	};
+	// @brief описание игрока из его файла конфигурации
+	struct PlayerData
+	{
+		float m_density, m_friction;
+		float m_xvelocity, m_yvelocity;
+		std::int32_t m_lives, m_winCoins;
+		std::string m_file;			// изображение с кадрами
+		AnimationData m_animation;	// кадры заданы относительно изображения
+		std::string m_hudFile;		// изображение HUD
+		std::string m_fontFile;
+		std::int32_t m_fontSize;
+		sf::IntRect m_liveRect;		// единица жизни на изображении HUD
+		sf::IntRect m_coinRect;		// монета на изображении HUD
+		std::string m_stepSound, m_jumpSound, m_getLiveSound, m_getCoinSound;
+	};
+	// @brief файл, из которого собран уровень
+	struct LevelSource
+	{
+		std::string m_path;
+		std::int64_t m_modified;	// время изменения
+		std::uint64_t m_size;
+		std::uint64_t m_hash;		// FNV-1a содержимого
+	};
+	/*
+		@brief	уровень в виде, не зависящем от формата файла
+				заполняется из tmx или из скомпилированного файла,
+				по нему строится игровой мир
+	*/
+	struct LevelData
+	{
+		std::int32_t m_width, m_height;			// размер в тайлах
+		std::int32_t m_tileWidth, m_tileHeight;	// размер тайла в пикселях
+		sf::Color m_bgColor;
+		float m_gravityX, m_gravityY;
+		float m_timeWarp;
+		float m_stepRate;						// шагов физики в секунду игрового времени, 0 - шаг на кадр
+		float m_friction;						// трение твердых слоев
+
+		std::vector<std::string> m_images;		// таблица изображений для атласа
+		std::map<std::uint32_t, std::uint32_t> m_tiles;	// gid - индекс в m_images
+		std::vector<TileLayer> m_layers;		// в порядке отрисовки
+		std::vector<LevelObject> m_objects;
+		std::vector<LevelProperty> m_properties;	// свойства объектов подряд
+		std::vector<std::string> m_strings;		// имена типов и свойств, строковые значения, без повторов
+		std::map<std::string, PlayerData> m_players;	// файл конфигурации - игрок
+
+		std::vector<LevelSource> m_sources;		// исходные файлы уровня
+
+		LevelData();
+		/*
+			@brief путь к изображению тайла
+		*/
+		const std::string& getTileImage(std::uint32_t gid) const;
+		/*
+			@brief добавляет изображение в таблицу, если его там еще нет
+			@ret   индекс изображения
+		*/
+		std::uint32_t addImage(const std::string& path);
+		/*
+			@brief строка из таблицы строк
+			@param index номер строки
+		*/
+		const std::string& getString(std::uint32_t index) const;
+		/*
+			@brief	ищет свойство объекта по имени
+					для редких обращений, создание объектов сопоставляет имена один раз
+			@ret   свойство или nullptr
+		*/
+		const LevelProperty* findProperty(const LevelObject& object, const std::string& name) const;
+	};
+}
+
+#endif // !LEVELDATA_H
\ No newline at end of file
@@ -0,0 +1,559 @@
+#include "levelfile.h"
+
+namespace GameSpace
+{
+	namespace
+	{
+		std::uint32_t makeTag(char a, char b, char c, char d)
+		{
+			return	static_cast<std::uint32_t>(static_cast<std::uint8_t>(a)) |
+					(static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8) |
+					(static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16) |
+					(static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24);
+		}
+
+		const std::uint32_t sourcesTag = makeTag('S', 'R', 'C', 'S');
+		const std::uint32_t mapTag = makeTag('M', 'A', 'P', ' ');
+		const std::uint32_t imagesTag = makeTag('I', 'M', 'G', 'S');
+		const std::uint32_t tilesTag = makeTag('T', 'I', 'L', 'E');
+		const std::uint32_t layersTag = makeTag('L', 'A', 'Y', 'R');
+		const std::uint32_t objectsTag = makeTag('O', 'B', 'J', 'S');
+		const std::uint32_t playersTag = makeTag('P', 'L', 'Y', 'R');
+		//////////////////////////////////////////////////////////////////////////
+		void writeRect(BinaryWriter& writer, const sf::IntRect& rect)
+		{
+			writer.writeI32(rect.left);
+			writer.writeI32(rect.top);
+			writer.writeI32(rect.width);
+			writer.writeI32(rect.height);
+		}
+		//////////////////////////////////////////////////////////////////////////
+		/*
+			@brief	читает число элементов и проверяет, что они уместятся в оставшихся данных,
+					иначе поврежденный файл запросит огромный массив до первой ошибки чтения
+			@param reader читатель раздела
+			@param minSize наименьший размер элемента в байтах
+		*/
+		std::uint32_t readCount(BinaryReader& reader, size_t minSize)
+		{
+			const std::uint32_t count = reader.readU32();
+			if (count > reader.getRemaining() / minSize)
+			{
+				throw std::runtime_error("GameSpace::LevelFile::readCount if (count > reader.getRemaining() / minSize)");
+			}
+			return count;
+		}
+		//////////////////////////////////////////////////////////////////////////
+		sf::IntRect readRect(BinaryReader& reader)
+		{
+			sf::IntRect rect;
+			rect.left = reader.readI32();
+			rect.top = reader.readI32();
+			rect.width = reader.readI32();
+			rect.height = reader.readI32();
+			return rect;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t LevelFile::m_magic = makeTag('W', 'W', 'L', 'V');
+	const std::uint32_t LevelFile::m_version = 3;
+	//////////////////////////////////////////////////////////////////////////
+	std::string LevelFile::getCompiledPath(const std::string& source)
+	{
+		const std::string::size_type dot = source.find_last_of('.');
+		const std::string::size_type slash = source.find_last_of("/\\");
+		if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		{
+			return source + ".wwl";
+		}
+		return source.substr(0, dot) + ".wwl";
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool LevelFile::stamp(const std::string& path, LevelSource& result)
+	{
+		const ResourcePtr file = Resources::open(path);
+		if (!file || !Resources::getModifiedTime(path, result.m_modified))
+		{
+			return false;
+		}
+		result.m_path = path;
+		result.m_size = file->getSize();
+
+		// FNV-1a
+		std::uint64_t hash = 14695981039346656037ULL;
+		const std::uint8_t* data = file->getData();
+		for (size_t i = 0; i < file->getSize(); ++i)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ULL;
+		}
+		result.m_hash = hash;
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelFile::writeSources(BinaryWriter& writer, const std::vector<LevelSource>& sources)
+	{
+		writer.writeU32(m_magic);
+		writer.writeU32(m_version);
+
+		const size_t section = writer.beginSection(sourcesTag);
+		writer.writeU32(static_cast<std::uint32_t>(sources.size()));
+		for (const auto& source : sources)
+		{
+			writer.writeString(source.m_path);
+			writer.writeI64(source.m_modified);
+			writer.writeU64(source.m_size);
+			writer.writeU64(source.m_hash);
+		}
+		writer.endSection(section);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::vector<LevelSource> LevelFile::readSources(BinaryReader& reader)
+	{
+		if (reader.readU32() != m_magic)
+		{
+			throw std::runtime_error("GameSpace::LevelFile::readSources if (reader.readU32() != m_magic)");
+		}
+		if (reader.readU32() != m_version)
+		{
+			throw std::runtime_error("GameSpace::LevelFile::readSources if (reader.readU32() != m_version)");
+		}
+
+		BinaryReader section = reader.readSection(sourcesTag);
+		// путь, время, размер и хэш
+		std::vector<LevelSource> sources(readCount(section, sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t)));
+		for (auto& source : sources)
+		{
+			source.m_path = section.readString();
+			source.m_modified = section.readI64();
+			source.m_size = section.readU64();
+			source.m_hash = section.readU64();
+		}
+		return sources;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelFile::write(LevelData& level, const std::string& path)
+	{
+		using namespace std;
+
+		for (auto& source : level.m_sources)
+		{
+			if (!stamp(source.m_path, source))
+			{
+				throw runtime_error("GameSpace::LevelFile::write if (!stamp(source.m_path, source))");
+			}
+		}
+
+		BinaryWriter writer;
+		writeSources(writer, level.m_sources);
+
+		size_t section = writer.beginSection(mapTag);
+		writer.writeI32(level.m_width);
+		writer.writeI32(level.m_height);
+		writer.writeI32(level.m_tileWidth);
+		writer.writeI32(level.m_tileHeight);
+		const uint8_t color[4] = { level.m_bgColor.r, level.m_bgColor.g, level.m_bgColor.b, level.m_bgColor.a };
+		writer.writeBytes(color, sizeof(color));
+		writer.writeFloat(level.m_gravityX);
+		writer.writeFloat(level.m_gravityY);
+		writer.writeFloat(level.m_timeWarp);
+		writer.writeFloat(level.m_stepRate);
+		writer.writeFloat(level.m_friction);
+		writer.endSection(section);
+
+		section = writer.beginSection(imagesTag);
+		writer.writeU32(static_cast<uint32_t>(level.m_images.size()));
+		for (const auto& image : level.m_images)
+		{
+			writer.writeString(image);
+		}
+		writer.endSection(section);
+
+		section = writer.beginSection(tilesTag);
+		writer.writeU32(static_cast<uint32_t>(level.m_tiles.size()));
+		for (const auto& tile : level.m_tiles)
+		{
+			writer.writeU32(tile.first);
+			writer.writeU32(tile.second);
+		}
+		writer.endSection(section);
+
+		section = writer.beginSection(layersTag);
+		writer.writeU32(static_cast<uint32_t>(level.m_layers.size()));
+		for (const auto& layer : level.m_layers)
+		{
+			writer.writeU32(static_cast<uint32_t>(layer.m_kind));
+			writer.writeU32(layer.m_width);
+			writer.writeU32(layer.m_height);
+			writer.writeU32(layer.m_tileWidth);
+			writer.writeU32(layer.m_tileHeight);
+			writer.align(sizeof(uint32_t));
+			writer.writeBytes(layer.m_gids.data(), layer.m_gids.size() * sizeof(uint32_t));
+		}
+		writer.endSection(section);
+
+		section = writer.beginSection(objectsTag);
+		// строки и свойства пишутся общими таблицами, объекты ссылаются на них номерами
+		writer.writeU32(static_cast<uint32_t>(level.m_strings.size()));
+		for (const auto& value : level.m_strings)
+		{
+			writer.writeString(value);
+		}
+		writer.writeU32(static_cast<uint32_t>(level.m_properties.size()));
+		for (const auto& property : level.m_properties)
+		{
+			writer.writeU32(property.m_name);
+			writer.writeU32(static_cast<uint32_t>(property.m_type));
+			switch (property.m_type)
+			{
+			case LevelProperty::Type::PT_INT:
+				writer.writeI32(property.m_int);
+				break;
+			case LevelProperty::Type::PT_FLOAT:
+				writer.writeFloat(property.m_float);
+				break;
+			default:
+				writer.writeU32(property.m_string);
+				break;
+			}
+		}
+		writer.writeU32(static_cast<uint32_t>(level.m_objects.size()));
+		for (const auto& object : level.m_objects)
+		{
+			writer.writeU32(object.m_type);
+			writer.writeU32(object.m_gid);
+			writer.writeI32(object.m_x);
+			writer.writeI32(object.m_y);
+			writer.writeU32(object.m_firstProperty);
+			writer.writeU32(object.m_propertyCount);
+		}
+		writer.endSection(section);
+
+		section = writer.beginSection(playersTag);
+		writer.writeU32(static_cast<uint32_t>(level.m_players.size()));
+		for (const auto& itPlayer : level.m_players)
+		{
+			const PlayerData& player = itPlayer.second;
+			writer.writeString(itPlayer.first);
+			writer.writeFloat(player.m_density);
+			writer.writeFloat(player.m_friction);
+			writer.writeFloat(player.m_xvelocity);
+			writer.writeFloat(player.m_yvelocity);
+			writer.writeI32(player.m_lives);
+			writer.writeI32(player.m_winCoins);
+			writer.writeString(player.m_file);
+
+			writeRect(writer, player.m_animation.m_defaultFrame);
+			writer.writeI32(static_cast<int32_t>(player.m_animation.m_initState));
+			writer.writeU32(static_cast<uint32_t>(player.m_animation.m_states.size()));
+			for (const auto& state : player.m_animation.m_states)
+			{
+				writer.writeI32(static_cast<int32_t>(state.m_state));
+				writer.writeFloat(state.m_speed);
+				writer.writeU32(static_cast<uint32_t>(state.m_frames.size()));
+				for (const auto& frame : state.m_frames)
+				{
+					writeRect(writer, frame);
+				}
+			}
+
+			writer.writeString(player.m_hudFile);
+			writer.writeString(player.m_fontFile);
+			writer.writeI32(player.m_fontSize);
+			writeRect(writer, player.m_liveRect);
+			writeRect(writer, player.m_coinRect);
+			writer.writeString(player.m_stepSound);
+			writer.writeString(player.m_jumpSound);
+			writer.writeString(player.m_getLiveSound);
+			writer.writeString(player.m_getCoinSound);
+		}
+		writer.endSection(section);
+
+		// запись через временный файл, чтобы прерванная запись не оставила битый кэш
+		const string temporary(path + ".tmp");
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw runtime_error("GameSpace::LevelFile::write if (!file)");
+		}
+		const vector<uint8_t>& data = writer.getData();
+		const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+		if (fclose(file) != 0 || !written)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::LevelFile::write if (!written)");
+		}
+		remove(path.c_str());
+		if (rename(temporary.c_str(), path.c_str()) != 0)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::LevelFile::write if (rename(...) != 0)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	LevelData LevelFile::read(const std::string& path)
+	{
+		using namespace std;
+
+		const ResourcePtr file = Resources::open(path);
+		if (!file)
+		{
+			throw runtime_error("GameSpace::LevelFile::read if (!file)");
+		}
+		BinaryReader reader(file->getData(), file->getSize());
+
+		LevelData level;
+		level.m_sources = readSources(reader);
+
+		BinaryReader section = reader.readSection(mapTag);
+		level.m_width = section.readI32();
+		level.m_height = section.readI32();
+		level.m_tileWidth = section.readI32();
+		level.m_tileHeight = section.readI32();
+		uint8_t color[4];
+		section.readBytes(color, sizeof(color));
+		level.m_bgColor = sf::Color(color[0], color[1], color[2], color[3]);
+		level.m_gravityX = section.readFloat();
+		level.m_gravityY = section.readFloat();
+		level.m_timeWarp = section.readFloat();
+		level.m_stepRate = section.readFloat();
+		level.m_friction = section.readFloat();
+
+		section = reader.readSection(imagesTag);
+		level.m_images.resize(readCount(section, sizeof(uint32_t)));
+		for (auto& image : level.m_images)
+		{
+			image = section.readString();
+		}
+
+		section = reader.readSection(tilesTag);
+		for (uint32_t count = readCount(section, 2 * sizeof(uint32_t)); count; --count)
+		{
+			const uint32_t gid = section.readU32();
+			level.m_tiles[gid] = section.readU32();
+		}
+
+		section = reader.readSection(layersTag);
+		for (uint32_t count = section.readU32(); count; --count)
+		{
+			const TileLayer::Kind kind = static_cast<TileLayer::Kind>(section.readU32());
+			const uint32_t width = section.readU32();
+			const uint32_t height = section.readU32();
+			const uint32_t tileWidth = section.readU32();
+			const uint32_t tileHeight = section.readU32();
+			section.align(sizeof(uint32_t));
+			// слои рисуются и обходятся по размеру карты; размер проверяется в 64 битах,
+			// чтобы произведение не переполнилось в 32-битной сборке
+			if (width != static_cast<uint32_t>(level.m_width) || height != static_cast<uint32_t>(level.m_height) ||
+				static_cast<uint64_t>(width) * height > section.getRemaining() / sizeof(uint32_t))
+			{
+				throw runtime_error("GameSpace::LevelFile::read if (!layer.size)");
+			}
+			TileLayer layer(kind, width, height, tileWidth, tileHeight);
+			section.readBytes(layer.m_gids.data(), layer.m_gids.size() * sizeof(uint32_t));
+			level.m_layers.push_back(layer);
+		}
+
+		section = reader.readSection(objectsTag);
+		level.m_strings.resize(readCount(section, sizeof(uint32_t)));
+		for (auto& value : level.m_strings)
+		{
+			value = section.readString();
+		}
+		const uint32_t stringCount = static_cast<uint32_t>(level.m_strings.size());
+		// имя, вид и значение
+		level.m_properties.resize(readCount(section, 3 * sizeof(uint32_t)));
+		for (auto& property : level.m_properties)
+		{
+			property.m_name = section.readU32();
+			property.m_type = static_cast<LevelProperty::Type>(section.readU32());
+			switch (property.m_type)
+			{
+			case LevelProperty::Type::PT_INT:
+				property.m_int = section.readI32();
+				break;
+			case LevelProperty::Type::PT_FLOAT:
+				property.m_float = section.readFloat();
+				break;
+			case LevelProperty::Type::PT_STRING:
+				property.m_string = section.readU32();
+				if (property.m_string >= stringCount)
+				{
+					throw runtime_error("GameSpace::LevelFile::read if (property.m_string >= stringCount)");
+				}
+				break;
+			default:
+				throw runtime_error("GameSpace::LevelFile::read if (!property.m_type)");
+			}
+			if (property.m_name >= stringCount)
+			{
+				throw runtime_error("GameSpace::LevelFile::read if (property.m_name >= stringCount)");
+			}
+		}
+		level.m_objects.resize(readCount(section, 6 * sizeof(uint32_t)));
+		for (auto& object : level.m_objects)
+		{
+			object.m_type = section.readU32();
+			object.m_gid = section.readU32();
+			object.m_x = section.readI32();
+			object.m_y = section.readI32();
+			object.m_firstProperty = section.readU32();
+			object.m_propertyCount = section.readU32();
+			if (object.m_type >= stringCount || object.m_firstProperty > level.m_properties.size() ||
+				object.m_propertyCount > level.m_properties.size() - object.m_firstProperty)
+			{
+				throw runtime_error("GameSpace::LevelFile::read if (!object)");
+			}
+		}
+
+		section = reader.readSection(playersTag);
+		for (uint32_t count = section.readU32(); count; --count)
+		{
+			const string config(section.readString());
+			PlayerData player;
+			player.m_density = section.readFloat();
+			player.m_friction = section.readFloat();
+			player.m_xvelocity = section.readFloat();
+			player.m_yvelocity = section.readFloat();
+			player.m_lives = section.readI32();
+			player.m_winCoins = section.readI32();
+			player.m_file = section.readString();
+
+			player.m_animation.m_defaultFrame = readRect(section);
+			player.m_animation.m_initState = static_cast<Animation::MoveState>(section.readI32());
+			// вид, скорость и число кадров
+			player.m_animation.m_states.resize(readCount(section, 3 * sizeof(uint32_t)));
+			for (auto& state : player.m_animation.m_states)
+			{
+				state.m_state = static_cast<Animation::MoveState>(section.readI32());
+				state.m_speed = section.readFloat();
+				state.m_frames.resize(readCount(section, 4 * sizeof(int32_t)));
+				for (auto& frame : state.m_frames)
+				{
+					frame = readRect(section);
+				}
+			}
+
+			player.m_hudFile = section.readString();
+			player.m_fontFile = section.readString();
+			player.m_fontSize = section.readI32();
+			player.m_liveRect = readRect(section);
+			player.m_coinRect = readRect(section);
+			player.m_stepSound = section.readString();
+			player.m_jumpSound = section.readString();
+			player.m_getLiveSound = section.readString();
+			player.m_getCoinSound = section.readString();
+			level.m_players.insert(make_pair(config, player));
+		}
+
+		return level;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool LevelFile::isCurrent(const std::string& path)
+	{
+		bool restamp = false;
+		return isCurrent(path, restamp);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool LevelFile::isCurrent(const std::string& path, bool& restamp)
+	{
+		restamp = false;
+		std::vector<LevelSource> sources;
+		{
+			const ResourcePtr file = Resources::open(path);
+			if (!file)
+			{
+				return false;
+			}
+			try
+			{
+				BinaryReader reader(file->getData(), file->getSize());
+				sources = readSources(reader);
+			}
+			catch (const std::exception&)
+			{	// старая версия или поврежденный файл
+				return false;
+			}
+		}
+
+		// время изменения хранится в секундах: исходный файл, сохраненный в ту же секунду,
+		// что и скомпилированный, мог измениться после отметки, и сверяется по хэшу
+		std::int64_t compiled = 0;
+		Resources::getModifiedTime(path, compiled);
+		for (const auto& source : sources)
+		{
+			std::int64_t modified = 0;
+			{
+				const ResourcePtr file = Resources::open(source.m_path);
+				if (!file || !Resources::getModifiedTime(source.m_path, modified) || file->getSize() != source.m_size)
+				{
+					return false;
+				}
+			}
+			if (modified == source.m_modified && modified < compiled)
+			{	// файл не трогали, содержимое не читается
+				continue;
+			}
+			LevelSource actual;
+			if (!stamp(source.m_path, actual) || actual.m_hash != source.m_hash)
+			{
+				return false;
+			}
+			// содержимое прежнее, но без новой отметки файл хэшировался бы при каждой загрузке
+			restamp = true;
+		}
+		return !sources.empty();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	LevelData LevelFile::load(const std::string& source)
+	{
+		using namespace std;
+
+		sf::Clock clock;
+		const string compiled(getCompiledPath(source));
+		bool restamp = false;
+		if (isCurrent(compiled, restamp))
+		{
+			try
+			{
+				LevelData level(read(compiled));
+				if (restamp)
+				{
+					try
+					{
+						write(level, compiled);
+					}
+					catch (const exception& error)
+					{	// уровень прочитан, отметки обновятся при следующей загрузке
+						cerr << "Level: " << compiled << " not restamped (" << error.what() << ")" << endl;
+					}
+				}
+				if (Diagnostics::isEnabled())
+				{
+					cout << "Level: " << compiled << " read in " << clock.getElapsedTime().asMilliseconds() << " ms" << endl;
+				}
+				return level;
+			}
+			catch (const exception& error)
+			{
+				cerr << "Level: " << compiled << " is broken (" << error.what() << "), recompiling" << endl;
+			}
+		}
+
+		LevelData level(TmxReader::read(source));
+		try
+		{
+			write(level, compiled);
+			if (Diagnostics::isEnabled())
+			{
+				cout << "Level: " << source << " compiled to " << compiled << " in " << clock.getElapsedTime().asMilliseconds() << " ms" << endl;
+			}
+		}
+		catch (const exception& error)
+		{	// без кэша уровень все равно загружается
+			cerr << "Level: " << compiled << " not written (" << error.what() << ")" << endl;
+		}
+		return level;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef LEVELFILE_H
+#define LEVELFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <iostream>
+
+#include "leveldata.h"
+#include "binarystream.h"
+#include "mappedfile.h"
+#include "resources.h"
+#include "tmxreader.h"
+#include "diagnostics.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	скомпилированный уровень (.wwl)
+				заголовок, таблица исходных файлов, параметры карты, таблица изображений,
+				номера тайлов слоев, объекты с типизированными свойствами и описания игроков,
+				строки и свойства объектов хранятся общими таблицами без повторов
+				файл читается через отображение в память, без разбора XML
+	*/
+	class LevelFile final
+	{
+		static const std::uint32_t m_magic;
+		static const std::uint32_t m_version;
+
+		/*
+			@brief пишет таблицу исходных файлов
+		*/
+		static void writeSources(BinaryWriter& writer, const std::vector<LevelSource>& sources);
+		/*
+			@brief читает заголовок и таблицу исходных файлов
+		*/
+		static std::vector<LevelSource> readSources(BinaryReader& reader);
+	public:
+		/*
+			@brief путь скомпилированного файла рядом с исходным
+			@param source путь к tmx файлу
+		*/
+		static std::string getCompiledPath(const std::string& source);
+		/*
+			@brief снимает отметку файла: время изменения, размер и хэш содержимого
+			@param path путь к файлу
+			@param result отметка
+			@ret   удалось ли прочитать файл
+		*/
+		static bool stamp(const std::string& path, LevelSource& result);
+		/*
+			@brief записывает уровень, для исходных файлов снимаются отметки
+			@param level уровень
+			@param path путь к результату, запись идет через временный файл
+		*/
+		static void write(LevelData& level, const std::string& path);
+		/*
+			@brief читает скомпилированный уровень
+			@param path путь к файлу
+			@ret   уровень
+		*/
+		static LevelData read(const std::string& path);
+		/*
+			@brief	совпадают ли отметки исходных файлов с записанными в скомпилированный файл
+					сначала сравниваются время изменения и размер, содержимое хэшируется,
+					только если время изменилось при том же размере или совпадает
+					со временем записи скомпилированного файла
+			@param path путь к скомпилированному файлу
+		*/
+		static bool isCurrent(const std::string& path);
+		/*
+			@brief	то же, что isCurrent, и сообщает, что отметки устарели
+			@param path путь к скомпилированному файлу
+			@param restamp содержимое исходных файлов прежнее, но их время изменилось,
+					отметки стоит переписать, чтобы следующая проверка обошлась без хэша
+		*/
+		static bool isCurrent(const std::string& path, bool& restamp);
+		/*
+			@brief	загружает уровень из кэша рядом с tmx файлом
+					при отсутствии кэша или изменении исходных файлов
+					уровень читается из tmx и кэш пересобирается
+			@param source путь к tmx файлу
+			@ret   уровень
+		*/
+		static LevelData load(const std::string& source);
+	};
+}
+
+#endif // !LEVELFILE_H
\ No newline at end of file
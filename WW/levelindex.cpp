@@ -0,0 +1,107 @@
+#include "levelindex.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t LevelIndex::m_magic = 0x494C5757;	// "WWLI"
+	const std::uint32_t LevelIndex::m_version = 1;
+	//////////////////////////////////////////////////////////////////////////
+	LevelIndex::Entry LevelIndex::build(const std::string& levelFile, const std::string& image)
+	{
+		const LevelData level(LevelFile::load(levelFile));
+		sf::Image thumbnail;
+		if (!Resources::load(thumbnail, image))
+		{
+			throw std::runtime_error("GameSpace::LevelIndex::build if (!Resources::load(thumbnail, image))");
+		}
+
+		Entry entry;
+		entry.m_levelFile = levelFile;
+		entry.m_image = image;
+		entry.m_imageWidth = thumbnail.getSize().x;
+		entry.m_imageHeight = thumbnail.getSize().y;
+		entry.m_width = level.m_width;
+		entry.m_height = level.m_height;
+		entry.m_objectCount = static_cast<std::uint32_t>(level.m_objects.size());
+		return entry;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelIndex::write(const std::vector<Entry>& entries, const std::string& path)
+	{
+		using namespace std;
+
+		BinaryWriter writer;
+		writer.writeU32(m_magic);
+		writer.writeU32(m_version);
+		writer.writeU32(static_cast<uint32_t>(entries.size()));
+		for (const auto& entry : entries)
+		{
+			writer.writeString(entry.m_levelFile);
+			writer.writeString(entry.m_image);
+			writer.writeU32(entry.m_imageWidth);
+			writer.writeU32(entry.m_imageHeight);
+			writer.writeI32(entry.m_width);
+			writer.writeI32(entry.m_height);
+			writer.writeU32(entry.m_objectCount);
+		}
+
+		const string temporary(path + ".tmp");
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw runtime_error("GameSpace::LevelIndex::write if (!file)");
+		}
+		const vector<uint8_t>& data = writer.getData();
+		const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+		if (fclose(file) != 0 || !written)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::LevelIndex::write if (!written)");
+		}
+		remove(path.c_str());
+		if (rename(temporary.c_str(), path.c_str()) != 0)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::LevelIndex::write if (rename(...) != 0)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::vector<LevelIndex::Entry> LevelIndex::read(const std::string& path)
+	{
+		const ResourcePtr file = Resources::open(path);
+		if (!file)
+		{
+			throw std::runtime_error("GameSpace::LevelIndex::read if (!file)");
+		}
+		BinaryReader reader(file->getData(), file->getSize());
+		if (reader.readU32() != m_magic)
+		{
+			throw std::runtime_error("GameSpace::LevelIndex::read if (reader.readU32() != m_magic)");
+		}
+		if (reader.readU32() != m_version)
+		{
+			throw std::runtime_error("GameSpace::LevelIndex::read if (reader.readU32() != m_version)");
+		}
+
+		// запись: две строки и пять чисел, строка - хотя бы ее длина
+		const std::uint32_t count = reader.readU32();
+		const size_t entrySize = 7 * sizeof(std::uint32_t);
+		if (count > reader.getRemaining() / entrySize)
+		{
+			throw std::runtime_error("GameSpace::LevelIndex::read if (count > reader.getRemaining() / entrySize)");
+		}
+		std::vector<Entry> entries(count);
+		for (auto& entry : entries)
+		{
+			entry.m_levelFile = reader.readString();
+			entry.m_image = reader.readString();
+			entry.m_imageWidth = reader.readU32();
+			entry.m_imageHeight = reader.readU32();
+			entry.m_width = reader.readI32();
+			entry.m_height = reader.readI32();
+			entry.m_objectCount = reader.readU32();
+		}
+		return entries;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef LEVELINDEX_H
+#define LEVELINDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+
+#include "binarystream.h"
+#include "resources.h"
+#include "levelfile.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	оглавление уровней (.wwi) для экрана выбора уровня
+				собирается заранее (wwlc -i), чтобы при запуске не открывать
+				файлы уровней и миниатюр ради размеров и числа объектов
+	*/
+	class LevelIndex final
+	{
+		static const std::uint32_t m_magic;
+		static const std::uint32_t m_version;
+
+		LevelIndex() = delete;
+	public:
+		// @brief описание одного уровня
+		struct Entry
+		{
+			std::string m_levelFile;		// как в config.xml
+			std::string m_image;			// миниатюра
+			std::uint32_t m_imageWidth;		// размер миниатюры в пикселях
+			std::uint32_t m_imageHeight;
+			std::int32_t m_width;			// размер карты в тайлах
+			std::int32_t m_height;
+			std::uint32_t m_objectCount;
+		};
+		/*
+			@brief	собирает описание уровня: читает уровень и декодирует миниатюру
+			@param levelFile файл уровня
+			@param image миниатюра
+		*/
+		static Entry build(const std::string& levelFile, const std::string& image);
+		/*
+			@brief записывает оглавление через временный файл
+			@param entries описания уровней
+			@param path путь к результату
+		*/
+		static void write(const std::vector<Entry>& entries, const std::string& path);
+		/*
+			@brief	читает оглавление через Resources, поэтому оно может лежать в архиве
+					при отсутствии или повреждении файла бросает исключение
+			@param path путь к файлу
+		*/
+		static std::vector<Entry> read(const std::string& path);
+	};
+}
+
+#endif // !LEVELINDEX_H
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "levelloader.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		/*
+			@brief	понижает приоритет текущего потока
+					в Linux nice действует на поток и наследуется созданными им потоками,
+					а вернуть его без прав нельзя, поэтому понижается только
+					отдельный поток, который сам потоков не создает
+		*/
+		void setLowPriority()
+		{
+#ifdef _WIN32
+			SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+			setpriority(PRIO_PROCESS, 0, 10);
+#endif
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	LevelLoader::LevelLoader(const std::string& path, AssetCache& cache)
+		: m_path(path), m_cache(cache), m_cancel(false), m_ready(false), m_background(false), m_done(0), m_total(1)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	LevelLoader::~LevelLoader()
+	{
+		cancel();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::vector<LevelLoader::Asset> LevelLoader::collectAssets(Result& result)
+	{
+		std::vector<Asset> assets;
+
+		// изображения игроков уже входят в m_images уровня
+		const auto& images = result.m_level->m_images;
+		result.m_images.resize(images.size());
+		for (size_t i = 0; i < images.size(); ++i)
+		{
+			result.m_images[i].first = images[i];
+			assets.push_back(Asset{ Asset::Kind::AK_IMAGE, images[i], i });
+		}
+
+		// шрифт и звуки могут быть общими у нескольких игроков
+		std::set<std::string> fonts;
+		std::set<std::string> sounds;
+		for (const auto& player : result.m_level->m_players)
+		{
+			const PlayerData& data = player.second;
+			fonts.insert(data.m_fontFile);
+			sounds.insert(data.m_stepSound);
+			sounds.insert(data.m_jumpSound);
+			sounds.insert(data.m_getLiveSound);
+			sounds.insert(data.m_getCoinSound);
+		}
+		for (const auto& file : fonts)
+		{
+			result.m_fonts[file] = nullptr;
+			assets.push_back(Asset{ Asset::Kind::AK_FONT, file, 0 });
+		}
+		for (const auto& file : sounds)
+		{
+			result.m_sounds[file] = nullptr;
+			assets.push_back(Asset{ Asset::Kind::AK_SOUND, file, 0 });
+		}
+		return assets;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelLoader::decodeAsset(const Asset& asset, AssetCache& cache, Result& result)
+	{
+		// ключи заведены заранее, меняются только значения
+		switch (asset.m_kind)
+		{
+		case Asset::Kind::AK_IMAGE:
+			result.m_images[asset.m_index].second = cache.getImage(asset.m_file);
+			break;
+		case Asset::Kind::AK_FONT:
+			result.m_fonts.find(asset.m_file)->second = cache.getFont(asset.m_file);
+			break;
+		case Asset::Kind::AK_SOUND:
+			result.m_sounds.find(asset.m_file)->second = cache.getSound(asset.m_file);
+			break;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelLoader::prepare()
+	{
+		using namespace std;
+		const bool background = m_background;
+		try
+		{
+			sf::Clock clock;
+			unique_ptr<Result> result(new Result);
+			vector<Asset> assets;
+			size_t next = 0;
+			sf::Time parseTime, collectTime;
+			auto prefetch = [&]()
+			{
+				result->m_level = m_cache.getLevel(m_path);
+				parseTime = clock.restart();
+
+				assets = collectAssets(*result);
+				m_total = assets.size() + 1;
+				++m_done;
+				collectTime = clock.restart();
+
+				// упреждающая загрузка декодирует по одному ресурсу, пока ее не затребуют
+				while (next < assets.size() && m_background && !m_cancel)
+				{
+					decodeAsset(assets[next++], m_cache, *result);
+					++m_done;
+				}
+			};
+			if (background)
+			{	// сам поток подготовки остается с обычным приоритетом,
+				// чтобы его не унаследовали потоки WorkerPool после promote
+				exception_ptr error;
+				thread low([&]()
+				{
+					setLowPriority();
+					try
+					{
+						prefetch();
+					}
+					catch (...)
+					{
+						error = current_exception();
+					}
+				});
+				low.join();
+				if (error)
+				{
+					rethrow_exception(error);
+				}
+			}
+			else
+			{
+				prefetch();
+			}
+			unsigned threads = 1;
+			if (next < assets.size())
+			{
+				threads = WorkerPool::forEach(assets.size() - next, [&](size_t i)
+				{
+					decodeAsset(assets[next + i], m_cache, *result);
+					++m_done;
+				}, &m_cancel);
+			}
+			const sf::Time decodeTime = clock.restart();
+
+			if (Diagnostics::isEnabled())
+			{
+				cout	<< "Load stages: parse " << parseTime.asMilliseconds() << " ms, collect "
+						<< collectTime.asMilliseconds() << " ms, decode " << decodeTime.asMilliseconds()
+						<< " ms (" << assets.size() << " assets, " << threads << " threads"
+						<< (background ? ", prefetch" : "") << ")" << endl;
+			}
+			if (!m_cancel)
+			{
+				m_result = move(result);
+			}
+		}
+		catch (...)
+		{
+			m_error = std::current_exception();
+		}
+		m_ready = true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelLoader::start(bool background)
+	{
+		assert(!m_thread.joinable());
+		m_background = background;
+		m_thread = std::thread(&LevelLoader::prepare, this);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelLoader::promote()
+	{
+		m_background = false;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool LevelLoader::isBackground() const
+	{
+		return m_background;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::string& LevelLoader::getPath() const
+	{
+		return m_path;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void LevelLoader::cancel()
+	{
+		m_cancel = true;
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool LevelLoader::isReady() const
+	{
+		return m_ready;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::unique_ptr<LevelLoader::Result> LevelLoader::takeResult()
+	{
+		assert(m_ready);
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+		if (m_error)
+		{
+			std::rethrow_exception(m_error);
+		}
+		return std::move(m_result);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	float LevelLoader::getProgress() const
+	{
+		return static_cast<float>(m_done) / m_total;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::unique_ptr<LevelLoader::Result> LevelLoader::load(const std::string& path, AssetCache& cache)
+	{
+		LevelLoader loader(path, cache);
+		loader.prepare();
+		return loader.takeResult();
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
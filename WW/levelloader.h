@@ -0,0 +1,142 @@
+#ifndef LEVELLOADER_H
+#define LEVELLOADER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <iostream>
+#include <cassert>
+
+#include <SFML/Graphics.hpp>
+
+#include "leveldata.h"
+#include "assetcache.h"
+#include "workerpool.h"
+#include "diagnostics.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	подготовка уровня в фоновом потоке
+				читает уровень (из кэша или tmx), собирает ссылки на все его ресурсы
+				и получает изображения, шрифты и звуки из AssetCache на WorkerPool,
+				работа с OpenGL и Box2D остается основному потоку
+				в фоновом режиме (упреждающая загрузка) отдельный поток с пониженным
+				приоритетом декодирует ресурсы сам, не занимая WorkerPool
+	*/
+	class LevelLoader final
+	{
+	public:
+		// @brief подготовленный уровень
+		struct Result
+		{
+			LevelPtr m_level;
+			std::vector<std::pair<std::string, ImagePtr>> m_images;	// в порядке m_level->m_images
+			std::map<std::string, FontPtr> m_fonts;
+			std::map<std::string, SoundBufferPtr> m_sounds;
+		};
+	private:
+		// @brief ресурс, который декодируется одним заданием
+		struct Asset
+		{
+			enum class Kind
+			{
+				AK_IMAGE,
+				AK_FONT,
+				AK_SOUND
+			};
+			Kind m_kind;
+			std::string m_file;
+			size_t m_index;		// для изображений - индекс в Result::m_images
+		};
+
+		std::string m_path;
+		AssetCache& m_cache;
+		std::thread m_thread;
+		std::atomic<bool> m_cancel;
+		std::atomic<bool> m_ready;
+		std::atomic<bool> m_background;	// упреждающая загрузка, пока ее не затребовали
+		std::atomic<size_t> m_done;		// выполнено шагов: чтение уровня и по одному на ресурс
+		std::atomic<size_t> m_total;
+		std::unique_ptr<Result> m_result;
+		std::exception_ptr m_error;
+
+		LevelLoader(const LevelLoader&) = delete;
+		LevelLoader& operator=(const LevelLoader&) = delete;
+		/*
+			@brief	собирает ресурсы уровня и заводит для них места в результате,
+					чтобы задания декодирования не меняли общие контейнеры
+			@param result результат с прочитанным уровнем
+			@ret   список заданий
+		*/
+		static std::vector<Asset> collectAssets(Result& result);
+		/*
+			@brief получает ресурс из кэша в заведенное для него место
+		*/
+		static void decodeAsset(const Asset& asset, AssetCache& cache, Result& result);
+		/*
+			@brief выполняет подготовку, при отмене прекращает работу между ресурсами
+		*/
+		void prepare();
+	public:
+		/*
+			@param path путь к tmx файлу
+			@param cache кэш, через который читаются уровень и ресурсы
+		*/
+		LevelLoader(const std::string& path, AssetCache& cache);
+		/*
+			@brief отменяет незавершенную подготовку и ждет поток
+		*/
+		~LevelLoader();
+		/*
+			@brief запускает подготовку в фоновом потоке
+			@param background упреждающая загрузка: низкий приоритет и один поток
+		*/
+		void start(bool background = false);
+		/*
+			@brief	уровень затребован игроком: оставшиеся ресурсы
+					декодируются на WorkerPool с обычным приоритетом
+		*/
+		void promote();
+		/*
+			@brief запущена ли подготовка в фоновом режиме и не затребована ли еще
+		*/
+		bool isBackground() const;
+		/*
+			@brief путь к подготавливаемому уровню
+		*/
+		const std::string& getPath() const;
+		/*
+			@brief прерывает подготовку и дожидается остановки потока
+		*/
+		void cancel();
+		/*
+			@brief завершена ли подготовка (успешно или с ошибкой)
+		*/
+		bool isReady() const;
+		/*
+			@brief	забирает результат после isReady
+					ошибка фонового потока бросается здесь
+		*/
+		std::unique_ptr<Result> takeResult();
+		/*
+			@brief доля выполненной работы от 0 до 1
+		*/
+		float getProgress() const;
+		/*
+			@brief подготавливает уровень в текущем потоке
+			@param path путь к tmx файлу
+			@param cache кэш ресурсов
+		*/
+		static std::unique_ptr<Result> load(const std::string& path, AssetCache& cache);
+	};
+}
+
+#endif // !LEVELLOADER_H
\ No newline at end of file
@@ -3,12 +3,16 @@
 
 #include "config.h"
 #include "core.h"
+#include "resources.h"
 
 int main(int argc, char* argv[])
 {
 	const char* configFileName = "config.xml";
+	const char* packFileName = "Resources.pak";
 	try
 	{
+		// без архива ресурсы читаются из отдельных файлов
+		GameSpace::Resources::mount(packFileName);
 		GameSpace::Config config(configFileName);
 		GameSpace::GameCore core(&config);
 		core.runGameLoop();
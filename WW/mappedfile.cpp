@@ -0,0 +1,159 @@
+#include "mappedfile.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+	MappedFile::MappedFile()
+		: m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+	{
+
+	}
+#else
+	MappedFile::MappedFile()
+		: m_data(nullptr), m_size(0), m_file(-1)
+	{
+
+	}
+#endif
+	//////////////////////////////////////////////////////////////////////////
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+#ifdef _WIN32
+		m_file = CreateFileA(	path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size))
+		{
+			close();
+			return false;
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+		if (m_size == 0)
+		{	// пустой файл отобразить нельзя, но он корректен
+			return true;
+		}
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping)
+		{
+			close();
+			return false;
+		}
+		m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		m_file = ::open(path.c_str(), O_RDONLY);
+		if (m_file < 0)
+		{
+			return false;
+		}
+		struct stat info;
+		if (fstat(m_file, &info) != 0)
+		{
+			close();
+			return false;
+		}
+		m_size = static_cast<size_t>(info.st_size);
+		if (m_size == 0)
+		{	// пустой файл отобразить нельзя, но он корректен
+			return true;
+		}
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+		m_data = (data == MAP_FAILED) ? nullptr : static_cast<const std::uint8_t*>(data);
+#endif
+		if (!m_data)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping)
+		{
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+		}
+		if (m_file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_file);
+			m_file = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (m_data)
+		{
+			munmap(const_cast<std::uint8_t*>(m_data), m_size);
+		}
+		if (m_file >= 0)
+		{
+			::close(m_file);
+			m_file = -1;
+		}
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint8_t* MappedFile::getData() const
+	{
+		return m_data;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t MappedFile::getSize() const
+	{
+		return m_size;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool MappedFile::getModifiedTime(const std::string& path, std::int64_t& result)
+	{
+#ifdef _WIN32
+		struct _stat64 info;
+		if (_stat64(path.c_str(), &info) != 0)
+		{
+			return false;
+		}
+#else
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0)
+		{
+			return false;
+		}
+#endif
+		result = static_cast<std::int64_t>(info.st_mtime);
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+namespace GameSpace
+{
+	/*
+		@brief	файл, отображенный в память только для чтения
+				данные доступны без копирования, пока объект жив
+	*/
+	class MappedFile final
+	{
+		const std::uint8_t* m_data;
+		size_t m_size;
+#ifdef _WIN32
+		void* m_file;
+		void* m_mapping;
+#else
+		int m_file;
+#endif
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+	public:
+		MappedFile();
+		~MappedFile();
+		/*
+			@brief отображает файл, предыдущий файл закрывается
+			@param path путь к файлу
+			@ret   удалось ли открыть файл
+		*/
+		bool open(const std::string& path);
+		/*
+			@brief закрывает отображение
+		*/
+		void close();
+		/*
+			@brief данные файла, nullptr для пустого или закрытого файла
+		*/
+		const std::uint8_t* getData() const;
+		/*
+			@brief размер файла в байтах
+		*/
+		size_t getSize() const;
+		/*
+			@brief время последнего изменения файла
+			@param path путь к файлу
+			@param result секунды от начала эпохи
+			@ret   существует ли файл
+		*/
+		static bool getModifiedTime(const std::string& path, std::int64_t& result);
+	};
+}
+
+#endif // !MAPPEDFILE_H
\ No newline at end of file
@@ -3,24 +3,13 @@
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
-	PlayerSound::PlayerSound(	const std::string& walkFile, const std::string& jumpFile,
-								const std::string& getLiveFile, const std::string& getCoinFile	)
+	PlayerSound::PlayerSound(	const SoundBufferPtr& walk, const SoundBufferPtr& jump,
+								const SoundBufferPtr& getLive, const SoundBufferPtr& getCoin	)
+		:	m_walkSound(walk), m_jumpSound(jump), m_getLiveSound(getLive), m_getCoinSound(getCoin)
 	{
-		if (!m_walkSound.loadFromFile(walkFile))
+		if (!m_walkSound || !m_jumpSound || !m_getLiveSound || !m_getCoinSound)
 		{
-			throw std::runtime_error("GameSpace::PlayerSound::PlayerSound if (!m_walkSound.loadFromFile(walkFile))");
-		}
-		if (!m_jumpSound.loadFromFile(jumpFile))
-		{
-			throw std::runtime_error("GameSpace::PlayerSound::PlayerSound if (!m_jumpSound.loadFromFile(jumpFile))");
-		}
-		if (!m_getLiveSound.loadFromFile(getLiveFile))
-		{
-			throw std::runtime_error("GameSpace::PlayerSound::PlayerSound if (!m_getLiveSound.loadFromFile(getLiveFile))");
-		}
-		if (!m_getCoinSound.loadFromFile(getCoinFile))
-		{
-			throw std::runtime_error("GameSpace::PlayerSound::PlayerSound if (!m_getCoinSound.loadFromFile(getCoinFile))");
+			throw std::runtime_error("GameSpace::PlayerSound::PlayerSound if (!m_walkSound || !m_jumpSound || !m_getLiveSound || !m_getCoinSound)");
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
@@ -34,24 +23,24 @@ namespace GameSpace
 	void PlayerSound::walk()
 	{
 		if (m_soundPlayer.getStatus() != sf::SoundSource::Playing)
-		{	//    
-			playBuffer(m_walkSound);
+		{	// подождать завершения звукового сопровождения
+			playBuffer(*m_walkSound);
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void PlayerSound::jump()
 	{
-		playBuffer(m_jumpSound);
+		playBuffer(*m_jumpSound);
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void PlayerSound::getLive()
 	{
-		playBuffer(m_getLiveSound);
+		playBuffer(*m_getLiveSound);
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void PlayerSound::getCoin()
 	{
-		playBuffer(m_getCoinSound);
+		playBuffer(*m_getCoinSound);
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void GameSound::setMusic(GameState state, const std::string& music)
@@ -74,9 +63,10 @@ namespace GameSpace
 		const auto itMusic = m_playList.find(state);
 		if (itMusic != m_playList.end())
 		{
-			if (!m_musicPlayer.openFromFile(itMusic->second))
+			m_musicData = Resources::open(itMusic->second);
+			if (!m_musicData || !m_musicPlayer.openFromMemory(m_musicData->getData(), m_musicData->getSize()))
 			{
-				throw std::runtime_error("GameSpace::GameSound::play if (!m_musicPlayer.openFromFile(itMusic->second))");
+				throw std::runtime_error("GameSpace::GameSound::play if (!m_musicPlayer.openFromMemory(...))");
 			}
 			m_musicPlayer.setLoop(true);
 			m_musicPlayer.play();
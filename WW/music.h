@@ -5,43 +5,51 @@
 #include <stdexcept>
 #include <map>
 #include <list>
+#include <memory>
 
 #include <SFML/Audio.hpp>
 
 #include "config.h"
+#include "resources.h"
 
 namespace GameSpace
 {
+	// @brief звуковой буфер, разделяемый копиями PlayerSound
+	typedef std::shared_ptr<const sf::SoundBuffer> SoundBufferPtr;
+
 	class PlayerSound final
 	{
-		sf::SoundBuffer m_walkSound;
-		sf::SoundBuffer m_jumpSound;
-		sf::SoundBuffer m_getLiveSound;
-		sf::SoundBuffer m_getCoinSound;
+		SoundBufferPtr m_walkSound;
+		SoundBufferPtr m_jumpSound;
+		SoundBufferPtr m_getLiveSound;
+		SoundBufferPtr m_getCoinSound;
 
 		sf::Sound m_soundPlayer;
 
 		void playBuffer(const sf::SoundBuffer& buffer);
 	public:
-		PlayerSound(const std::string& walkFile, const std::string& jumpFile,
-					const std::string& getLiveFile, const std::string& getCoinFile);
+		/*
+			@brief создает озвучку из загруженных буферов
+		*/
+		PlayerSound(const SoundBufferPtr& walk, const SoundBufferPtr& jump,
+					const SoundBufferPtr& getLive, const SoundBufferPtr& getCoin);
 		PlayerSound(const PlayerSound& other) = default;
 		PlayerSound& operator=(const PlayerSound& other) = default;
 
 		/*
-			@brief  
+			@brief озвучка шага
 		*/
 		void walk();
 		/*
-			@brief  
+			@brief озвучка прыжка
 		*/
 		void jump();
 		/*
-		@brief   
+		@brief озвучка подбора жизни
 		*/
 		void getLive();
 		/*
-			@brief   
+			@brief озвучка подбора монетки
 		*/
 		void getCoin();
 
@@ -54,6 +62,7 @@ namespace GameSpace
 	{
 		std::map<GameState, std::string> m_playList;
 
+		ResourcePtr m_musicData;	// sf::Music читает поток во время проигрывания
 		sf::Music m_musicPlayer;
 	public:
 		void setMusic(GameState state, const std::string& music);
@@ -3,76 +3,71 @@
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
-	sf::Texture& Object::getTexture()
+	const sf::Texture& Object::getTexture() const
 	{
-		return m_texture;
+		return *m_texture;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	sf::Sprite& Object::getSprite()
+	EntityStore& Object::getEntities() const
 	{
-		return m_sprite;
+		return m_entities;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	Object::Object(	const sf::Image& source, int centerX, int centerY, 
+	void Object::enableBehaviour()
+	{
+		m_entities.setBehaviour(m_entity, this);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	Object::Object(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, 
 					int frameX, int frameY, int frameWidth, int frameHeight)
+		: m_entities(entities), m_entity(0), m_texture(texture)
 	{
-		if (!m_texture.loadFromImage(source))
+		if (!m_texture)
 		{
-			throw std::runtime_error("GameSpace::Object::Object if (!m_texture.loadFromImage(source))");
+			throw std::runtime_error("GameSpace::Object::Object if (!m_texture)");
 		}
-		m_sprite.setTexture(m_texture);
-		m_sprite.setTextureRect(sf::IntRect(frameX, frameY, frameWidth, frameHeight));
-		m_sprite.setOrigin(frameWidth / 2.0f, frameHeight / 2.0f);
-		m_sprite.setPosition(static_cast<float>(centerX), static_cast<float>(centerY));
+		m_entity = m_entities.create(	*m_texture, sf::IntRect(frameX, frameY, frameWidth, frameHeight),
+										sf::Vector2f(static_cast<float>(centerX), static_cast<float>(centerY)));
 	}
 	//////////////////////////////////////////////////////////////////////////
-	Object::Object(const Object& other)
-		:	m_texture(other.m_texture),
-			m_sprite(other.m_sprite)
+	Object::~Object()
 	{
-		m_sprite.setTexture(m_texture);
+		m_entities.destroy(m_entity);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	Object& Object::operator=(const Object& other)
+	EntityStore::Entity Object::getEntity() const
 	{
-		if (this != &other)
-		{
-			m_texture = other.m_texture;
-			m_sprite = other.m_sprite;
-			m_sprite.setTexture(m_texture);
-		}
-		return *this;
-	}
-	//////////////////////////////////////////////////////////////////////////
-	void Object::draw(sf::RenderWindow& render)
-	{
-		//  
-		render.draw(m_sprite);
+		return m_entity;
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void Object::animate(float delta)
 	{
-		//  
+		// обработка анимации
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void Object::logic(float delta)
 	{
-		//  
+		// обработка управления
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void Object::effect(int live, int coin)
 	{
-		//   
+		// обработка события эффекта
 	}
 	//////////////////////////////////////////////////////////////////////////
 	bool Object::destroy()
 	{
-		return false;	//     
+		return false;	// по умолчанию объект не уничтожается
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Object::wake(float sleptTime)
+	{
+		// объекту без наверстывания нечего делать
 	}
 	//////////////////////////////////////////////////////////////////////////
 	b2Body*& PhysicObject::getBody()
 	{
-		return m_body;
+		return getEntities().getBody(getEntity());
 	}
 	//////////////////////////////////////////////////////////////////////////
 	const double PhysicObject::DEGTORAD = 0.0174532925199432957;
@@ -91,9 +86,8 @@ namespace GameSpace
 	}
 	//////////////////////////////////////////////////////////////////////////
 
-	PhysicObject::PhysicObject(const sf::Image& source, int centerX, int centerY, int frameX, int frameY, int frameWidth, int frameHeight)
-		:	Object(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight),
-			m_body(nullptr)
+	PhysicObject::PhysicObject(EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, int frameX, int frameY, int frameWidth, int frameHeight)
+		: Object(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
 	{
 		m_objectCollision.m_mainObject = this;
 		m_objectCollision.m_mainObjectType = Collision::PhysicObjectType::POT_UNDEF;
@@ -101,79 +95,108 @@ namespace GameSpace
 		m_objectCollision.m_onUnCollide = nullptr;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void PhysicObject::draw(sf::RenderWindow& render)
+	bool PhysicObject::getBodyState(BodyState& result) const
 	{
-		//       
-		assert(m_body);
-		b2Vec2 bodyPosition = m_body->GetPosition();
-		float32 bodyAngle = m_body->GetAngle();
-		
-		getSprite().setPosition(floor(PhysicObject::mapPhysicToPixel(bodyPosition.x)),
-								floor(PhysicObject::mapPhysicToPixel(bodyPosition.y)));
-		getSprite().setRotation(static_cast<float>(bodyAngle * RADTODEG));
-		Object::draw(render);
+		const b2Body* body = getEntities().getBody(getEntity());
+		if (!body)
+		{
+			return false;
+		}
+		result.m_position = body->GetPosition();
+		result.m_angle = body->GetAngle();
+		result.m_velocity = body->GetLinearVelocity();
+		result.m_angularVelocity = body->GetAngularVelocity();
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void PhysicObject::setBodyState(const BodyState& state)
+	{
+		b2Body* body = getBody();
+		assert(body);
+		body->SetTransform(state.m_position, state.m_angle);
+		body->SetLinearVelocity(state.m_velocity);
+		body->SetAngularVelocity(state.m_angularVelocity);
+		body->SetAwake(true);
+		// перенос не интерполируется
+		getEntities().setPrevious(getEntity(), state.m_position, state.m_angle);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	SimpleObject::SimpleObject(	const sf::Image& source, int centerX, int centerY, 
+	void PhysicObject::removeBody()
+	{
+		getEntities().removeBody(getEntity());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	SimpleObject::SimpleObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, 
 								int frameX, int frameY, int frameWidth, int frameHeight)
-		: Object(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
+		: Object(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
 	{
 
 	}
 	//////////////////////////////////////////////////////////////////////////
-	SimpleObject::SimpleObject(const sf::Image& source, int centerX, int centerY)
-		: SimpleObject(source, centerX, centerY, 0, 0, source.getSize().x, source.getSize().y)
+	SimpleObject::SimpleObject(EntityStore& entities, const TextureRegion& region, int centerX, int centerY)
+		: SimpleObject(	entities, region.m_texture, centerX, centerY, 
+						region.m_rect.left, region.m_rect.top, region.m_rect.width, region.m_rect.height)
 	{
 
 	}
 	//////////////////////////////////////////////////////////////////////////
-	HardObject::HardObject(const sf::Image& source, int centerX, int centerY, int frameX, int frameY, int frameWidth, int frameHeight, b2World* world, float friction)
-		: PhysicObject(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
+	HardObject::HardObject(EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, int frameX, int frameY, int frameWidth, int frameHeight, b2World* world, float friction)
+		: PhysicObject(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
+	{
+		getBody() = createGroundBody(world, centerX, centerY, abs(frameWidth), abs(frameHeight), friction, &m_objectCollision);
+
+		m_objectCollision.m_mainObjectType = PhysicObject::Collision::PhysicObjectType::POT_HARD;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	b2Body* HardObject::createGroundBody(	b2World* world, int centerX, int centerY, int width, int height,
+											float friction, Collision* collision)
 	{
 		b2BodyDef groundBodyDef;
 		groundBodyDef.position.Set(	PhysicObject::mapPixelToPhysic(centerX), 
 									PhysicObject::mapPixelToPhysic(centerY));
 
-		getBody() = world->CreateBody(&groundBodyDef);
+		b2Body* body = world->CreateBody(&groundBodyDef);
 
 		b2EdgeShape groundBox;
 
 		b2FixtureDef groundFixtureDef;
 		groundFixtureDef.shape = &groundBox;
-		groundFixtureDef.density = 0.0f;	//  
+		groundFixtureDef.density = 0.0f;	// масса бесконечна
 		groundFixtureDef.friction = friction;
-		groundFixtureDef.userData = &m_objectCollision;
+		groundFixtureDef.userData = collision;
 
-		const float halfWidth = PhysicObject::mapPixelToPhysic(abs(frameWidth)) / 2.0f;
-		const float halfHeight = PhysicObject::mapPixelToPhysic(abs(frameHeight)) / 2.0f;
+		const float halfWidth = PhysicObject::mapPixelToPhysic(width) / 2.0f;
+		const float halfHeight = PhysicObject::mapPixelToPhysic(height) / 2.0f;
 
 		groundBox.Set(b2Vec2(halfWidth, halfHeight), b2Vec2(-halfWidth, halfHeight));
-		getBody()->CreateFixture(&groundFixtureDef);
+		body->CreateFixture(&groundFixtureDef);
 
 		groundBox.Set(b2Vec2(-halfWidth, halfHeight), b2Vec2(-halfWidth, -halfHeight));
-		getBody()->CreateFixture(&groundFixtureDef);
+		body->CreateFixture(&groundFixtureDef);
 
 		groundBox.Set(b2Vec2(-halfWidth, -halfHeight), b2Vec2(halfWidth, -halfHeight));
-		getBody()->CreateFixture(&groundFixtureDef);
+		body->CreateFixture(&groundFixtureDef);
 
 		groundBox.Set(b2Vec2(halfWidth, -halfHeight), b2Vec2(halfWidth, halfHeight));
-		getBody()->CreateFixture(&groundFixtureDef);
+		body->CreateFixture(&groundFixtureDef);
 
-		m_objectCollision.m_mainObjectType = PhysicObject::Collision::PhysicObjectType::POT_HARD;
+		return body;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	HardObject::HardObject(const sf::Image& source, int centerX, int centerY, b2World* world, float friction)
-		: HardObject(source, centerX, centerY, 0, 0, source.getSize().x, source.getSize().y, world, friction)
+	HardObject::HardObject(EntityStore& entities, const TextureRegion& region, int centerX, int centerY, b2World* world, float friction)
+		: HardObject(	entities, region.m_texture, centerX, centerY, 
+						region.m_rect.left, region.m_rect.top, region.m_rect.width, region.m_rect.height, 
+						world, friction)
 	{
 
 	}
 	//////////////////////////////////////////////////////////////////////////
-	PlatformObject::PlatformObject(	const sf::Image& source, int centerX, int centerY, 
+	PlatformObject::PlatformObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, 
 									int frameX, int frameY, int frameWidth, int frameHeight, 
 									b2World* world, int dstCenterX, int dstCenterY, 
 									float friction, float speed)
-		:	PhysicObject(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight),
-			m_speed(speed)
+		:	PhysicObject(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight),
+			m_speed(speed), m_lastDelta(0.0f)
 	{
 		b2BodyDef platformBody;
 		platformBody.position.Set(	PhysicObject::mapPixelToPhysic(centerX),
@@ -189,14 +212,14 @@ namespace GameSpace
 		
 		b2FixtureDef platformFixture;
 		platformFixture.shape = &platformShape;
-		platformFixture.density = 0.0f;	//  
+		platformFixture.density = 0.0f;	// масса бесконечна
 		platformFixture.friction = 0.0f;
 		platformFixture.userData = &m_objectCollision;
 
 		platformShape.Set(b2Vec2(halfWidth - 0.1f, -halfHeight), b2Vec2(-halfWidth + 0.1f, -halfHeight));
 		getBody()->CreateFixture(&platformFixture)->SetFriction(friction);
-		//       
-		// :      
+		// не касаемся верхних точек платформы боковыми гранями
+		// цель: трение работает только на верхней грани
 		platformShape.Set(b2Vec2(-halfWidth + 0.1f, -halfHeight + 0.1f), b2Vec2(-halfWidth, halfHeight));
 		getBody()->CreateFixture(&platformFixture);
 		platformShape.Set(b2Vec2(-halfWidth, halfHeight), b2Vec2(halfWidth, halfHeight));
@@ -208,10 +231,12 @@ namespace GameSpace
 
 		m_srcPoint.Set(PhysicObject::mapPixelToPhysic(centerX), PhysicObject::mapPixelToPhysic(centerY));
 		m_dstPoint.Set(PhysicObject::mapPixelToPhysic(dstCenterX), PhysicObject::mapPixelToPhysic(dstCenterY));
+		enableBehaviour();
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void PlatformObject::logic(float delta)
 	{
+		m_lastDelta = delta;
 		auto bodyPosition = getBody()->GetPosition();
 		const float distanceX = m_dstPoint.x - bodyPosition.x;
 		const float distanceY = m_dstPoint.y - bodyPosition.y;
@@ -230,8 +255,36 @@ namespace GameSpace
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	JumpingObject::JumpingObject(const sf::Image& source, int centerX, int centerY, int frameX, int frameY, int frameWidth, int frameHeight, b2World* world, float friction, float restitution)
-		: PhysicObject(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
+	void PlatformObject::wake(float sleptTime)
+	{
+		// скорость платформы - шаг, умноженный на m_speed, поэтому за время сна
+		// при том же шаге она проехала бы sleptTime * m_lastDelta * m_speed
+		const float length = (m_dstPoint - m_srcPoint).Length();
+		float travel = sleptTime * m_lastDelta * m_speed;
+		if (getBody() && length > 0.0f && travel > 0.0f)
+		{
+			b2Vec2 position = getBody()->GetPosition();
+			// полный путь туда и обратно возвращает платформу на место
+			travel = std::fmod(travel, 2.0f * length);
+			for (;;)
+			{
+				const b2Vec2 way = m_dstPoint - position;
+				const float remaining = way.Length();
+				if (travel < remaining)
+				{
+					position = position + (travel / remaining) * way;
+					break;
+				}
+				travel -= remaining;
+				position = m_dstPoint;
+				std::swap(m_srcPoint, m_dstPoint);
+			}
+			getBody()->SetTransform(position, getBody()->GetAngle());
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	JumpingObject::JumpingObject(EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, int frameX, int frameY, int frameWidth, int frameHeight, b2World* world, float friction, float restitution)
+		: PhysicObject(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
 	{
 		b2BodyDef jumpDef;
 		jumpDef.position.Set(	PhysicObject::mapPixelToPhysic(centerX), 
@@ -267,11 +320,11 @@ namespace GameSpace
 		m_objectCollision.m_mainObjectType = PhysicObject::Collision::PhysicObjectType::POT_JUMPER;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	EffectObject::EffectObject(	const sf::Image& source, int centerX, int centerY,
+	EffectObject::EffectObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 								int frameX, int frameY, int frameWidth, int frameHeight, 
 								b2World* world, float friction, float restitution, 
 								int liveEffect, int coinEffect, bool isDestroyable	)
-		:	PhysicObject(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight),
+		:	PhysicObject(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight),
 			m_liveEffect(liveEffect), m_coinEffect(coinEffect), m_isDestroyable(isDestroyable),
 			m_selfDestroy(false)
 	{
@@ -309,6 +362,8 @@ namespace GameSpace
 		m_objectCollision.m_mainObjectType = PhysicObject::Collision::PhysicObjectType::POT_EFFECT;
 		m_objectCollision.m_onCollide = std::bind(&EffectObject::onCollision, this, std::placeholders::_1);
 		m_objectCollision.m_onUnCollide = std::bind(&EffectObject::onUnCollision, this, std::placeholders::_1);
+		// логики нет, но уничтожение проверяется на каждом шаге
+		enableBehaviour();
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void EffectObject::onCollision(PhysicObject::Collision* other)
@@ -342,10 +397,10 @@ namespace GameSpace
 		return m_selfDestroy;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	MoveObject::MoveObject(	const sf::Image& source, int centerX, int centerY, 
+	MoveObject::MoveObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, 
 							int frameX, int frameY, int frameWidth, int frameHeight, 
 							b2World* world, float density, float friction)
-		: PhysicObject(source, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
+		: PhysicObject(entities, texture, centerX, centerY, frameX, frameY, frameWidth, frameHeight)
 	{
 		b2BodyDef bodyDef;
 		bodyDef.type = b2_dynamicBody;
@@ -396,29 +451,30 @@ namespace GameSpace
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	PlayerObject::PlayerObject(	const sf::Image& source, int centerX, int centerY,
+	PlayerObject::PlayerObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 								const Animation& animator, b2World* world,
 								float density, float friction,
 								float xvelocity, float yvelocity, 
 								const HUD& hud, const PlayerSound& sound,
 								int playerLive, int maxCoin)
-				: MoveObject(	source, centerX, centerY,
+				: MoveObject(	entities, texture, centerX, centerY,
 								animator.getDefaultFrame().left,
 								animator.getDefaultFrame().top,
 								animator.getDefaultFrame().width,
 								animator.getDefaultFrame().height,
 								world, density, friction),
 				m_numFootContact(0),
+				m_actions(0), m_jumpHeld(false),
 				m_animator(animator), m_moveSpeed(xvelocity), m_jumpSpeed(yvelocity),
 				m_hud(hud), m_sound(sound), 
 				m_currentLive(playerLive), m_totalLive(playerLive), 
 				m_currentCoin(0), m_maxCoin(maxCoin)
 	{
-		getBody()->SetFixedRotation(true);	//     
+		getBody()->SetFixedRotation(true);	// предотвращаем поворот спрайта при соскальзывании
 
 		m_objectCollision.m_mainObjectType = PhysicObject::Collision::PhysicObjectType::POT_PLAYER;
 
-		//   
+		// создание сенсора ног
 		const int absFrameWidth(abs(m_animator.getDefaultFrame().width));
 		const int absFrameHeight(abs(m_animator.getDefaultFrame().height));
 
@@ -439,23 +495,17 @@ namespace GameSpace
 		footSensorFixtureDef.userData = &m_footSensorCollision;
 
 		getBody()->CreateFixture(&footSensorFixtureDef);
+		enableBehaviour();
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void PlayerObject::controlView(sf::RenderWindow& render)
 	{
-		auto currentPosition = getSprite().getPosition();
+		auto currentPosition = getEntities().getPosition(getEntity());
 		auto currentView = render.getView();
 		currentView.setCenter(currentPosition.x, currentPosition.y - 25.0f);
 		render.setView(currentView);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void PlayerObject::draw(sf::RenderWindow& render)
-	{
-		//getBody()->SetTransform(getBody()->GetPosition(), 0); //     
-		getSprite().setTextureRect(m_animator.getFrame());
-		MoveObject::draw(render);
-	}
-	//////////////////////////////////////////////////////////////////////////
 	void PlayerObject::drawHUD(sf::RenderWindow& render)
 	{
 		m_hud.draw(render, m_currentLive, m_totalLive, m_currentCoin);
@@ -479,7 +529,7 @@ namespace GameSpace
 		Animation::MoveState targetState = Animation::MoveState::MS_STAY_RIGHT;
 
 		if (m_numFootContact > 0)
-		{	//   
+		{	// стоим на предмете
 			if (m_desiredVelocityX > reactVal)
 			{
 				targetState = Animation::MoveState::MS_MOVE_RIGHT;
@@ -505,9 +555,9 @@ namespace GameSpace
 			}
 		}
 		else
-		{	//  
+		{	// в воздухе
 			if (bodyVelocity.y < -reactVal)
-			{	//
+			{	//прыжок
 				if (bodyVelocity.x > reactVal)
 				{
 					targetState = Animation::MoveState::MS_JUMP_RIGHT;
@@ -533,7 +583,7 @@ namespace GameSpace
 				}
 			}
 			else
-			{	// 
+			{	// падение
 				if (bodyVelocity.x > reactVal)
 				{
 					targetState = Animation::MoveState::MS_FALL_RIGHT;
@@ -561,14 +611,20 @@ namespace GameSpace
 		}
 
 		m_animator.animate(targetState, delta);
+		getEntities().setTextureRect(getEntity(), m_animator.getFrame());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void PlayerObject::setActions(InputSource::Actions actions)
+	{
+		m_actions = actions;
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void PlayerObject::logic(float delta)
 	{
-		//   -  
+		// обработка движения влево-вправо и прыжок
 		b2Vec2 bodyVelocity = getBody()->GetLinearVelocity();
 		m_desiredVelocityX = 0;
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+		if (m_actions & InputSource::IA_LEFT)
 		{
 			m_desiredVelocityX = -m_moveSpeed;
 
@@ -577,7 +633,7 @@ namespace GameSpace
 				m_sound.walk();
 			}
 		}
-		else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+		else if (m_actions & InputSource::IA_RIGHT)
 		{
 			m_desiredVelocityX = m_moveSpeed;
 
@@ -588,21 +644,20 @@ namespace GameSpace
 		}
 		float impulsex = getBody()->GetMass() * (m_desiredVelocityX - bodyVelocity.x);
 
-		static bool lastSignalIsJump = false;
 		float impulsey = 0;
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
+		if (m_actions & InputSource::IA_JUMP)
 		{
-			if (!lastSignalIsJump && m_numFootContact > 0)
+			if (!m_jumpHeld && m_numFootContact > 0)
 			{
 				impulsey = -(getBody()->GetMass() * m_jumpSpeed);
-				lastSignalIsJump = true;
+				m_jumpHeld = true;
 
 				m_sound.jump();
 			}
 		}
 		else
 		{
-			lastSignalIsJump = false;
+			m_jumpHeld = false;
 		}
 
 		// F = ma; a = v/t => F = mv/t
@@ -6,6 +6,7 @@
 #include <functional>
 #include <iostream>
 #include <set>
+#include <cmath>
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
@@ -14,107 +15,108 @@
 #include "animation.h"
 #include "hud.h"
 #include "music.h"
+#include "texturecache.h"
+#include "atlas.h"
+#include "input.h"
+#include "entitystore.h"
 
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
 	class Object
 	{
-		sf::Texture m_texture;
-		sf::Sprite m_sprite;
+		EntityStore& m_entities;
+		EntityStore::Entity m_entity;
+		TexturePtr m_texture;	// страница атласа живет, пока жива сущность
+
+		/*
+			@brief объект владеет своей сущностью, копия освободила бы ее дважды
+		*/
+		Object(const Object& other) = delete;
+		Object& operator=(const Object& other) = delete;
 	protected:
-		sf::Texture& getTexture();
-		sf::Sprite& getSprite();
-		/*
-			@brief   
-			@param source  
-			@param centerX     
-			@param centerY     
-			@param frameX     
-			@param frameY     
-			@param frameWidth    
-			@param frameHeight    
-		*/
-		Object(	const sf::Image& source, int centerX, int centerY, 
-				int frameX, int frameY, int frameWidth, int frameHeight);
+		const sf::Texture& getTexture() const;
+		EntityStore& getEntities() const;
 		/*
-			@brief  
+			@brief	подключает логику и анимацию объекта к шагу мира
+					объекты без поведения только рисуются и не стоят вызовов на шаге
 		*/
-		Object(const Object& other);
+		void enableBehaviour();
 		/*
-			@brief  
+			@brief создает игровой объект
+			@param entities хранилище, в котором создается сущность объекта
+			@param texture разделяемая текстура источник
+			@param centerX положение центра объекта по Х
+			@param centerY положение центра объекта по У
+			@param frameX смещение в изображении по Х
+			@param frameY смещение в изображении по У
+			@param frameWidth ширина кадра в изображении
+			@param frameHeight высота кадра в изображении
 		*/
-		Object& operator=(const Object& other);
+		Object(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY, 
+				int frameX, int frameY, int frameWidth, int frameHeight);
 	public:
 		/*
-			@brief   
+			@brief освобождает сущность, класс будет родительским
 		*/
-		virtual ~Object() = default;
+		virtual ~Object();
 		/*
-			@brief  
-			@param render     
+			@brief сущность объекта в хранилище мира
 		*/
-		virtual void draw(sf::RenderWindow& render);
+		EntityStore::Entity getEntity() const;
 		/*
-			@brief    (  )
-			@param delta    
+			@brief вызывает обработку анимации (со скоростью игры)
+			@param delta время такта в секундах
 		*/
 		virtual void animate(float delta);
 		/*
-			@brief     ,    
-			@param delta    
+			@brief вызывает обработку логики тех объектов, у которых она есть
+			@param delta время такта в секундах
 		*/
 		virtual void logic(float delta);
 		/*
-			@brief        
-			@param live   
-			@param coin   
+			@brief вызывается объектом создающим эффект у объектов принимающих эффект
+			@param live эффект на жизнь
+			@param coin эффект на монеты
 		*/
 		virtual void effect(int live, int coin);
 		/*
-			@brief	   ,      
-			@ret	      
+			@brief	используется для уничтожения объектов, если они уничтожены в логике игры
+			@ret	следует ли удалить объект из игровых объектов
 		*/
 		virtual bool destroy();
+		/*
+			@brief	объект с поведением вернулся в активную область
+			@param sleptTime игровое время сна в секундах
+		*/
+		virtual void wake(float sleptTime);
 	};
 	//////////////////////////////////////////////////////////////////////////
 	class PhysicObject : public Object
 	{
-		b2Body* m_body;
 	protected:
+		/*
+			@brief тело объекта, лежит в хранилище сущностей
+		*/
 		b2Body*& getBody();
 		static const double DEGTORAD;
 		static const double RADTODEG;
 		/*
-			@brief    .
+			@brief проксирует создание объекта к базовому Object
+			@param все параметры из базового класса Object
 		*/
-		static float mapPixelToPhysic(float v);
-		static float mapPixelToPhysic(int v);
-		/*
-			@brief  .  
-		*/
-		static float mapPhysicToPixel(float v);
-		/*
-			@brief      Object
-			@param      Object
-		*/
-		PhysicObject(	const sf::Image& source, int centerX, int centerY,
+		PhysicObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 						int frameX, int frameY, int frameWidth, int frameHeight);
-		/*
-			@brief   
-		*/
-		PhysicObject(const PhysicObject& other) = default;
-		PhysicObject& operator=(const PhysicObject& other) = default;
 	public:
 		/*
-			@brief	,      
-					   ,   
+			@brief	структура, которая является дескриптором объекта при столкновении
+					нужна только для объектов, которые имеют физику
 		*/
 		struct Collision
 		{
-			//  
+			// главный объект
 			PhysicObject* m_mainObject;
-			//   
+			// описывает тип объекта
 			enum class PhysicObjectType{	POT_UNDEF, 
 											POT_HARD, 
 											POT_MOVE, 
@@ -123,46 +125,70 @@ namespace GameSpace
 											POT_PLATFORM,
 											POT_JUMPER,
 											POT_EFFECT} m_mainObjectType;
-			// ,   
-			//  -  Collision
+			// функция, вызываемая при столкновении
+			// параметр - другой Collision
 			std::function<void(Collision*)> m_onCollide;
-			// ,     
-			//  -  Collision
+			// функция, вызываемая при уходе от столкновения
+			// параметр - другой Collision
 			std::function<void(Collision*)> m_onUnCollide;
 		};
-		Collision m_objectCollision;	//     
+		Collision m_objectCollision;	// Используется при столкновении с объектом
 		/*
-			@brief  
+			@brief преобразует пиксели в физ.единицы
+		*/
+		static float mapPixelToPhysic(float v);
+		static float mapPixelToPhysic(int v);
+		/*
+			@brief преобразует физ.единицы в пиксели
+		*/
+		static float mapPhysicToPixel(float v);
+		/*
+			@brief виртуальный деструктор
 		*/
 		virtual ~PhysicObject() = default;
 		/*
-			@brief        
-			@param render   
+			@brief	положение и скорость тела
+					переносятся в новый мир физики при перезагрузке уровня
+		*/
+		struct BodyState
+		{
+			b2Vec2 m_position;
+			float32 m_angle;
+			b2Vec2 m_velocity;
+			float32 m_angularVelocity;
+		};
+		/*
+			@brief читает положение и скорость тела
+			@ret   есть ли у объекта тело
+		*/
+		bool getBodyState(BodyState& result) const;
+		/*
+			@brief задает положение и скорость тела
 		*/
-		virtual void draw(sf::RenderWindow& render) override;
+		void setBodyState(const BodyState& state);
+		/*
+			@brief удаляет тело из мира физики, когда объект убирается из уровня
+		*/
+		void removeBody();
 	};
 	//////////////////////////////////////////////////////////////////////////
 	class SimpleObject : public Object
 	{
 	public:
 		/*
-			@brief  
-			@param      Object
+			@brief создает декорацию
+			@param все параметры из базового класса Object
 		*/
-		SimpleObject(	const sf::Image& source, int centerX, int centerY,
+		SimpleObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 						int frameX, int frameY, int frameWidth, int frameHeight);
 		/*
-			@brief     
-			@param source  
-			@param centerX    
-			@param centerY    Y
+			@brief создает декорацию из участка текстуры
+			@param entities хранилище сущностей мира
+			@param region участок текстуры
+			@param centerX положение центра по Х
+			@param centerY положение центра по Y
 		*/
-		SimpleObject(const sf::Image& source, int centerX, int centerY);
-		/*
-			@brief  
-		*/
-		SimpleObject(const SimpleObject& other) = default;
-		SimpleObject& operator=(const SimpleObject& other) = default;
+		SimpleObject(EntityStore& entities, const TextureRegion& region, int centerX, int centerY);
 		virtual ~SimpleObject() = default;
 	};
 	//////////////////////////////////////////////////////////////////////////
@@ -170,224 +196,235 @@ namespace GameSpace
 	{
 	public:
 		/*
-			@brief  ""   -     
-			@param     +
-			@param world  
-			@param friction  
+			@brief создает "жёсткий" объект мира - не двигается и не проходим
+			@param все как у родителя +
+			@param world мир физики
+			@param friction коэффицент трения
 		*/
-		HardObject(	const sf::Image& source, int centerX, int centerY,
+		HardObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 					int frameX, int frameY, int frameWidth, int frameHeight,
 					b2World* world, float friction);
 		/*
-			@brief  ""     
+			@brief создает "жёсткий" объект мира размером в участок текстуры
+		*/
+		HardObject(EntityStore& entities, const TextureRegion& region, int centerX, int centerY, b2World* world, float friction);
+		/*
+			@brief создает неподвижное тело в виде прямоугольного контура
+			@param world мир физики
+			@param centerX центр по Х в пикселях
+			@param centerY центр по У в пикселях
+			@param width ширина в пикселях
+			@param height высота в пикселях
+			@param friction коэффицент трения
+			@param collision дескриптор столкновений для всех граней
+			@ret   созданное тело
 		*/
-		HardObject(const sf::Image& source, int centerX, int centerY, b2World* world, float friction);
+		static b2Body* createGroundBody(b2World* world, int centerX, int centerY, int width, int height,
+										float friction, Collision* collision);
 
-		HardObject(const HardObject& other) = default;
-		HardObject& operator=(const HardObject& other) = default;
 		virtual ~HardObject() = default;
 	};
 	//////////////////////////////////////////////////////////////////////////
-	//     
+	// используется для создания движущихся платформ
 	class PlatformObject : public PhysicObject
 	{
-		b2Vec2 m_srcPoint;	//   
-		b2Vec2 m_dstPoint;	//   
+		b2Vec2 m_srcPoint;	// точка движения старта
+		b2Vec2 m_dstPoint;	// точка движения назначения
 		float m_speed;
+		float m_lastDelta;	// шаг последнего вызова логики, скорость платформы зависит от него
 	public:
 		/*
-			@brief  , 
-					 (centerX, centerY)  (dstCenterX, dstCenterY)
-			@param     +
-			@param dstCenterX   
-			@param dstCenterY   
-			@param friction     
-			@param speed   
+			@brief создает платформу, перемещающуюся
+					из (centerX, centerY) в (dstCenterX, dstCenterY)
+			@param все как у родителя +
+			@param dstCenterX координата назначения Х
+			@param dstCenterY координата назначения У
+			@param friction коэффицент трения верхней части панели
+			@param speed скорость движения платформы
 		*/
-		PlatformObject(	const sf::Image& source, int centerX, int centerY,
+		PlatformObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 						int frameX, int frameY, int frameWidth, int frameHeight,
 						b2World* world, int dstCenterX, int dstCenterY,
 						float friction, float speed);
 
-		PlatformObject(const PlatformObject&) = default;
-		PlatformObject& operator=(const PlatformObject&) = default;
 		virtual ~PlatformObject() = default;
 
 		/*
-			@brief  
+			@brief логика платформы
 		*/
 		void logic(float delta) override;
+		/*
+			@brief	переносит платформу туда, куда она доехала бы за время сна
+			@param sleptTime игровое время сна в секундах
+		*/
+		virtual void wake(float sleptTime) override;
 	};
 	//////////////////////////////////////////////////////////////////////////
-	//     
+	// используется для создания прыжковых ускорителей
 	class JumpingObject : public PhysicObject
 	{
 	public:
 		/*
-			@brief  ,    
-			@param     +
-			@param friction    
-			@param restitution  
+			@brief создает объект, на котором можно прыгать
+			@param все как у родителя +
+			@param friction коэффицент трения верхней кромки
+			@param restitution коэффицент упругости
 		*/
-		JumpingObject(const sf::Image& source, int centerX, int centerY,
+		JumpingObject(EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 			int frameX, int frameY, int frameWidth, int frameHeight,
 			b2World* world, float friction, float restitution);
 
-		JumpingObject(const JumpingObject&) = default;
-		JumpingObject& operator=(const JumpingObject&) = default;
 		virtual ~JumpingObject() = default;
 	};
 	//////////////////////////////////////////////////////////////////////////
-	//   ,      
+	// используется как объект, касание к которому приводит к эффекту
 	class EffectObject : public PhysicObject
 	{
-		int m_liveEffect;	// ,  
-		int m_coinEffect;	// ,  
-		bool m_isDestroyable;	//   
-		bool m_selfDestroy;	//   
-		std::set<PhysicObject*> m_contacts;	//  ,     
+		int m_liveEffect;	// эффект, причиняемый жизни
+		int m_coinEffect;	// эффект, причиняемый монетам
+		bool m_isDestroyable;	// уничтожить после эффекта
+		bool m_selfDestroy;	// объект должен уничтожится
+		std::set<PhysicObject*> m_contacts;	// отслеживает контакты, чтобы причинять эффект только новым
 		/*
-			@brief     
-			@param other ,    
+			@brief вызывается после контакта с объектом
+			@param other объект, с которым произошел контакт
 		*/
 		void onCollision(PhysicObject::Collision* other);
 		/*
-			@brief      
-			@param other ,    
+			@brief вызывается после прекращения контакта с объектом
+			@param other объект, с которым отменен контакт
 		*/
 		void onUnCollision(PhysicObject::Collision* other);
 	public:
 		/*
-			@brief    
-			@param     +
-			@param friction  
-			@param restitution   (  )
-			@param liveEffect ,    
-			@param coinEffect ,    
-			@param isDestroyable      
+			@brief создает объект который убивает
+			@param все как у родителя +
+			@param friction коэффицент трения
+			@param restitution коэффицент упругости (отталкивать после атаки)
+			@param liveEffect эффект, причиняемый жизни при касании
+			@param coinEffect эффект, причиняемый монетам при касании
+			@param isDestroyable уничтожать объект после касания с ним
 		*/
-		EffectObject(	const sf::Image& source, int centerX, int centerY,
+		EffectObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 						int frameX, int frameY, int frameWidth, int frameHeight,
 						b2World* world, float friction, float restitution, 
 						int liveEffect, int coinEffect, bool isDestroyable	);
 
-		EffectObject(const EffectObject&) = default;
-		EffectObject& operator=(const EffectObject&) = default;
 		virtual ~EffectObject() = default;
 
 		virtual bool destroy() override;
 	};
 	//////////////////////////////////////////////////////////////////////////
-	//      ,   
+	// используется для игрока и других сущностей, которые умеют двигаться
 	class MoveObject : public PhysicObject
 	{
 	public:
 		/*
-			@brief   ,   
-			@param     +
-			@param density  (   )
-			@param friction  
+			@brief создает объект мира, способный к перемещению
+			@param все как у родителя +
+			@param density плотность (от этого зависит масса)
+			@param friction коэффицент трения
 		*/
-		MoveObject(	const sf::Image& source, int centerX, int centerY,
+		MoveObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 					int frameX, int frameY, int frameWidth, int frameHeight,
 					b2World* world, float density, float friction);
 
-		MoveObject(const MoveObject& other) = default;
-		MoveObject& operator=(const MoveObject& other) = default;
 		virtual ~MoveObject() = default;
 	};
 	//////////////////////////////////////////////////////////////////////////
 	class PlayerObject : public MoveObject
 	{
-		int m_numFootContact; //    
+		int m_numFootContact; // количество контактов с почвой
 		/*
-			@brief       
-			@param other ,    
+			@brief вызывается при контакте с объектом нижней гранью
+			@param other объект, с которым осуществлен контакт
 		*/
 		void onFootSensorCollision(PhysicObject::Collision* other);
 		/*
-			@brief        
-			@param other ,    
+			@brief вызывается при отмене контакта с объектом нижней гранью
+			@param other объект, с которым прекращен контакт
 		*/
 		void onFootSensorUnCollision(PhysicObject::Collision* other);
 
-		Animation m_animator;	//   
-		float m_moveSpeed, m_jumpSpeed;	//    
-		float m_desiredVelocityX;	// ,    
-		HUD m_hud;	// -
-		PlayerSound m_sound;	//  
-		int m_currentLive, m_totalLive;	//      
-		int m_currentCoin, m_maxCoin;	//        
+		InputSource::Actions m_actions;	// управление на текущий шаг
+		bool m_jumpHeld;	// прыжок был нажат на прошлом шаге, повторный прыжок только после отпускания
+		Animation m_animator;	// объект для анимации
+		float m_moveSpeed, m_jumpSpeed;	// скорость движения и прыжка
+		float m_desiredVelocityX;	// скорость, которую хочется достигнуть игроку
+		HUD m_hud;	// инфо-панель
+		PlayerSound m_sound;	// звуковые эффекты
+		int m_currentLive, m_totalLive;	// текущее количество жизней и всего жизней
+		int m_currentCoin, m_maxCoin;	// текущее количество монет и количество монет для выйгрыша
 	public:
 		/*
-			@brief   
-			@param source  
-			@param centerX   
-			@param centerY   
-			@param animator -
-			@param world  
-			@param density 
-			@param friction 
-			@param xvelocity   
-			@param yvelocity   
-			@param hud -
-			@param playerLive    
-			@param maxcoin  ,   
-		*/
-		PlayerObject(	const sf::Image& source, int centerX, int centerY,
+			@brief создает игровой объект
+			@param entities хранилище сущностей мира
+			@param texture разделяемая текстура
+			@param centerX координата Х центра
+			@param centerY координата У центра
+			@param animator объект-аниматор
+			@param world физический мир
+			@param density плотность
+			@param friction трение
+			@param xvelocity скорость по Х
+			@param yvelocity скорость по У
+			@param hud инфо-панель
+			@param playerLive количество жизней у игрока
+			@param maxcoin количество монет, приводящих к выйгрышу
+		*/
+		PlayerObject(	EntityStore& entities, const TexturePtr& texture, int centerX, int centerY,
 						const Animation& animator, b2World* world,
 						float density, float friction,
 						float xvelocity, float yvelocity,
 						const HUD& hud, const PlayerSound& sound, 
 						int playerLive, int maxCoin);
 
-		PlayerObject(const PlayerObject& other) = default;
-		PlayerObject& operator=(const PlayerObject& other) = default;
 		virtual ~PlayerObject() = default;
 
 		/*
-			@brief    
+			@brief хелпер для сенсора ног
 		*/
 		PhysicObject::Collision m_footSensorCollision;
 
 		/*
-			@brief   
-			@param render   
+			@brief выполняет перемещение камеры
+			@param render объект для рендера
 		*/
 		void controlView(sf::RenderWindow& render);
 		/*
-			@brief  
+			@brief выполняет анимацию в зависимости от скорости
+			@param delta время такта в секундах
 		*/
-		virtual void draw(sf::RenderWindow& render) override;
+		virtual void animate(float delta) override;
 		/*
-			@brief      
-			@param delta    
+			@brief	задает управление на следующий шаг
+			@param actions снимок источника управления
 		*/
-		virtual void animate(float delta) override;
+		void setActions(InputSource::Actions actions);
 		/*
-			@brief    
-			@param delta    
+			@brief инициирует управление игровым объектом
+			@param delta время такта в секундах
 		*/
 		virtual void logic(float delta) override;
 		/*
-			@brief    
-			@param live   
-			@param coin   
+			@brief вызывается при причинении эффекта
+			@param live эффект к жизни
+			@param coin эффект к монетам
 		*/
 		virtual void effect(int live, int coin) override;
 		/*
-			@brief   HUD 
-			@param render   
+			@brief выполняет прорисовку HUD информации
+			@param render объект для отрисовки
 		*/
 		void drawHUD(sf::RenderWindow& render);
 		/*
-			@brief   
-			@ret     
+			@brief проверяет условие выйгрыша
+			@ret   выйгран ли уровень
 		*/
 		bool isWin();
 		/*
-			@brief   
-			@ret     
+			@brief проверяет условие проигрыша
+			@ret   проигран ли уровень
 		*/
 		bool isFail();
 	};
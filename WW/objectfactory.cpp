@@ -0,0 +1,181 @@
+#include "objectfactory.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	ObjectContext::ObjectContext(	const LevelData& level, const LevelLoader::Result& prepared, const TextureAtlas& atlas,
+									b2World* physWorld, EntityStore& entities, const LevelObject& object)
+		:	m_level(level), m_prepared(prepared), m_atlas(atlas), m_physWorld(physWorld), m_entities(entities),
+			m_object(object)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const TextureRegion& ObjectContext::getTile() const
+	{
+		return m_atlas.get(m_level.getTileImage(m_object.m_gid));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	sf::Vector2i ObjectContext::getCenter(const sf::Vector2i& size) const
+	{
+		return sf::Vector2i(static_cast<int>(m_object.m_x + size.x / 2.0), static_cast<int>(m_object.m_y - size.y / 2.0));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::map<std::string, ObjectFactory::Type>& ObjectFactory::getTypes()
+	{
+		static std::map<std::string, Type> types;
+		return types;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ObjectFactory::applyDefaults(void* params, const std::vector<Property>& schema)
+	{
+		if (schema.size() > 64)
+		{
+			throw std::runtime_error("GameSpace::ObjectFactory::applyDefaults if (schema.size() > 64)");
+		}
+		char* base = static_cast<char*>(params);
+		for (const auto& field : schema)
+		{
+			if (!field.m_default)
+			{
+				continue;
+			}
+			const StringView value(field.m_default, std::strlen(field.m_default));
+			switch (field.m_type)
+			{
+			case LevelProperty::Type::PT_INT:
+				*reinterpret_cast<std::int32_t*>(base + field.m_offset) = value.toInt();
+				break;
+			case LevelProperty::Type::PT_FLOAT:
+				*reinterpret_cast<float*>(base + field.m_offset) = value.toFloat();
+				break;
+			default:
+				*reinterpret_cast<const char**>(base + field.m_offset) = field.m_default;
+				break;
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ObjectFactory::write(void* params, const Property& field, const LevelProperty& property, const LevelData& level)
+	{
+		char* target = static_cast<char*>(params) + field.m_offset;
+		switch (field.m_type)
+		{
+		case LevelProperty::Type::PT_INT:
+		{
+			std::int32_t& result = *reinterpret_cast<std::int32_t*>(target);
+			if (property.m_type == LevelProperty::Type::PT_INT)
+			{
+				result = property.m_int;
+			}
+			else if (property.m_type == LevelProperty::Type::PT_FLOAT)
+			{
+				result = static_cast<std::int32_t>(property.m_float);
+			}
+			else
+			{
+				const std::string& value = level.getString(property.m_string);
+				result = StringView(value.data(), value.size()).toInt();
+			}
+			break;
+		}
+		case LevelProperty::Type::PT_FLOAT:
+		{
+			float& result = *reinterpret_cast<float*>(target);
+			if (property.m_type == LevelProperty::Type::PT_INT)
+			{
+				result = static_cast<float>(property.m_int);
+			}
+			else if (property.m_type == LevelProperty::Type::PT_FLOAT)
+			{
+				result = property.m_float;
+			}
+			else
+			{
+				const std::string& value = level.getString(property.m_string);
+				result = StringView(value.data(), value.size()).toFloat();
+			}
+			break;
+		}
+		default:
+			if (property.m_type != LevelProperty::Type::PT_STRING)
+			{
+				throw std::runtime_error("GameSpace::ObjectFactory::write if (property.m_type != PT_STRING)");
+			}
+			// строки уровня живут, пока жив LevelData, то есть дольше создания объекта
+			*reinterpret_cast<const char**>(target) = level.getString(property.m_string).c_str();
+			break;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ObjectFactory::Binding::fill(void* params, const ObjectContext& context) const
+	{
+		const LevelObject& object = context.m_object;
+		std::uint64_t found = 0;
+		for (std::uint32_t i = 0; i < object.m_propertyCount; ++i)
+		{
+			const LevelProperty& property = context.m_level.m_properties[object.m_firstProperty + i];
+			// полей в схеме единицы, перебор дешевле любого поиска
+			for (const auto& field : m_fields)
+			{
+				if (field.first == property.m_name)
+				{
+					write(params, m_type->m_schema[field.second], property, context.m_level);
+					found |= std::uint64_t(1) << field.second;
+					break;
+				}
+			}
+		}
+		if ((found & m_required) != m_required)
+		{
+			throw std::runtime_error("GameSpace::ObjectFactory::Binding::fill if ((found & m_required) != m_required)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	ObjectFactory::Resolver::Resolver(const LevelData& level)
+	{
+		std::unordered_map<std::string, std::uint32_t> strings;
+		for (size_t i = 0; i < level.m_strings.size(); ++i)
+		{
+			strings.insert(std::make_pair(level.m_strings[i], static_cast<std::uint32_t>(i)));
+		}
+
+		for (const auto& type : getTypes())
+		{
+			const auto typeName = strings.find(type.first);
+			if (typeName == strings.end())
+			{	// на уровне нет объектов этого типа
+				continue;
+			}
+			Binding binding;
+			binding.m_type = &type.second;
+			binding.m_required = 0;
+			const std::vector<Property>& schema = type.second.m_schema;
+			for (std::uint32_t field = 0; field < schema.size(); ++field)
+			{
+				if (!schema[field].m_default)
+				{
+					binding.m_required |= std::uint64_t(1) << field;
+				}
+				// свойства, имени которых нет на уровне, останутся по умолчанию
+				const auto propertyName = strings.find(schema[field].m_name);
+				if (propertyName != strings.end())
+				{
+					binding.m_fields.push_back(std::make_pair(propertyName->second, field));
+				}
+			}
+			m_bindings.insert(std::make_pair(typeName->second, binding));
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::shared_ptr<Object> ObjectFactory::Resolver::create(const ObjectContext& context) const
+	{
+		const auto binding = m_bindings.find(context.m_object.m_type);
+		if (binding == m_bindings.end())
+		{
+			return nullptr;
+		}
+		return binding->second.m_type->m_create(context, binding->second);
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef OBJECTFACTORY_H
+#define OBJECTFACTORY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+#include <Box2D/Box2D.h>
+
+#include "object.h"
+#include "leveldata.h"
+#include "atlas.h"
+#include "levelloader.h"
+#include "xmlreader.h"
+
+namespace GameSpace
+{
+	// @brief все, что нужно для создания одного объекта карты
+	struct ObjectContext
+	{
+		const LevelData& m_level;
+		const LevelLoader::Result& m_prepared;	// шрифты и звуки уровня
+		const TextureAtlas& m_atlas;
+		b2World* m_physWorld;
+		EntityStore& m_entities;	// хранилище, в котором создается сущность объекта
+		const LevelObject& m_object;
+
+		ObjectContext(	const LevelData& level, const LevelLoader::Result& prepared, const TextureAtlas& atlas,
+						b2World* physWorld, EntityStore& entities, const LevelObject& object);
+		/*
+			@brief участок атласа с тайлом объекта
+		*/
+		const TextureRegion& getTile() const;
+		/*
+			@brief	центр объекта заданного размера
+					на карте задается левый нижний угол объекта
+			@param size размер в пикселях
+		*/
+		sf::Vector2i getCenter(const sf::Vector2i& size) const;
+	};
+	/*
+		@brief	реестр типов объектов карты
+				каждый тип объявляет схему свойств: имя, тип и значение по умолчанию
+				каждого поля своей структуры параметров, и функцию создания объекта,
+				новые типы регистрируются статической переменной в своем файле без правки World
+	*/
+	class ObjectFactory final
+	{
+	public:
+		// @brief поле структуры параметров, заполняемое свойством карты
+		struct Property
+		{
+			const char* m_name;				// имя свойства на карте
+			LevelProperty::Type m_type;		// PT_INT - std::int32_t, PT_FLOAT - float, PT_STRING - const char*
+			size_t m_offset;				// смещение поля в структуре параметров
+			const char* m_default;			// значение по умолчанию, nullptr - свойство обязательно
+		};
+		class Resolver;
+	private:
+		struct Binding;
+		// @brief зарегистрированный тип: схема и создание из заполненной копии прототипа параметров
+		struct Type
+		{
+			std::vector<Property> m_schema;
+			std::function<std::shared_ptr<Object>(const ObjectContext&, const Binding&)> m_create;
+		};
+		/*
+			@brief	сопоставление типа с одним уровнем
+					имена свойств уровня заменены номерами полей схемы один раз на уровень
+		*/
+		struct Binding
+		{
+			const Type* m_type;
+			std::vector<std::pair<std::uint32_t, std::uint32_t>> m_fields;	// номер строки имени - номер поля
+			std::uint64_t m_required;										// маска обязательных полей
+			/*
+				@brief записывает свойства объекта в поля параметров
+				@param params структура параметров типа
+				@param context создаваемый объект
+			*/
+			void fill(void* params, const ObjectContext& context) const;
+		};
+		/*
+			@brief	реестр типов по имени
+					статическая переменная функции, чтобы регистрация из других файлов
+					не зависела от порядка инициализации
+		*/
+		static std::map<std::string, Type>& getTypes();
+		/*
+			@brief проверяет схему и записывает значения по умолчанию в прототип
+			@param params структура параметров
+			@param schema схема
+		*/
+		static void applyDefaults(void* params, const std::vector<Property>& schema);
+		/*
+			@brief записывает значение свойства в поле структуры параметров с приведением типа
+		*/
+		static void write(void* params, const Property& field, const LevelProperty& property, const LevelData& level);
+	public:
+		/*
+			@brief	регистрирует тип объекта
+					Params должна копироваться побайтно: поля только std::int32_t, float и const char*
+			@param name имя типа на карте
+			@param schema свойства типа
+			@param create создание объекта по заполненным параметрам
+			@ret   true, для регистрации инициализацией статической переменной
+		*/
+		template<class Params>
+		static bool add(const std::string& name, const std::vector<Property>& schema,
+						const std::function<std::shared_ptr<Object>(const ObjectContext&, const Params&)>& create)
+		{
+			Params prototype;
+			std::memset(&prototype, 0, sizeof(prototype));
+			applyDefaults(&prototype, schema);
+
+			Type type;
+			type.m_schema = schema;
+			type.m_create = [prototype, create](const ObjectContext& context, const Binding& binding) -> std::shared_ptr<Object>
+			{
+				Params params(prototype);
+				binding.fill(&params, context);
+				return create(context, params);
+			};
+			if (!getTypes().insert(std::make_pair(name, std::move(type))).second)
+			{
+				throw std::runtime_error("GameSpace::ObjectFactory::add if (!inserted)");
+			}
+			return true;
+		}
+		/*
+			@brief	создание объектов одного уровня
+					строится один раз на уровень, дальше каждый объект создается
+					без поиска строк и без выделения памяти под свойства
+		*/
+		class Resolver final
+		{
+			std::unordered_map<std::uint32_t, Binding> m_bindings;	// номер строки имени типа - сопоставление
+		public:
+			/*
+				@brief сопоставляет зарегистрированные типы и имена свойств с таблицей строк уровня
+				@param level уровень
+			*/
+			explicit Resolver(const LevelData& level);
+			/*
+				@brief	создает объект карты
+						при отсутствии обязательного свойства бросает исключение
+				@ret   объект или nullptr, если тип не зарегистрирован
+			*/
+			std::shared_ptr<Object> create(const ObjectContext& context) const;
+		};
+	};
+}
+
+#endif // !OBJECTFACTORY_H
\ No newline at end of file
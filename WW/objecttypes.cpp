@@ -0,0 +1,176 @@
+#include "objectfactory.h"
+
+namespace GameSpace
+{
+	namespace
+	{
+		typedef LevelProperty::Type PT;
+		//////////////////////////////////////////////////////////////////////////
+		// тип player (игрок)
+		//////////////////////////////////////////////////////////////////////////
+		struct PlayerParams
+		{
+			const char* m_config;	// файл конфигурации игрока
+		};
+		const bool playerRegistered = ObjectFactory::add<PlayerParams>("player",
+		{
+			{ "config", PT::PT_STRING, offsetof(PlayerParams, m_config), nullptr }
+		},
+		[](const ObjectContext& context, const PlayerParams& params) -> std::shared_ptr<Object>
+		{
+			const PlayerData& player = context.m_level.m_players.at(params.m_config);
+			const LevelLoader::Result& prepared = context.m_prepared;
+
+			// кадры анимации и HUD заданы относительно исходных изображений,
+			// а лежат на странице атласа
+			const TextureRegion& playerRegion = context.m_atlas.get(player.m_file);
+			Animation animator(player.m_animation.m_defaultFrame, player.m_animation.m_initState);
+			for (const auto& state : player.m_animation.m_states)
+			{
+				animator.setStateSpeed(state.m_state, state.m_speed);
+				for (const auto& frame : state.m_frames)
+				{
+					animator.addFrame(state.m_state, frame);
+				}
+			}
+			animator.translate(playerRegion.m_rect.left, playerRegion.m_rect.top);
+
+			const TextureRegion& hudRegion = context.m_atlas.get(player.m_hudFile);
+			sf::IntRect liveRect(player.m_liveRect);
+			liveRect.left += hudRegion.m_rect.left;
+			liveRect.top += hudRegion.m_rect.top;
+			sf::IntRect coinRect(player.m_coinRect);
+			coinRect.left += hudRegion.m_rect.left;
+			coinRect.top += hudRegion.m_rect.top;
+			const HUD playerHud(prepared.m_fonts.at(player.m_fontFile), player.m_fontSize, hudRegion.m_texture, liveRect, coinRect);
+
+			const PlayerSound playerSound(	prepared.m_sounds.at(player.m_stepSound),
+											prepared.m_sounds.at(player.m_jumpSound),
+											prepared.m_sounds.at(player.m_getLiveSound),
+											prepared.m_sounds.at(player.m_getCoinSound));
+
+			const sf::Vector2i center(context.getCenter(sf::Vector2i(animator.getDefaultFrame().width, animator.getDefaultFrame().height)));
+			return std::make_shared<PlayerObject>(	context.m_entities, playerRegion.m_texture, center.x, center.y,
+													animator, context.m_physWorld, player.m_density, player.m_friction,
+													player.m_xvelocity, player.m_yvelocity, playerHud, playerSound,
+													player.m_lives, player.m_winCoins);
+		});
+		//////////////////////////////////////////////////////////////////////////
+		// тип movable (перемещаемые объекты)
+		//////////////////////////////////////////////////////////////////////////
+		struct MovableParams
+		{
+			float m_density;	// плотность
+			float m_friction;	// трение
+		};
+		const bool movableRegistered = ObjectFactory::add<MovableParams>("movable",
+		{
+			{ "density", PT::PT_FLOAT, offsetof(MovableParams, m_density), nullptr },
+			{ "friction", PT::PT_FLOAT, offsetof(MovableParams, m_friction), nullptr }
+		},
+		[](const ObjectContext& context, const MovableParams& params) -> std::shared_ptr<Object>
+		{
+			const TextureRegion& tile = context.getTile();
+			const sf::Vector2i tileSize(tile.m_rect.width, tile.m_rect.height);
+			const sf::Vector2i center(context.getCenter(tileSize));
+			return std::make_shared<MoveObject>(context.m_entities, tile.m_texture,
+												center.x, center.y,
+												tile.m_rect.left, tile.m_rect.top, tileSize.x, tileSize.y,
+												context.m_physWorld,
+												params.m_density,
+												params.m_friction);
+		});
+		//////////////////////////////////////////////////////////////////////////
+		// тип platform (самодвигающиеся платформы)
+		//////////////////////////////////////////////////////////////////////////
+		struct PlatformParams
+		{
+			float m_dstX;		// значение назначения Х (левая граница)
+			float m_dstY;		// значение назначения У (нижняя граница)
+			float m_friction;	// трение верхней кромки
+			float m_speed;		// скорость
+		};
+		const bool platformRegistered = ObjectFactory::add<PlatformParams>("platform",
+		{
+			{ "dstx", PT::PT_FLOAT, offsetof(PlatformParams, m_dstX), nullptr },
+			{ "dsty", PT::PT_FLOAT, offsetof(PlatformParams, m_dstY), nullptr },
+			{ "friction", PT::PT_FLOAT, offsetof(PlatformParams, m_friction), nullptr },
+			{ "speed", PT::PT_FLOAT, offsetof(PlatformParams, m_speed), nullptr }
+		},
+		[](const ObjectContext& context, const PlatformParams& params) -> std::shared_ptr<Object>
+		{
+			const TextureRegion& tile = context.getTile();
+			const sf::Vector2i tileSize(tile.m_rect.width, tile.m_rect.height);
+			const sf::Vector2i center(context.getCenter(tileSize));
+			const int dstCenterX = static_cast<int>(params.m_dstX + tileSize.x / 2.0);
+			const int dstCenterY = static_cast<int>(params.m_dstY - tileSize.y / 2.0);
+			return std::make_shared<PlatformObject>(context.m_entities, tile.m_texture,
+													center.x, center.y,
+													tile.m_rect.left, tile.m_rect.top, tileSize.x, tileSize.y,
+													context.m_physWorld,
+													dstCenterX, dstCenterY,
+													params.m_friction,
+													params.m_speed);
+		});
+		//////////////////////////////////////////////////////////////////////////
+		// тип jumping (батут для прыжков)
+		//////////////////////////////////////////////////////////////////////////
+		struct JumpingParams
+		{
+			float m_friction;		// трение верхней кромки платформы
+			float m_restitution;	// упругость верхней кромки платформы
+		};
+		const bool jumpingRegistered = ObjectFactory::add<JumpingParams>("jumping",
+		{
+			{ "friction", PT::PT_FLOAT, offsetof(JumpingParams, m_friction), nullptr },
+			{ "restitution", PT::PT_FLOAT, offsetof(JumpingParams, m_restitution), nullptr }
+		},
+		[](const ObjectContext& context, const JumpingParams& params) -> std::shared_ptr<Object>
+		{
+			const TextureRegion& tile = context.getTile();
+			const sf::Vector2i tileSize(tile.m_rect.width, tile.m_rect.height);
+			const sf::Vector2i center(context.getCenter(tileSize));
+			return std::make_shared<JumpingObject>(	context.m_entities, tile.m_texture,
+													center.x, center.y,
+													tile.m_rect.left, tile.m_rect.top, tileSize.x, tileSize.y,
+													context.m_physWorld,
+													params.m_friction,
+													params.m_restitution);
+		});
+		//////////////////////////////////////////////////////////////////////////
+		// тип effect (объект-эффект)
+		//////////////////////////////////////////////////////////////////////////
+		struct EffectParams
+		{
+			float m_friction;		// трение объекта
+			float m_restitution;	// упругость объекта
+			std::int32_t m_live;	// бонус к жизни при касании
+			std::int32_t m_coin;	// бонус к монетам при касании
+			std::int32_t m_destroy;	// 1 - уничтожать после касания
+		};
+		const bool effectRegistered = ObjectFactory::add<EffectParams>("effect",
+		{
+			{ "friction", PT::PT_FLOAT, offsetof(EffectParams, m_friction), nullptr },
+			{ "restitution", PT::PT_FLOAT, offsetof(EffectParams, m_restitution), nullptr },
+			{ "live", PT::PT_INT, offsetof(EffectParams, m_live), "0" },
+			{ "coin", PT::PT_INT, offsetof(EffectParams, m_coin), "0" },
+			{ "destroy", PT::PT_INT, offsetof(EffectParams, m_destroy), "0" }
+		},
+		[](const ObjectContext& context, const EffectParams& params) -> std::shared_ptr<Object>
+		{
+			const TextureRegion& tile = context.getTile();
+			const sf::Vector2i tileSize(tile.m_rect.width, tile.m_rect.height);
+			const sf::Vector2i center(context.getCenter(tileSize));
+			return std::make_shared<EffectObject>(	context.m_entities, tile.m_texture,
+													center.x, center.y,
+													tile.m_rect.left, tile.m_rect.top, tileSize.x, tileSize.y,
+													context.m_physWorld,
+													params.m_friction,
+													params.m_restitution,
+													params.m_live,
+													params.m_coin,
+													(params.m_destroy == 1));
+		});
+		//////////////////////////////////////////////////////////////////////////
+	}
+}
\ No newline at end of file
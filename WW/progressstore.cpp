@@ -0,0 +1,273 @@
+#include "progressstore.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t ProgressStore::m_magic = 0x50575757;	// "WWWP"
+	const std::uint32_t ProgressStore::m_version = 1;
+	//////////////////////////////////////////////////////////////////////////
+	ProgressStore::ProgressStore(const std::string& path)
+		: m_path(path), m_appended(false), m_compact(false), m_failed(false), m_stop(false)
+	{
+		// новые записи нельзя дописывать после оборванной, поэтому такой журнал
+		// переписывается первым делом, до очереди
+		m_compact = !read();
+		m_thread = std::thread(&ProgressStore::run, this);
+		if (m_compact)
+		{
+			m_wake.notify_one();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	ProgressStore::~ProgressStore()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+			// записи не повторяются, поэтому журнал сжимается один раз при закрытии
+			m_compact = m_compact || m_appended || !m_queue.empty();
+		}
+		m_wake.notify_all();
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool ProgressStore::read()
+	{
+		FILE* file = fopen(m_path.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+		std::vector<std::uint8_t> data;
+		std::uint8_t buffer[4096];
+		size_t count;
+		while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			data.insert(data.end(), buffer, buffer + count);
+		}
+		fclose(file);
+
+		BinaryReader reader(data.data(), data.size());
+		try
+		{
+			if (reader.readU32() != m_magic || reader.readU32() != m_version)
+			{
+				std::cerr << "Progress: " << m_path << " is not a progress journal, rewriting" << std::endl;
+				return false;
+			}
+			while (!reader.isEnd())
+			{
+				const std::string level(reader.readString());
+				if (reader.readU32() != checksum(level))
+				{
+					std::cerr << "Progress: " << m_path << " damaged record, rest is dropped" << std::endl;
+					return false;
+				}
+				m_completed.insert(level);
+			}
+		}
+		catch (const std::exception&)
+		{	// запись оборвана при записи
+			std::cerr << "Progress: " << m_path << " truncated record is dropped" << std::endl;
+			return false;
+		}
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ProgressStore::run()
+	{
+		for (;;)
+		{
+			std::vector<std::string> levels;
+			std::set<std::string> snapshot;
+			bool compacting = false;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this]()
+				{
+					return m_stop || !m_queue.empty() || (m_compact && !m_failed);
+				});
+				if (m_queue.empty() && (!m_compact || m_failed))
+				{
+					return;
+				}
+				levels.swap(m_queue);
+				compacting = m_compact;
+				if (compacting)
+				{	// сжатый журнал сразу содержит и очередь
+					snapshot = m_completed;
+					snapshot.insert(levels.begin(), levels.end());
+					levels.clear();
+				}
+			}
+
+			try
+			{
+				if (compacting)
+				{
+					compact(snapshot);
+				}
+				else
+				{
+					append(levels);
+				}
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_failed = false;
+				if (compacting)
+				{
+					m_appended = false;
+					m_compact = false;
+				}
+				else
+				{	// закрытие во время дописывания тоже сжимает журнал
+					m_appended = true;
+					m_compact = m_stop;
+				}
+			}
+			catch (const std::exception& e)
+			{	// прогресс остается в памяти, следующая попытка переписывает журнал целиком
+				std::cerr << "Progress: " << e.what() << std::endl;
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_compact = true;
+				m_failed = true;
+				if (m_stop)
+				{
+					return;
+				}
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ProgressStore::append(const std::vector<std::string>& levels) const
+	{
+		BinaryWriter writer;
+		for (const auto& level : levels)
+		{
+			writeRecord(writer, level);
+		}
+		FILE* file = fopen(m_path.c_str(), "ab");
+		if (!file)
+		{
+			throw std::runtime_error("GameSpace::ProgressStore::append if (!file)");
+		}
+		const bool written = writeDurable(file, writer.getData());
+		if (fclose(file) != 0 || !written)
+		{
+			throw std::runtime_error("GameSpace::ProgressStore::append if (!written)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ProgressStore::compact(const std::set<std::string>& levels) const
+	{
+		using namespace std;
+
+		BinaryWriter writer;
+		writer.writeU32(m_magic);
+		writer.writeU32(m_version);
+		for (const auto& level : levels)
+		{
+			writeRecord(writer, level);
+		}
+
+		const string temporary(m_path + ".tmp");
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw runtime_error("GameSpace::ProgressStore::compact if (!file)");
+		}
+		const bool written = writeDurable(file, writer.getData());
+		if (fclose(file) != 0 || !written)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::ProgressStore::compact if (!written)");
+		}
+#ifdef _WIN32
+		if (!MoveFileExA(temporary.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::ProgressStore::compact if (!MoveFileExA(...))");
+		}
+#else
+		if (rename(temporary.c_str(), m_path.c_str()) != 0)
+		{
+			remove(temporary.c_str());
+			throw runtime_error("GameSpace::ProgressStore::compact if (rename(...) != 0)");
+		}
+		// переименование надежно только после сброса каталога
+		const size_t slash = m_path.find_last_of('/');
+		const string directory(slash == string::npos ? string(".") : m_path.substr(0, slash + 1));
+		const int handle = open(directory.c_str(), O_RDONLY);
+		if (handle >= 0)
+		{
+			fsync(handle);
+			::close(handle);
+		}
+#endif
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ProgressStore::writeRecord(BinaryWriter& writer, const std::string& level)
+	{
+		writer.writeString(level);
+		writer.writeU32(checksum(level));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint32_t ProgressStore::checksum(const std::string& value)
+	{
+		std::uint32_t hash = 2166136261u;
+		for (const char c : value)
+		{
+			hash ^= static_cast<std::uint8_t>(c);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool ProgressStore::writeDurable(FILE* file, const std::vector<std::uint8_t>& data)
+	{
+		if (fwrite(data.data(), 1, data.size(), file) != data.size() || fflush(file) != 0)
+		{
+			return false;
+		}
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ProgressStore::markCompleted(const std::string& levelFile)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_completed.insert(levelFile).second)
+			{
+				return;
+			}
+			m_queue.push_back(levelFile);
+		}
+		m_wake.notify_one();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool ProgressStore::isCompleted(const std::string& levelFile) const
+	{
+		return m_completed.find(levelFile) != m_completed.end();
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
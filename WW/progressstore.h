@@ -0,0 +1,102 @@
+#ifndef PROGRESSSTORE_H
+#define PROGRESSSTORE_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <iostream>
+
+#include "binarystream.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	прогресс прохождения в отдельном журнале (.wwp)
+				пройденные уровни дописываются в конец журнала фоновым потоком,
+				поэтому кадр с победой не ждет диска,
+				каждая запись защищена контрольной суммой и сбрасывается на диск,
+				оборванная при падении запись отбрасывается при чтении,
+				журнал переписывается заново через временный файл и атомарное переименование
+				при закрытии, если в него дописывали, и после поврежденной или неудачной записи
+	*/
+	class ProgressStore final
+	{
+		static const std::uint32_t m_magic;
+		static const std::uint32_t m_version;
+
+		std::string m_path;
+
+		// общие с фоновым потоком, под m_mutex
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::set<std::string> m_completed;	// меняется только потоком игры, поэтому он читает без блокировки
+		std::vector<std::string> m_queue;	// еще не записанные уровни
+		bool m_appended;					// в журнал дописывали, при закрытии он переписывается
+		bool m_compact;						// переписать журнал перед дописыванием
+		bool m_failed;						// последняя запись не удалась, ждать новых уровней
+		bool m_stop;
+		std::thread m_thread;
+
+		ProgressStore(const ProgressStore&) = delete;
+		ProgressStore& operator=(const ProgressStore&) = delete;
+		/*
+			@brief фоновый поток: сжимает журнал и дописывает очередь
+		*/
+		void run();
+		/*
+			@brief	читает журнал до первой поврежденной записи
+			@ret   прочитаны ли все записи без повреждений
+		*/
+		bool read();
+		/*
+			@brief дописывает уровни в конец журнала и сбрасывает их на диск
+		*/
+		void append(const std::vector<std::string>& levels) const;
+		/*
+			@brief переписывает журнал через временный файл, по записи на уровень
+		*/
+		void compact(const std::set<std::string>& levels) const;
+		/*
+			@brief запись журнала: имя уровня и контрольная сумма
+		*/
+		static void writeRecord(BinaryWriter& writer, const std::string& level);
+		/*
+			@brief FNV-1a
+		*/
+		static std::uint32_t checksum(const std::string& value);
+		/*
+			@brief	дописывает данные в файл и сбрасывает их на диск
+			@ret   удалось ли
+		*/
+		static bool writeDurable(FILE* file, const std::vector<std::uint8_t>& data);
+	public:
+		/*
+			@brief	читает журнал и запускает поток записи,
+					отсутствующий или поврежденный журнал переписывается
+			@param path путь к журналу
+		*/
+		explicit ProgressStore(const std::string& path);
+		/*
+			@brief	переписывает журнал с оставшейся очередью, если в него дописывали,
+					и останавливает поток
+		*/
+		~ProgressStore();
+		/*
+			@brief	отмечает уровень пройденным, запись на диск выполняется в фоне
+			@param levelFile файл уровня, как в config.xml
+		*/
+		void markCompleted(const std::string& levelFile);
+		/*
+			@brief пройден ли уровень
+		*/
+		bool isCompleted(const std::string& levelFile) const;
+	};
+}
+
+#endif // !PROGRESSSTORE_H
\ No newline at end of file
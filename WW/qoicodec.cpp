@@ -0,0 +1,251 @@
+#include "qoicodec.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		const std::uint8_t opIndex = 0x00;	// 00xxxxxx
+		const std::uint8_t opDiff = 0x40;	// 01xxxxxx
+		const std::uint8_t opLuma = 0x80;	// 10xxxxxx
+		const std::uint8_t opRun = 0xC0;	// 11xxxxxx
+		const std::uint8_t opRgb = 0xFE;
+		const std::uint8_t opRgba = 0xFF;
+		const std::uint8_t opMask = 0xC0;
+
+		inline unsigned hash(const std::uint8_t* px)
+		{
+			return (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63;
+		}
+		inline std::uint32_t readBE(const std::uint8_t* data)
+		{
+			return	(static_cast<std::uint32_t>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+		}
+		inline void writeBE(std::vector<std::uint8_t>& out, std::uint32_t value)
+		{
+			out.push_back(static_cast<std::uint8_t>(value >> 24));
+			out.push_back(static_cast<std::uint8_t>(value >> 16));
+			out.push_back(static_cast<std::uint8_t>(value >> 8));
+			out.push_back(static_cast<std::uint8_t>(value));
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t QoiCodec::m_magic = 0x716F6966;
+	const std::uint32_t QoiCodec::m_maxPixels = 400000000;
+	//////////////////////////////////////////////////////////////////////////
+	bool QoiCodec::isQoi(const std::uint8_t* data, size_t size)
+	{
+		return data && size >= m_headerSize && readBE(data) == m_magic;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool QoiCodec::hasExtension(const std::string& path)
+	{
+		if (path.size() < 4)
+		{
+			return false;
+		}
+		std::string extension(path.substr(path.size() - 4));
+		for (auto& c : extension)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = c - 'A' + 'a';
+			}
+		}
+		return extension == ".qoi";
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void QoiCodec::decode(	const std::uint8_t* data, size_t size, unsigned& width, unsigned& height,
+							std::vector<std::uint8_t>& pixels)
+	{
+		if (!isQoi(data, size) || size < m_headerSize + m_endSize)
+		{
+			throw std::runtime_error("GameSpace::QoiCodec::decode if (!isQoi(data, size))");
+		}
+		width = readBE(data + 4);
+		height = readBE(data + 8);
+		if (!width || !height || height > m_maxPixels / width)
+		{
+			throw std::runtime_error("GameSpace::QoiCodec::decode if (height > m_maxPixels / width)");
+		}
+
+		const size_t total = static_cast<size_t>(width) * height * 4;
+		pixels.resize(total);
+		std::uint8_t* out = pixels.data();
+		std::uint8_t index[64 * 4] = {};
+		std::uint8_t px[4] = { 0, 0, 0, 255 };
+
+		// маркер конца не читается как код, поэтому внутри цикла хватает проверки одного байта на код
+		const std::uint8_t* it = data + m_headerSize;
+		const std::uint8_t* end = data + size - m_endSize;
+		unsigned run = 0;
+		for (size_t pos = 0; pos < total; pos += 4)
+		{
+			if (run > 0)
+			{
+				--run;
+			}
+			else
+			{
+				if (it >= end)
+				{
+					throw std::runtime_error("GameSpace::QoiCodec::decode if (it >= end)");
+				}
+				const std::uint8_t op = *it++;
+				if (op == opRgb)
+				{
+					px[0] = it[0];
+					px[1] = it[1];
+					px[2] = it[2];
+					it += 3;
+				}
+				else if (op == opRgba)
+				{
+					px[0] = it[0];
+					px[1] = it[1];
+					px[2] = it[2];
+					px[3] = it[3];
+					it += 4;
+				}
+				else
+				{
+					switch (op & opMask)
+					{
+					case opIndex:
+					{
+						const std::uint8_t* cached = &index[(op & 63) * 4];
+						px[0] = cached[0];
+						px[1] = cached[1];
+						px[2] = cached[2];
+						px[3] = cached[3];
+						break;
+					}
+					case opDiff:
+						px[0] += ((op >> 4) & 3) - 2;
+						px[1] += ((op >> 2) & 3) - 2;
+						px[2] += (op & 3) - 2;
+						break;
+					case opLuma:
+					{
+						const int dg = (op & 63) - 32;
+						const std::uint8_t next = *it++;
+						px[0] += dg - 8 + ((next >> 4) & 15);
+						px[1] += dg;
+						px[2] += dg - 8 + (next & 15);
+						break;
+					}
+					default:	// opRun
+						run = op & 63;
+						break;
+					}
+				}
+				std::uint8_t* cached = &index[hash(px) * 4];
+				cached[0] = px[0];
+				cached[1] = px[1];
+				cached[2] = px[2];
+				cached[3] = px[3];
+			}
+			out[pos] = px[0];
+			out[pos + 1] = px[1];
+			out[pos + 2] = px[2];
+			out[pos + 3] = px[3];
+		}
+		if (it > end)
+		{	// последний код залез на маркер конца
+			throw std::runtime_error("GameSpace::QoiCodec::decode if (it > end)");
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void QoiCodec::encode(const std::uint8_t* pixels, unsigned width, unsigned height, std::vector<std::uint8_t>& out)
+	{
+		if (!width || !height || height > m_maxPixels / width)
+		{
+			throw std::runtime_error("GameSpace::QoiCodec::encode if (height > m_maxPixels / width)");
+		}
+		writeBE(out, m_magic);
+		writeBE(out, width);
+		writeBE(out, height);
+		out.push_back(4);	// RGBA
+		out.push_back(0);	// sRGB с линейной альфой
+
+		std::uint8_t index[64 * 4] = {};
+		std::uint8_t prev[4] = { 0, 0, 0, 255 };
+		unsigned run = 0;
+		const size_t total = static_cast<size_t>(width) * height * 4;
+		for (size_t pos = 0; pos < total; pos += 4)
+		{
+			const std::uint8_t* px = pixels + pos;
+			if (px[0] == prev[0] && px[1] == prev[1] && px[2] == prev[2] && px[3] == prev[3])
+			{
+				++run;
+				if (run == 62 || pos + 4 == total)
+				{
+					out.push_back(static_cast<std::uint8_t>(opRun | (run - 1)));
+					run = 0;
+				}
+				continue;
+			}
+			if (run > 0)
+			{
+				out.push_back(static_cast<std::uint8_t>(opRun | (run - 1)));
+				run = 0;
+			}
+
+			const unsigned slot = hash(px);
+			std::uint8_t* cached = &index[slot * 4];
+			if (cached[0] == px[0] && cached[1] == px[1] && cached[2] == px[2] && cached[3] == px[3])
+			{
+				out.push_back(static_cast<std::uint8_t>(opIndex | slot));
+			}
+			else
+			{
+				cached[0] = px[0];
+				cached[1] = px[1];
+				cached[2] = px[2];
+				cached[3] = px[3];
+				if (px[3] == prev[3])
+				{
+					const int dr = static_cast<std::int8_t>(px[0] - prev[0]);
+					const int dg = static_cast<std::int8_t>(px[1] - prev[1]);
+					const int db = static_cast<std::int8_t>(px[2] - prev[2]);
+					const int drg = dr - dg;
+					const int dbg = db - dg;
+					if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+					{
+						out.push_back(static_cast<std::uint8_t>(opDiff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+					}
+					else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7)
+					{
+						out.push_back(static_cast<std::uint8_t>(opLuma | (dg + 32)));
+						out.push_back(static_cast<std::uint8_t>(((drg + 8) << 4) | (dbg + 8)));
+					}
+					else
+					{
+						out.push_back(opRgb);
+						out.push_back(px[0]);
+						out.push_back(px[1]);
+						out.push_back(px[2]);
+					}
+				}
+				else
+				{
+					out.push_back(opRgba);
+					out.push_back(px[0]);
+					out.push_back(px[1]);
+					out.push_back(px[2]);
+					out.push_back(px[3]);
+				}
+			}
+			prev[0] = px[0];
+			prev[1] = px[1];
+			prev[2] = px[2];
+			prev[3] = px[3];
+		}
+		for (size_t i = 0; i < m_endSize - 1; ++i)
+		{
+			out.push_back(0);
+		}
+		out.push_back(1);
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef QOICODEC_H
+#define QOICODEC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace GameSpace
+{
+	/*
+		@brief	изображения в формате QOI (qoiformat.org)
+				формат без потерь, декодируется за один проход без таблиц Хаффмана,
+				поэтому в разы быстрее PNG; пиксели всегда RGBA без умножения на альфу,
+				как в sf::Image
+	*/
+	class QoiCodec final
+	{
+		static const std::uint32_t m_magic;		// "qoif"
+		static const size_t m_headerSize = 14;
+		static const size_t m_endSize = 8;		// 7 нулей и 1
+		static const std::uint32_t m_maxPixels;	// защита от переполнения размера
+
+		QoiCodec() = delete;
+	public:
+		/*
+			@brief начинаются ли данные с заголовка QOI
+		*/
+		static bool isQoi(const std::uint8_t* data, size_t size);
+		/*
+			@brief имеет ли путь расширение .qoi
+		*/
+		static bool hasExtension(const std::string& path);
+		/*
+			@brief	декодирует изображение, поврежденные данные бросают исключение
+			@param data данные файла
+			@param size размер
+			@param width ширина результата
+			@param height высота результата
+			@param pixels пиксели RGBA построчно
+		*/
+		static void decode(	const std::uint8_t* data, size_t size, unsigned& width, unsigned& height,
+							std::vector<std::uint8_t>& pixels);
+		/*
+			@brief кодирует изображение
+			@param pixels пиксели RGBA построчно
+			@param width ширина
+			@param height высота
+			@param out буфер, к которому дописывается файл
+		*/
+		static void encode(const std::uint8_t* pixels, unsigned width, unsigned height, std::vector<std::uint8_t>& out);
+	};
+}
+
+#endif // !QOICODEC_H
\ No newline at end of file
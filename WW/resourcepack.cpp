@@ -0,0 +1,134 @@
+#include "resourcepack.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint32_t ResourcePack::m_magic = 0x4B415057;	// "WPAK"
+	const std::uint32_t ResourcePack::m_version = 1;
+	const size_t ResourcePack::m_alignment = 4096;
+	const std::uint32_t ResourcePack::m_deflated = 1;
+	const std::uint32_t ResourcePack::m_qoi = 2;
+	const std::uint64_t ResourcePack::m_maxRatio = 1032;
+	//////////////////////////////////////////////////////////////////////////
+	bool ResourcePack::open(const std::string& path)
+	{
+		m_entries.clear();
+		if (!m_file.open(path))
+		{
+			return false;
+		}
+		m_path = path;
+
+		BinaryReader reader(m_file.getData(), m_file.getSize());
+		if (reader.readU32() != m_magic)
+		{
+			throw std::runtime_error("GameSpace::ResourcePack::open if (reader.readU32() != m_magic)");
+		}
+		if (reader.readU32() != m_version)
+		{
+			throw std::runtime_error("GameSpace::ResourcePack::open if (reader.readU32() != m_version)");
+		}
+		const std::uint32_t count = reader.readU32();
+		reader.readU32();
+		// запись оглавления: имя, флаги, смещение, два размера и время
+		const size_t entrySize = 2 * sizeof(std::uint32_t) + 4 * sizeof(std::uint64_t);
+		if (count > reader.getRemaining() / entrySize)
+		{
+			throw std::runtime_error("GameSpace::ResourcePack::open if (count > reader.getRemaining() / entrySize)");
+		}
+
+		m_entries.reserve(count);
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			Entry entry;
+			entry.m_name = reader.readString();
+			entry.m_flags = reader.readU32();
+			entry.m_offset = reader.readU64();
+			entry.m_size = reader.readU64();
+			entry.m_packedSize = reader.readU64();
+			entry.m_modified = reader.readI64();
+
+			if (entry.m_offset > m_file.getSize() || entry.m_packedSize > m_file.getSize() - entry.m_offset)
+			{
+				throw std::runtime_error("GameSpace::ResourcePack::open if (entry.m_offset + entry.m_packedSize > m_file.getSize())");
+			}
+			// размер данных задает память под распаковку, поэтому он ограничивается сжатым размером
+			if ((entry.m_flags & m_deflated) ?	entry.m_size > entry.m_packedSize * m_maxRatio :
+												entry.m_size != entry.m_packedSize)
+			{
+				throw std::runtime_error("GameSpace::ResourcePack::open if (!entry.m_size)");
+			}
+			if (!m_entries.empty() && !(m_entries.back().m_name < entry.m_name))
+			{	// двоичный поиск требует строгого порядка
+				throw std::runtime_error("GameSpace::ResourcePack::open if (!sorted)");
+			}
+			m_entries.push_back(entry);
+		}
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const ResourcePack::Entry* ResourcePack::find(const std::string& name) const
+	{
+		auto itEntry = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+			[](const Entry& entry, const std::string& key)
+			{
+				return entry.m_name < key;
+			});
+		if (itEntry == m_entries.end() || itEntry->m_name != name)
+		{
+			return nullptr;
+		}
+		return &*itEntry;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::uint8_t* ResourcePack::getData(const Entry& entry) const
+	{
+		return m_file.getData() + entry.m_offset;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::vector<ResourcePack::Entry>& ResourcePack::getEntries() const
+	{
+		return m_entries;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::string& ResourcePack::getPath() const
+	{
+		return m_path;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::string ResourcePack::normalize(const std::string& path)
+	{
+		std::string result(path);
+		std::replace(result.begin(), result.end(), '\\', '/');
+		while (result.compare(0, 2, "./") == 0)
+		{
+			result.erase(0, 2);
+		}
+		return result;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ResourcePack::writeIndex(BinaryWriter& writer, const std::vector<Entry>& entries)
+	{
+		writer.writeU32(m_magic);
+		writer.writeU32(m_version);
+		writer.writeU32(static_cast<std::uint32_t>(entries.size()));
+		writer.writeU32(0);
+		for (const auto& entry : entries)
+		{
+			writer.writeString(entry.m_name);
+			writer.writeU32(entry.m_flags);
+			writer.writeU64(entry.m_offset);
+			writer.writeU64(entry.m_size);
+			writer.writeU64(entry.m_packedSize);
+			writer.writeI64(entry.m_modified);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint64_t ResourcePack::getIndexSize(const std::vector<Entry>& entries)
+	{
+		BinaryWriter writer;
+		writeIndex(writer, entries);
+		return writer.getData().size();
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef RESOURCEPACK_H
+#define RESOURCEPACK_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include "mappedfile.h"
+#include "binarystream.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	архив ресурсов (.pak), отображенный в память
+				формат: заголовок, оглавление, отсортированное по имени,
+				затем данные, каждая запись выровнена на m_alignment байт,
+				запись может быть сжата deflate в обертке zlib
+	*/
+	class ResourcePack final
+	{
+	public:
+		static const std::uint32_t m_magic;
+		static const std::uint32_t m_version;
+		static const size_t m_alignment;		// выравнивание данных записей
+		static const std::uint32_t m_deflated;	// флаг записи: данные сжаты
+		static const std::uint32_t m_qoi;		// флаг записи: изображение перекодировано в QOI, имя прежнее
+		static const std::uint64_t m_maxRatio;	// наибольшая степень сжатия deflate
+
+		// @brief запись оглавления
+		struct Entry
+		{
+			std::string m_name;			// путь с прямыми слешами
+			std::uint32_t m_flags;
+			std::uint64_t m_offset;		// от начала архива
+			std::uint64_t m_size;		// размер данных
+			std::uint64_t m_packedSize;	// размер в архиве
+			std::int64_t m_modified;	// время изменения исходного файла
+		};
+	private:
+		std::string m_path;
+		MappedFile m_file;
+		std::vector<Entry> m_entries;
+
+		ResourcePack(const ResourcePack&) = delete;
+		ResourcePack& operator=(const ResourcePack&) = delete;
+	public:
+		ResourcePack() = default;
+		~ResourcePack() = default;
+		/*
+			@brief	отображает архив и читает оглавление
+			@param path путь к архиву
+			@ret   существует ли архив, поврежденный архив бросает исключение
+		*/
+		bool open(const std::string& path);
+		/*
+			@brief ищет запись двоичным поиском
+			@param name нормализованное имя
+			@ret   запись или nullptr
+		*/
+		const Entry* find(const std::string& name) const;
+		/*
+			@brief данные записи в отображенном архиве (сжатые, если есть m_deflated)
+		*/
+		const std::uint8_t* getData(const Entry& entry) const;
+		/*
+			@brief все записи в порядке имен
+		*/
+		const std::vector<Entry>& getEntries() const;
+		/*
+			@brief путь к архиву
+		*/
+		const std::string& getPath() const;
+		/*
+			@brief	приводит путь к виду имени записи
+					обратные слеши заменяются прямыми, "./" в начале отбрасывается
+		*/
+		static std::string normalize(const std::string& path);
+		/*
+			@brief записывает заголовок и оглавление, смещения записей должны быть уже заданы
+			@param writer поток
+			@param entries записи, отсортированные по имени
+		*/
+		static void writeIndex(BinaryWriter& writer, const std::vector<Entry>& entries);
+		/*
+			@brief	размер заголовка с оглавлением, с которого начинаются данные
+			@param entries записи
+		*/
+		static std::uint64_t getIndexSize(const std::vector<Entry>& entries);
+	};
+}
+
+#endif // !RESOURCEPACK_H
\ No newline at end of file
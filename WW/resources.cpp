@@ -0,0 +1,138 @@
+#include "resources.h"
+
+#include <SFML/Graphics.hpp>
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	std::vector<std::unique_ptr<ResourcePack>> Resources::m_packs;
+	//////////////////////////////////////////////////////////////////////////
+	bool Resources::mount(const std::string& path)
+	{
+		std::unique_ptr<ResourcePack> pack(new ResourcePack);
+		if (!pack->open(path))
+		{
+			return false;
+		}
+		m_packs.push_back(std::move(pack));
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const ResourcePack::Entry* Resources::findEntry(const std::string& path, const ResourcePack*& pack)
+	{
+		if (m_packs.empty())
+		{
+			return nullptr;
+		}
+		const std::string name(ResourcePack::normalize(path));
+		for (auto itPack = m_packs.rbegin(); itPack != m_packs.rend(); ++itPack)
+		{
+			if (const ResourcePack::Entry* entry = (*itPack)->find(name))
+			{
+				pack = itPack->get();
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	ResourcePtr Resources::open(const std::string& path)
+	{
+		std::shared_ptr<ResourceData> result = std::make_shared<ResourceData>();
+		if (result->m_file.open(path))
+		{
+			result->m_data = result->m_file.getData();
+			result->m_size = result->m_file.getSize();
+			return result;
+		}
+
+		const ResourcePack* pack = nullptr;
+		const ResourcePack::Entry* entry = findEntry(path, pack);
+		if (!entry)
+		{
+			return nullptr;
+		}
+		const std::uint8_t* data = pack->getData(*entry);
+		result->m_flags = entry->m_flags;
+		if (entry->m_flags & ResourcePack::m_deflated)
+		{
+			result->m_buffer.reserve(static_cast<size_t>(entry->m_size));
+			Inflater::inflateZlib(data, static_cast<size_t>(entry->m_packedSize), result->m_buffer);
+			if (result->m_buffer.size() != entry->m_size)
+			{
+				throw std::runtime_error("GameSpace::Resources::open if (result->m_buffer.size() != entry->m_size)");
+			}
+			result->m_data = result->m_buffer.data();
+			result->m_size = result->m_buffer.size();
+		}
+		else
+		{	// без копирования: данные остаются в отображенном архиве
+			result->m_data = data;
+			result->m_size = static_cast<size_t>(entry->m_size);
+		}
+		return result;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool Resources::exists(const std::string& path)
+	{
+		std::int64_t modified = 0;
+		return getModifiedTime(path, modified);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool Resources::getModifiedTime(const std::string& path, std::int64_t& result)
+	{
+		if (MappedFile::getModifiedTime(path, result))
+		{
+			return true;
+		}
+		const ResourcePack* pack = nullptr;
+		if (const ResourcePack::Entry* entry = findEntry(path, pack))
+		{
+			result = entry->m_modified;
+			return true;
+		}
+		return false;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool Resources::load(sf::Image& target, const std::string& path)
+	{
+		const ResourcePtr data = open(path);
+		if (!data)
+		{
+			return false;
+		}
+		if (!(data->getFlags() & ResourcePack::m_qoi) && !QoiCodec::hasExtension(path))
+		{
+			return target.loadFromMemory(data->getData(), data->getSize());
+		}
+		unsigned width = 0, height = 0;
+		std::vector<std::uint8_t> pixels;
+		QoiCodec::decode(data->getData(), data->getSize(), width, height, pixels);
+		target.create(width, height, pixels.data());
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool Resources::load(sf::Texture& target, const std::string& path)
+	{
+		const ResourcePtr data = open(path);
+		if (!data)
+		{
+			return false;
+		}
+		if (!(data->getFlags() & ResourcePack::m_qoi) && !QoiCodec::hasExtension(path))
+		{
+			return target.loadFromMemory(data->getData(), data->getSize());
+		}
+		unsigned width = 0, height = 0;
+		std::vector<std::uint8_t> pixels;
+		QoiCodec::decode(data->getData(), data->getSize(), width, height, pixels);
+		// пиксели сразу уходят в текстуру, без промежуточного sf::Image
+		if (!target.create(width, height))
+		{
+			return false;
+		}
+		target.update(pixels.data());
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include "mappedfile.h"
+#include "resourcepack.h"
+#include "inflate.h"
+#include "qoicodec.h"
+
+namespace sf
+{
+	class Image;
+	class Texture;
+}
+
+namespace GameSpace
+{
+	/*
+		@brief	содержимое ресурса в памяти
+				отдельный файл отображается, несжатая запись архива указывает
+				прямо в отображенный архив, сжатая распаковывается в буфер
+	*/
+	class ResourceData final
+	{
+		friend class Resources;
+
+		MappedFile m_file;
+		std::vector<std::uint8_t> m_buffer;
+		const std::uint8_t* m_data;
+		size_t m_size;
+		std::uint32_t m_flags;		// флаги записи архива, 0 для отдельного файла
+
+		ResourceData(const ResourceData&) = delete;
+		ResourceData& operator=(const ResourceData&) = delete;
+	public:
+		ResourceData() : m_data(nullptr), m_size(0), m_flags(0)
+		{}
+		const std::uint8_t* getData() const
+		{ return m_data; }
+		size_t getSize() const
+		{ return m_size; }
+		std::uint32_t getFlags() const
+		{ return m_flags; }
+	};
+	// @brief ресурс живет, пока на него ссылаются (sf::Font и sf::Music читают его позже)
+	typedef std::shared_ptr<const ResourceData> ResourcePtr;
+	/*
+		@brief	доступ к ресурсам игры по пути
+				отдельный файл на диске важнее записи архива (для модификаций),
+				из архивов побеждает подключенный последним,
+				архивы подключаются до запуска потоков загрузки
+	*/
+	class Resources final
+	{
+		static std::vector<std::unique_ptr<ResourcePack>> m_packs;
+
+		Resources() = delete;
+		/*
+			@brief ищет запись во всех архивах
+			@param pack архив, в котором найдена запись
+		*/
+		static const ResourcePack::Entry* findEntry(const std::string& path, const ResourcePack*& pack);
+	public:
+		/*
+			@brief подключает архив
+			@param path путь к .pak
+			@ret   найден ли архив
+		*/
+		static bool mount(const std::string& path);
+		/*
+			@brief открывает ресурс
+			@param path путь к файлу
+			@ret   данные или nullptr, если ресурса нет
+		*/
+		static ResourcePtr open(const std::string& path);
+		/*
+			@brief существует ли ресурс
+		*/
+		static bool exists(const std::string& path);
+		/*
+			@brief	время изменения отдельного файла или исходного файла записи архива
+			@ret   существует ли ресурс
+		*/
+		static bool getModifiedTime(const std::string& path, std::int64_t& result);
+		/*
+			@brief	загружает изображение
+					QOI выбирается по расширению .qoi или флагу записи m_qoi,
+					остальное (PNG и прочее) декодирует SFML
+			@ret   удалась ли загрузка, поврежденный QOI бросает исключение
+		*/
+		static bool load(sf::Image& target, const std::string& path);
+		/*
+			@brief загружает текстуру, формат выбирается так же, как для sf::Image
+		*/
+		static bool load(sf::Texture& target, const std::string& path);
+		/*
+			@brief	загружает объект SFML, который копирует данные при загрузке
+					(sf::SoundBuffer)
+			@param target объект с методом loadFromMemory
+			@param path путь к ресурсу
+			@ret   удалась ли загрузка
+		*/
+		template<class T>
+		static bool load(T& target, const std::string& path)
+		{
+			const ResourcePtr data = open(path);
+			return data && target.loadFromMemory(data->getData(), data->getSize());
+		}
+	};
+}
+
+#endif // !RESOURCES_H
\ No newline at end of file
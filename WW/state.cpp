@@ -30,10 +30,10 @@ namespace GameSpace
 		return m_nextState;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	State::State(sf::RenderWindow* render, GameSound* soundPlayer)
-		: m_render(render), m_soundPlayer(soundPlayer)
+	State::State(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets)
+		: m_render(render), m_soundPlayer(soundPlayer), m_assets(assets)
 	{
-		assert(m_render && m_soundPlayer);
+		assert(m_render && m_soundPlayer && m_assets);
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void State::setNextState(GameState state)
@@ -51,11 +51,15 @@ namespace GameSpace
 		return m_soundPlayer;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	// 
-	const float StateGame::m_lowFilter = 0.4f;
-
-	StateGame::StateGame(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig, World* gameWorld)
-		: State(render, soundPlayer), m_mainConfig(mainConfig), m_gameWorld(gameWorld), m_fdt(0.0f)
+	bool State::loadTexture(sf::Texture& texture, const std::string& path)
+	{
+		const ImagePtr image = m_assets->getImage(path);
+		return image && texture.loadFromImage(*image);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	// игра
+	StateGame::StateGame(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig, World* gameWorld)
+		: State(render, soundPlayer, assets), m_mainConfig(mainConfig), m_gameWorld(gameWorld)
 	{
 		assert(m_mainConfig && m_gameWorld);
 	}
@@ -65,14 +69,13 @@ namespace GameSpace
 		setNextState(GameState::GS_GAME);
 		getSoundPlayer()->play(GameState::GS_GAME);
 
-		m_fdt = 0.0f;
 		m_gameClock.restart();
 	}
 
 	GameState StateGame::update()
 	{
-		m_fdt = m_gameClock.restart().asSeconds() * m_lowFilter + m_fdt * (1 - m_lowFilter);
-		m_gameWorld->runGameTiming(m_fdt);
+		m_gameWorld->updateHotReload();
+		m_gameWorld->runGameTiming(m_gameClock.restart().asSeconds());
 
 		if (m_gameWorld->isFail())
 		{
@@ -103,21 +106,29 @@ namespace GameSpace
 		m_gameWorld->runDrawing(*getRender());
 	}
 	//////////////////////////////////////////////////////////////////////////
-	// 
-	StateFail::StateFail(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig)
-		: State(render, soundPlayer)
+	// проигрыш
+	std::vector<std::string> StateFail::getImages(const Config& config)
+	{
+		std::vector<std::string> images;
+		images.push_back(config.getFailConfig().m_backgroundImage);
+		images.push_back(config.getFailConfig().m_image);
+		return images;
+	}
+
+	StateFail::StateFail(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig)
+		: State(render, soundPlayer, assets)
 	{
 		assert(mainConfig);
 
 		getSoundPlayer()->setMusic(GameState::GS_GAMEFAIL, mainConfig->getFailConfig().m_sound);
 
-		if (!m_bgTexture.loadFromFile(mainConfig->getFailConfig().m_backgroundImage))
+		if (!loadTexture(m_bgTexture, mainConfig->getFailConfig().m_backgroundImage))
 		{
-			throw std::runtime_error("GameSpace::StateFail::StateFail if (!m_bgTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateFail::StateFail if (!loadTexture(m_bgTexture, ...))");
 		}
-		if (!m_infoTexture.loadFromFile(mainConfig->getFailConfig().m_image))
+		if (!loadTexture(m_infoTexture, mainConfig->getFailConfig().m_image))
 		{
-			throw std::runtime_error("GameSpace::StateFail::StateFail if (!m_infoTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateFail::StateFail if (!loadTexture(m_infoTexture, ...))");
 		}
 
 		m_background.setTexture(m_bgTexture, true);
@@ -156,22 +167,30 @@ namespace GameSpace
 		getRender()->draw(m_info);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	// 
+	// выйгрыш
 
-	StateWin::StateWin(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig)
-		: State(render, soundPlayer)
+	std::vector<std::string> StateWin::getImages(const Config& config)
 	{
-		assert(mainConfig);
+		std::vector<std::string> images;
+		images.push_back(config.getWinConfig().m_backgroundImage);
+		images.push_back(config.getWinConfig().m_image);
+		return images;
+	}
+
+	StateWin::StateWin(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig, World* gameWorld)
+		: State(render, soundPlayer, assets), m_mainConfig(mainConfig), m_gameWorld(gameWorld)
+	{
+		assert(mainConfig && gameWorld);
 
 		getSoundPlayer()->setMusic(GameState::GS_GAMEWIN, mainConfig->getWinConfig().m_sound);
 
-		if (!m_bgTexture.loadFromFile(mainConfig->getWinConfig().m_backgroundImage))
+		if (!loadTexture(m_bgTexture, mainConfig->getWinConfig().m_backgroundImage))
 		{
-			throw std::runtime_error("GameSpace::StateWin::StateWin if (!m_bgTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateWin::StateWin if (!loadTexture(m_bgTexture, ...))");
 		}
-		if (!m_infoTexture.loadFromFile(mainConfig->getWinConfig().m_image))
+		if (!loadTexture(m_infoTexture, mainConfig->getWinConfig().m_image))
 		{
-			throw std::runtime_error("GameSpace::StateWin::StateWin if (!m_infoTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateWin::StateWin if (!loadTexture(m_infoTexture, ...))");
 		}
 
 		m_background.setTexture(m_bgTexture);
@@ -184,6 +203,12 @@ namespace GameSpace
 	{
 		setNextState(GameState::GS_GAMEWIN);
 		getSoundPlayer()->play(GameState::GS_GAMEWIN);
+
+		// пока игрок смотрит на экран победы, следующий уровень готовится в фоне
+		if (const Config::LevelsConfig::Level* next = m_mainConfig->getNextLevel())
+		{
+			m_gameWorld->prefetch(next->m_levelFile);
+		}
 	}
 
 	void StateWin::stateEventProcessing(sf::Event& event)
@@ -210,25 +235,34 @@ namespace GameSpace
 		getRender()->draw(m_info);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	// 
-	StateMenu::StateMenu(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig)
-		: State(render, soundPlayer)
+	// меню
+	std::vector<std::string> StateMenu::getImages(const Config& config)
+	{
+		std::vector<std::string> images;
+		images.push_back(config.getMenuConfig().m_backgroundImage);
+		images.push_back(config.getMenuConfig().m_startImage);
+		images.push_back(config.getMenuConfig().m_exitImage);
+		return images;
+	}
+
+	StateMenu::StateMenu(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig)
+		: State(render, soundPlayer, assets)
 	{
 		assert(mainConfig);
 
 		getSoundPlayer()->setMusic(GameState::GS_MENU, mainConfig->getMenuConfig().m_sound);
 
-		if (!m_bgTexture.loadFromFile(mainConfig->getMenuConfig().m_backgroundImage))
+		if (!loadTexture(m_bgTexture, mainConfig->getMenuConfig().m_backgroundImage))
 		{
-			throw std::runtime_error("GameSpace::StateMenu::StateMenu if (!m_bgTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateMenu::StateMenu if (!loadTexture(m_bgTexture, ...))");
 		}
-		if (!m_startTexture.loadFromFile(mainConfig->getMenuConfig().m_startImage))
+		if (!loadTexture(m_startTexture, mainConfig->getMenuConfig().m_startImage))
 		{
-			throw std::runtime_error("GameSpace::StateMenu::StateMenu if (!m_startTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateMenu::StateMenu if (!loadTexture(m_startTexture, ...))");
 		}
-		if (!m_exitTexture.loadFromFile(mainConfig->getMenuConfig().m_exitImage))
+		if (!loadTexture(m_exitTexture, mainConfig->getMenuConfig().m_exitImage))
 		{
-			throw std::runtime_error("GameSpace::StateMenu::StateMenu if (!m_exitTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateMenu::StateMenu if (!loadTexture(m_exitTexture, ...))");
 		}
 
 		m_background.setTexture(m_bgTexture, true);
@@ -271,7 +305,7 @@ namespace GameSpace
 		m_background.setScale(viewDim.x / bgDim.width, viewDim.y / bgDim.height);
 		getRender()->draw(m_background);
 
-		const float ypart = viewDim.y / 4.0f;	// 1   + 2  + 1 
+		const float ypart = viewDim.y / 4.0f;	// 1 пустой спрайт + 2 значимых + 1 пустой
 		sf::Vector2f centerPos(topLeftPos.x + (viewDim.x / 2.0f), topLeftPos.y + ypart);
 
 		auto drawSprite = [&](sf::Sprite& m_sprite)
@@ -285,92 +319,232 @@ namespace GameSpace
 		drawSprite(m_exit);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	//  
-	StateLevel::LevelsImage::LevelsImage(const std::string& image)
-	{
-		if (!m_texture.loadFromFile(image))
-		{
-			throw std::runtime_error("GameSpace::StateLevel::LevelsImage::LevelsImage if (!m_texture.loadFromFile(image))");
-		}
-		m_sprite.setTexture(m_texture);
-	}
-	StateLevel::LevelsImage::LevelsImage(const LevelsImage& other)
-		: m_texture(other.m_texture), m_sprite(other.m_sprite)
+	// выбор уровня
+	const sf::Time StateLevel::m_loadBudget = sf::milliseconds(8);
+	const size_t StateLevel::m_uploadsPerFrame = 4;
+	const sf::Vector2u StateLevel::m_defaultThumbnail(256, 256);
+
+	std::vector<std::string> StateLevel::getImages(const Config& config)
 	{
-		m_sprite.setTexture(m_texture);
-	}
-	StateLevel::LevelsImage& StateLevel::LevelsImage::operator =(const LevelsImage& other)
-	{
-		if (this != &other)
-		{
-			m_texture = other.m_texture;
-			m_sprite = other.m_sprite;
-			m_sprite.setTexture(m_texture);
-		}
-		return *this;
+		// миниатюры не входят: они грузятся по мере прокрутки
+		std::vector<std::string> images;
+		images.push_back(config.getLevelsConfig().m_backgroundImage);
+		images.push_back(config.getLevelsConfig().m_loadImage);
+		return images;
 	}
 
-	StateLevel::StateLevel(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig, World* gameWorld)
-		: State(render, soundPlayer), m_mainConfig(mainConfig), m_gameWorld(gameWorld)
+	StateLevel::StateLevel(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig, World* gameWorld)
+		: State(render, soundPlayer, assets), m_mainConfig(mainConfig), m_gameWorld(gameWorld), m_firstLine(0)
 	{
 		assert(m_mainConfig && m_gameWorld);
 
 		getSoundPlayer()->setMusic(GameState::GS_LEVEL, mainConfig->getLevelsConfig().m_sound);
 
-		if (!m_bgTexture.loadFromFile(m_mainConfig->getLevelsConfig().m_backgroundImage))
+		if (!loadTexture(m_bgTexture, m_mainConfig->getLevelsConfig().m_backgroundImage))
 		{
-			throw std::runtime_error("GameSpace::StateLevel::StateLevel if (!m_bgTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateLevel::StateLevel if (!loadTexture(m_bgTexture, ...))");
 		}
 
 		m_background.setTexture(m_bgTexture, true);
 
-		if (!m_loadingTexture.loadFromFile(m_mainConfig->getLevelsConfig().m_loadImage))
+		if (!loadTexture(m_loadingTexture, m_mainConfig->getLevelsConfig().m_loadImage))
 		{
-			throw std::runtime_error("GameSpace::StateLevel::StateLevel if (!m_loadingTexture.loadFromFile(...))");
+			throw std::runtime_error("GameSpace::StateLevel::StateLevel if (!loadTexture(m_loadingTexture, ...))");
 		}
 		m_loading.setTexture(m_loadingTexture);
 		m_loading.setOrigin(m_loadingTexture.getSize().x / 2.0f, m_loadingTexture.getSize().y / 2.0f);
 
-		for (const auto& itLevel : m_mainConfig->getLevelsConfig().m_levels)
+		readIndex();
+
+		// ячейка атласа вмещает самую большую известную миниатюру
+		sf::Vector2u slotSize(0, 0);
+		for (const auto& size : m_thumbnailSizes)
+		{
+			slotSize.x = std::max(slotSize.x, size.x);
+			slotSize.y = std::max(slotSize.y, size.y);
+		}
+		if (!slotSize.x || !slotSize.y)
+		{
+			slotSize = m_defaultThumbnail;
+		}
+		// видимые строки и по строке сверху и снизу для прокрутки, с запасом вдвое
+		const size_t blockPerLine = static_cast<size_t>(std::max(m_mainConfig->getLevelsConfig().m_blockPerLine, 1));
+		const size_t linePerScreen = static_cast<size_t>(std::max(m_mainConfig->getLevelsConfig().m_linePerScreen, 1));
+		m_thumbnails.reset(new ThumbnailAtlas(slotSize, blockPerLine * (linePerScreen + 2) * 2));
+	}
+
+	void StateLevel::readIndex()
+	{
+		const auto& levels = m_mainConfig->getLevelsConfig().m_levels;
+		m_thumbnailSizes.assign(levels.size(), sf::Vector2u(0, 0));
+
+		const std::string& path = m_mainConfig->getLevelsConfig().m_index;
+		if (path.empty())
+		{
+			return;
+		}
+		std::vector<LevelIndex::Entry> entries;
+		try
+		{
+			entries = LevelIndex::read(path);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Levels: index " << path << " skipped (" << e.what() << ")" << std::endl;
+			return;
+		}
+
+		std::map<std::string, const LevelIndex::Entry*> byFile;
+		for (const auto& entry : entries)
+		{
+			byFile[entry.m_levelFile] = &entry;
+		}
+		size_t found = 0;
+		for (size_t i = 0; i < levels.size(); ++i)
+		{
+			const auto itEntry = byFile.find(levels[i].m_levelFile);
+			// запись устарела, если у уровня сменилась миниатюра
+			if (itEntry != byFile.end() && itEntry->second->m_image == levels[i].m_image)
+			{
+				m_thumbnailSizes[i] = sf::Vector2u(itEntry->second->m_imageWidth, itEntry->second->m_imageHeight);
+				++found;
+			}
+		}
+		if (Diagnostics::isEnabled())
+		{
+			std::cout << "Levels: " << levels.size() << " levels, " << found << " found in " << path << std::endl;
+		}
+	}
+
+	int StateLevel::getLineCount() const
+	{
+		const int blockPerLine = std::max(m_mainConfig->getLevelsConfig().m_blockPerLine, 1);
+		return (static_cast<int>(m_mainConfig->getLevelsConfig().m_levels.size()) + blockPerLine - 1) / blockPerLine;
+	}
+
+	void StateLevel::scrollTo(int firstLine)
+	{
+		const int maxFirstLine = std::max(getLineCount() - m_mainConfig->getLevelsConfig().m_linePerScreen, 0);
+		m_firstLine = std::min(std::max(firstLine, 0), maxFirstLine);
+	}
+
+	sf::FloatRect StateLevel::getCellRect(size_t index, const TextureRegion* region)
+	{
+		const sf::Vector2f viewDim = getRender()->getView().getSize();
+		const sf::Vector2f topLeftPos = getRender()->mapPixelToCoords(sf::Vector2i(0, 0));
+		const int blockPerLine = std::max(m_mainConfig->getLevelsConfig().m_blockPerLine, 1);
+		const float xpart = viewDim.x / (blockPerLine + 2.0f);										// 1 боковой + n значимых + 1 боковой
+		const float ypart = viewDim.y / (m_mainConfig->getLevelsConfig().m_linePerScreen + 2.0f);	// 1 верхний + k значимых + 1 нижний
+
+		const int column = static_cast<int>(index) % blockPerLine;
+		const int line = static_cast<int>(index) / blockPerLine - m_firstLine;
+		sf::Vector2f size(xpart * 0.8f, ypart * 0.8f);
+		if (region)
 		{
-			m_levels.emplace_back(itLevel.m_image);
+			size = sf::Vector2f(static_cast<float>(region->m_rect.width), static_cast<float>(region->m_rect.height));
 		}
+		else if (m_thumbnailSizes[index].x && m_thumbnailSizes[index].y)
+		{	// миниатюра больше ячейки атласа уменьшится так же
+			const sf::Vector2u slot(m_thumbnails->getSlotSize());
+			const float scale = std::min(1.0f, std::min(static_cast<float>(slot.x) / m_thumbnailSizes[index].x,
+														static_cast<float>(slot.y) / m_thumbnailSizes[index].y));
+			size = sf::Vector2f(m_thumbnailSizes[index].x * scale, m_thumbnailSizes[index].y * scale);
+		}
+		return sf::FloatRect(topLeftPos.x + xpart + column * xpart, topLeftPos.y + ypart + line * ypart, size.x, size.y);
+	}
+
+	bool StateLevel::isUnlocked(size_t index) const
+	{
+		return index == 0 || m_mainConfig->getLevelsConfig().m_levels.at(index - 1).m_isCompleted;
 	}
 
 	void StateLevel::statePrepare()
 	{
 		setNextState(GameState::GS_LEVEL);
 		getSoundPlayer()->play(GameState::GS_LEVEL);
+
+		// вероятнее всего игрок выберет следующий непройденный уровень,
+		// поэтому его строка должна быть видна
+		if (const Config::LevelsConfig::Level* next = m_mainConfig->getNextLevel())
+		{
+			m_gameWorld->prefetch(next->m_levelFile);
+
+			const int line = static_cast<int>(next - m_mainConfig->getLevelsConfig().m_levels.data()) /
+								std::max(m_mainConfig->getLevelsConfig().m_blockPerLine, 1);
+			if (line < m_firstLine || line >= m_firstLine + m_mainConfig->getLevelsConfig().m_linePerScreen)
+			{
+				scrollTo(line);
+			}
+		}
+	}
+
+	GameState StateLevel::update()
+	{
+		// загрузка продолжается между кадрами, события при этом обрабатываются
+		if (m_gameWorld->isLoading() && m_gameWorld->updateLoad(m_loadBudget))
+		{
+			setNextState(GameState::GS_GAME);
+		}
+		return State::update();
 	}
 
 	void StateLevel::stateEventProcessing(sf::Event& event)
 	{
+		if (m_gameWorld->isLoading())
+		{
+			if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
+			{
+				m_gameWorld->cancelLoad();
+			}
+			return;
+		}
+
+		const int linePerScreen = m_mainConfig->getLevelsConfig().m_linePerScreen;
 		if (event.type == sf::Event::MouseButtonPressed &&
 			event.mouseButton.button == sf::Mouse::Button::Left)
 		{
 			const auto coord = getRender()->mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
-			for (size_t i = 0; i < m_levels.size(); ++i)
+			const auto& levels = m_mainConfig->getLevelsConfig().m_levels;
+			const size_t blockPerLine = static_cast<size_t>(std::max(m_mainConfig->getLevelsConfig().m_blockPerLine, 1));
+			const size_t first = m_firstLine * blockPerLine;
+			const size_t last = std::min(levels.size(), first + linePerScreen * blockPerLine);
+			for (size_t i = first; i < last; ++i)
 			{
-				if (m_levels[i].m_sprite.getGlobalBounds().contains(coord) &&
-					(i == 0 || m_mainConfig->getLevelsConfig().m_levels.at(i - 1).m_isCompleted))
+				if (getCellRect(i, m_thumbnails->get(levels[i].m_image)).contains(coord) && isUnlocked(i))
 				{
-					m_loading.setPosition(getRender()->getView().getCenter());
-					getRender()->draw(m_loading);
-					getRender()->display();
-
-					getSoundPlayer()->setMusic(GameState::GS_GAME, m_mainConfig->getLevelsConfig().m_levels.at(i).m_levelSound);
-					m_gameWorld->loadFromFile(m_mainConfig->getLevelsConfig().m_levels.at(i).m_levelFile);
-					setNextState(GameState::GS_GAME);
+					getSoundPlayer()->setMusic(GameState::GS_GAME, levels.at(i).m_levelSound);
+					m_gameWorld->beginLoad(levels.at(i).m_levelFile);
+					m_loadingClock.restart();
 
 					break;
 				}
 			}
 		}
+		else if (event.type == sf::Event::MouseWheelMoved)
+		{
+			scrollTo(m_firstLine - event.mouseWheel.delta);
+		}
 		else if (event.type == sf::Event::KeyPressed)
 		{
-			if (event.key.code == sf::Keyboard::Escape)
+			switch (event.key.code)
 			{
+			case sf::Keyboard::Escape:
 				setNextState(GameState::GS_MENU);
+				break;
+			case sf::Keyboard::Up:
+				scrollTo(m_firstLine - 1);
+				break;
+			case sf::Keyboard::Down:
+				scrollTo(m_firstLine + 1);
+				break;
+			case sf::Keyboard::PageUp:
+				scrollTo(m_firstLine - linePerScreen);
+				break;
+			case sf::Keyboard::PageDown:
+				scrollTo(m_firstLine + linePerScreen);
+				break;
+			default:
+				break;
 			}
 		}
 	}
@@ -384,21 +558,71 @@ namespace GameSpace
 		m_background.setScale(viewDim.x / bgDim.width, viewDim.y / bgDim.height);
 		getRender()->draw(m_background);
 
-		const int blockPerLine = m_mainConfig->getLevelsConfig().m_blockPerLine;
-		const float xpart = viewDim.x / (m_mainConfig->getLevelsConfig().m_blockPerLine + 2.0f);	// 1  + n  + 1 
-		const float ypart = viewDim.y / (m_mainConfig->getLevelsConfig().m_linePerScreen + 2.0f);	// 1  + k  + 1 
+		// миниатюры, декодированные с прошлого кадра, переносятся в атлас
+		m_thumbnails->update(m_uploadsPerFrame);
+
+		const auto& levels = m_mainConfig->getLevelsConfig().m_levels;
+		const int blockPerLine = std::max(m_mainConfig->getLevelsConfig().m_blockPerLine, 1);
+		const int linePerScreen = m_mainConfig->getLevelsConfig().m_linePerScreen;
+		// строки сразу за краями не рисуются, но их миниатюры запрашиваются заранее
+		const size_t prefetchFirst = static_cast<size_t>(std::max(m_firstLine - 1, 0) * blockPerLine);
+		const size_t first = static_cast<size_t>(m_firstLine * blockPerLine);
+		const size_t last = std::min(levels.size(), static_cast<size_t>((m_firstLine + linePerScreen) * blockPerLine));
+		const size_t prefetchLast = std::min(levels.size(), last + blockPerLine);
 
-		for (size_t i = 0; i < m_levels.size(); ++i)
+		for (size_t i = prefetchFirst; i < prefetchLast; ++i)
 		{
-			m_levels[i].m_sprite.setColor(sf::Color::White);
-			m_levels[i].m_sprite.setPosition(	topleftPos.x + xpart + (i % blockPerLine)*xpart,
-												topleftPos.y + ypart + (i / blockPerLine)*ypart);
-			if (i > 0 && !m_mainConfig->getLevelsConfig().m_levels.at(i - 1).m_isCompleted)
+			const TextureRegion* region = m_thumbnails->get(levels[i].m_image);
+			if (i < first || i >= last)
+			{
+				continue;
+			}
+			const sf::FloatRect cell(getCellRect(i, region));
+			const sf::Color color(isUnlocked(i) ? sf::Color::White : sf::Color::Blue);
+			if (region)
 			{
-				m_levels[i].m_sprite.setColor(sf::Color::Blue);
+				m_thumbnail.setTexture(*region->m_texture);
+				m_thumbnail.setTextureRect(region->m_rect);
+				m_thumbnail.setPosition(cell.left, cell.top);
+				m_thumbnail.setColor(color);
+				getRender()->draw(m_thumbnail);
+			}
+			else
+			{	// пока миниатюра грузится, на ее месте полупрозрачная рамка
+				sf::RectangleShape placeholder(sf::Vector2f(cell.width, cell.height));
+				placeholder.setPosition(cell.left, cell.top);
+				placeholder.setFillColor(sf::Color(color.r, color.g, color.b, 64));
+				getRender()->draw(placeholder);
 			}
-			getRender()->draw(m_levels[i].m_sprite);
 		}
+
+		if (m_gameWorld->isLoading())
+		{
+			drawLoading();
+		}
+	}
+
+	void StateLevel::drawLoading()
+	{
+		const sf::Vector2f center = getRender()->getView().getCenter();
+		const sf::Vector2f viewDim = getRender()->getView().getSize();
+
+		m_loading.setPosition(center);
+		m_loading.setRotation(m_loadingClock.getElapsedTime().asSeconds() * 180.0f);
+		getRender()->draw(m_loading);
+
+		const sf::Vector2f barSize(viewDim.x / 2.0f, viewDim.y / 40.0f);
+		const sf::Vector2f barPos(center.x - barSize.x / 2.0f, center.y + m_loadingTexture.getSize().y / 2.0f + barSize.y);
+
+		sf::RectangleShape frame(barSize);
+		frame.setPosition(barPos);
+		frame.setFillColor(sf::Color(0, 0, 0, 128));
+		getRender()->draw(frame);
+
+		sf::RectangleShape bar(sf::Vector2f(barSize.x * m_gameWorld->getLoadProgress(), barSize.y));
+		bar.setPosition(barPos);
+		bar.setFillColor(sf::Color::White);
+		getRender()->draw(bar);
 	}
 	//////////////////////////////////////////////////////////////////////////
 }
\ No newline at end of file
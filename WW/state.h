@@ -2,6 +2,9 @@
 #define STATE_H
 
 #include <vector>
+#include <string>
+#include <memory>
+#include <map>
 #include <iostream>
 #include <cassert>
 
@@ -10,97 +13,108 @@
 #include "config.h"
 #include "world.h"
 #include "music.h"
+#include "assetcache.h"
+#include "thumbnailatlas.h"
+#include "levelindex.h"
 
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
 	enum class GameState
 	{
-		GS_GAME,		//  
-		GS_GAMEFAIL,	// 
-		GS_GAMEWIN,		// 
-		GS_MENU,		// 
-		GS_LEVEL,		//  
-		GS_EXIT			// 
+		GS_GAME,		// игровой процесс
+		GS_GAMEFAIL,	// проигрыш
+		GS_GAMEWIN,		// выигрыш
+		GS_MENU,		// меню
+		GS_LEVEL,		// выбор уровня
+		GS_EXIT			// выход
 	};
 	//////////////////////////////////////////////////////////////////////////
-	// ,      
+	// состояние, которое будет обрабатываться в момент времени
 	class State
 	{
 	public:
 		/*
-			@brief  
-			@ret    
+			@brief обновление состояния
+			@ret   новое состояние
 		*/
 		virtual GameState update();
 
 		/*
-			@brief   
-					     
+			@brief выполняет подготовку состояния
+					вызывается после переключения на это состояние
 		*/
 		virtual void statePrepare() = 0;
 
-		State(sf::RenderWindow* render, GameSound* soundPlayer);
+		State(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets);
 		virtual ~State() = default;
 	protected:
 		/*
-			@brief   
-			@param state  
+			@brief задает следующее состояние
+			@param state следующее состояние
 		*/
 		void setNextState(GameState state);
 		/*
-			@brief      
-			@ret       
+			@brief возвращает указатель на объект для отображения
+			@ret   указатель на объект для отображения
 		*/
 		sf::RenderWindow* getRender();
 		/*
-			@brief    
+			@brief возвращает указатель на проигрыватель
 		*/
 		GameSound* getSoundPlayer();
+		/*
+			@brief	загружает текстуру из изображения в кэше ресурсов
+					изображения состояний декодируются заранее в фоне,
+					поэтому здесь остается только передача в видеопамять
+			@param texture текстура
+			@param path путь к изображению
+			@ret   удалась ли загрузка
+		*/
+		bool loadTexture(sf::Texture& texture, const std::string& path);
 	private:
 		State(const State&) = delete;
 		State& operator=(const State&) = delete;
-		// ,   
+		// состояние, которое будет отдано
 		GameState m_nextState;
-		//   
+		// объект для отображения
 		sf::RenderWindow* m_render;
-		//       
+		// объект для проигрывания музыки в каждом состоянии
 		GameSound* m_soundPlayer;
+		// кэш изображений, общий с игровым миром
+		AssetCache* m_assets;
 		/*
-			@brief   
-			@param event 
+			@brief обрабатывает события состояния
+			@param event событие
 		*/
 		virtual void stateEventProcessing(sf::Event& event) = 0;
 		/*
-			@brief  
+			@brief обрабатывает прорисовку
 		*/
 		virtual void stateDrawing() = 0;
 		/*
-			@brief    
-					 stateEventProcessing  
-					    
+			@brief выполняет обработку асинхронных событий
+					вызывает stateEventProcessing для каждого
+					затем обрабатывает дополнительно событие завершения
 		*/
 		void eventProcessing();
 		/*
-			@brief   
+			@brief выполняет операцию прорисовки
 		*/
 		void drawing();
 	};
 	//////////////////////////////////////////////////////////////////////////
 	class StateGame : public State
 	{
-		static const float m_lowFilter;
-
 		Config* m_mainConfig;
 		World* m_gameWorld;
 
-		float m_fdt;
 		sf::Clock m_gameClock;
 
 		virtual void stateEventProcessing(sf::Event& event) override;
 		virtual void stateDrawing() override;
 	public:
-		StateGame(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig, World* gameWorld);
+		StateGame(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig, World* gameWorld);
 		virtual GameState update() override;
 		virtual void statePrepare() override;
 		virtual ~StateGame() = default;
@@ -117,13 +131,20 @@ namespace GameSpace
 		virtual void stateEventProcessing(sf::Event& event) override;
 		virtual void stateDrawing() override;
 	public:
-		StateFail(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig);
+		StateFail(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig);
+		/*
+			@brief изображения, которые загружает конструктор, для упреждающего декодирования
+		*/
+		static std::vector<std::string> getImages(const Config& config);
 		virtual void statePrepare() override;
 		virtual ~StateFail() = default;
 	};
 	//////////////////////////////////////////////////////////////////////////
 	class StateWin : public State
 	{
+		Config* m_mainConfig;
+		World* m_gameWorld;
+
 		sf::Texture m_bgTexture;
 		sf::Texture m_infoTexture;
 
@@ -133,7 +154,11 @@ namespace GameSpace
 		virtual void stateEventProcessing(sf::Event& event) override;
 		virtual void stateDrawing() override;
 	public:
-		StateWin(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig);
+		StateWin(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig, World* gameWorld);
+		/*
+			@brief изображения, которые загружает конструктор, для упреждающего декодирования
+		*/
+		static std::vector<std::string> getImages(const Config& config);
 		virtual void statePrepare() override;
 		virtual ~StateWin() = default;
 	};
@@ -151,7 +176,11 @@ namespace GameSpace
 		virtual void stateEventProcessing(sf::Event& event) override;
 		virtual void stateDrawing() override;
 	public:
-		StateMenu(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig);
+		StateMenu(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig);
+		/*
+			@brief изображения, которые загружает конструктор, для упреждающего декодирования
+		*/
+		static std::vector<std::string> getImages(const Config& config);
 		virtual void statePrepare() override;
 		virtual ~StateMenu() = default;
 	};
@@ -167,20 +196,57 @@ namespace GameSpace
 		sf::Sprite m_background;
 		sf::Sprite m_loading;
 
-		struct LevelsImage
-		{
-			sf::Texture m_texture;
-			sf::Sprite m_sprite;
-			LevelsImage(const std::string& image);
-			LevelsImage(const LevelsImage& other);
-			LevelsImage& operator=(const LevelsImage& other);
-		};
-		std::vector<LevelsImage> m_levels;	//    
+		/*
+			миниатюры грузятся в общий атлас только для видимых строк сетки,
+			размеры ячеек до загрузки берутся из оглавления уровней
+		*/
+		std::unique_ptr<ThumbnailAtlas> m_thumbnails;
+		std::vector<sf::Vector2u> m_thumbnailSizes;	// по уровням, 0 - неизвестен до загрузки
+		sf::Sprite m_thumbnail;						// один спрайт на все ячейки
+		int m_firstLine;							// первая видимая строка сетки
+
+		static const sf::Time m_loadBudget;		// время кадра на сборку уровня
+		static const size_t m_uploadsPerFrame;	// миниатюр в видеопамять за кадр
+		static const sf::Vector2u m_defaultThumbnail;	// размер ячейки атласа без оглавления
+		sf::Clock m_loadingClock;				// вращение изображения загрузки
 
 		virtual void stateEventProcessing(sf::Event& event) override;
 		virtual void stateDrawing() override;
+		/*
+			@brief рисует изображение загрузки и полосу прогресса
+		*/
+		void drawLoading();
+		/*
+			@brief	читает оглавление уровней, если оно задано
+					отсутствующее или устаревшее оглавление не мешает: размеры узнаются при загрузке
+		*/
+		void readIndex();
+		/*
+			@brief количество строк сетки
+		*/
+		int getLineCount() const;
+		/*
+			@brief	прокручивает сетку, чтобы первая строка была в допустимых пределах
+			@param firstLine желаемая первая видимая строка
+		*/
+		void scrollTo(int firstLine);
+		/*
+			@brief	прямоугольник ячейки уровня в координатах вида
+			@param index номер уровня, должен быть в видимых строках
+			@param region миниатюра, если уже загружена
+		*/
+		sf::FloatRect getCellRect(size_t index, const TextureRegion* region);
+		/*
+			@brief открыт ли уровень для выбора
+		*/
+		bool isUnlocked(size_t index) const;
 	public:
-		StateLevel(sf::RenderWindow* render, GameSound* soundPlayer, Config* mainConfig, World* gameWorld);
+		StateLevel(sf::RenderWindow* render, GameSound* soundPlayer, AssetCache* assets, Config* mainConfig, World* gameWorld);
+		/*
+			@brief изображения, которые загружает конструктор, для упреждающего декодирования
+		*/
+		static std::vector<std::string> getImages(const Config& config);
+		virtual GameState update() override;
 		virtual void statePrepare() override;
 		virtual ~StateLevel() = default;
 	};
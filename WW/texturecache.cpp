@@ -0,0 +1,84 @@
+#include "texturecache.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const unsigned TextureCache::m_headlessMaximumSize = 16384;
+	//////////////////////////////////////////////////////////////////////////
+	TextureCache::TextureCache()
+		: m_headless(false)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	TexturePtr TextureCache::get(const std::string& key, const sf::Image& source)
+	{
+		const size_t textureBytes = static_cast<size_t>(source.getSize().x) * source.getSize().y * 4;
+		++m_report.m_requests;
+
+		TexturePtr texture = m_textures[key].lock();
+		if (texture)
+		{
+			++m_report.m_hits;
+			m_report.m_bytesSaved += textureBytes;
+			return texture;
+		}
+
+		auto newTexture = std::make_shared<sf::Texture>();
+		if (m_headless)
+		{	// пустая текстура не создает контекст OpenGL
+			m_textures[key] = newTexture;
+			return newTexture;
+		}
+		if (!newTexture->loadFromImage(source))
+		{
+			throw std::runtime_error("GameSpace::TextureCache::get if (!newTexture->loadFromImage(source))");
+		}
+		++m_report.m_uploads;
+		m_report.m_bytesUploaded += textureBytes;
+
+		m_textures[key] = newTexture;
+		return newTexture;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureCache::setHeadless(bool headless)
+	{
+		m_headless = headless;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	unsigned TextureCache::getMaximumSize() const
+	{
+		return m_headless ? m_headlessMaximumSize : sf::Texture::getMaximumSize();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const TextureCache::Report& TextureCache::getReport() const
+	{
+		return m_report;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureCache::resetReport()
+	{
+		m_report = Report();
+		for (auto itTexture = m_textures.begin(); itTexture != m_textures.end();)
+		{
+			if (itTexture->second.expired())
+			{
+				itTexture = m_textures.erase(itTexture);
+			}
+			else
+			{
+				++itTexture;
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TextureCache::printReport(std::ostream& out) const
+	{
+		out << "Textures: " << m_report.m_requests << " requests, "
+			<< m_report.m_hits << " cache hits, "
+			<< m_report.m_uploads << " uploads, "
+			<< m_report.m_bytesUploaded / 1024 << " KB uploaded, "
+			<< m_report.m_bytesSaved / 1024 << " KB saved" << std::endl;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
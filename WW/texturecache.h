@@ -0,0 +1,81 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+
+#include <SFML/Graphics.hpp>
+
+namespace GameSpace
+{
+	// @brief разделяемая текстура, живет пока на нее ссылается хотя бы один объект
+	typedef std::shared_ptr<const sf::Texture> TexturePtr;
+	/*
+		@brief	реестр текстур с подсчетом ссылок
+				одно изображение загружается в видеопамять один раз,
+				все объекты с тем же ключом получают ту же текстуру
+	*/
+	class TextureCache final
+	{
+	public:
+		// @brief статистика загрузки
+		struct Report
+		{
+			size_t m_requests;		// всего запросов текстур
+			size_t m_hits;			// запросов, обслуженных из кэша
+			size_t m_uploads;		// текстур загружено в видеопамять
+			size_t m_bytesUploaded;	// байт загружено в видеопамять
+			size_t m_bytesSaved;	// байт, которые не пришлось загружать повторно
+			Report() : m_requests(0), m_hits(0), m_uploads(0), m_bytesUploaded(0), m_bytesSaved(0)
+			{}
+		};
+
+		TextureCache();
+		~TextureCache() = default;
+		/*
+			@brief возвращает текстуру по ключу, при отсутствии создает ее из изображения
+			@param key ключ текстуры (путь к изображению)
+			@param source изображение, из которого создается текстура при промахе
+			@ret   разделяемая текстура
+		*/
+		TexturePtr get(const std::string& key, const sf::Image& source);
+		/*
+			@brief	режим без видеокарты для прогона уровней без окна:
+					текстуры создаются пустыми и не загружаются в видеопамять,
+					участки атласа при этом размечаются как обычно
+			@param headless включить или выключить
+		*/
+		void setHeadless(bool headless);
+		/*
+			@brief наибольший размер стороны текстуры
+		*/
+		unsigned getMaximumSize() const;
+		/*
+			@brief статистика с момента последнего сброса
+		*/
+		const Report& getReport() const;
+		/*
+			@brief сбрасывает статистику и удаляет записи о выгруженных текстурах
+		*/
+		void resetReport();
+		/*
+			@brief выводит статистику в поток
+			@param out поток для вывода
+		*/
+		void printReport(std::ostream& out) const;
+	private:
+		TextureCache(const TextureCache&) = delete;
+		TextureCache& operator=(const TextureCache&) = delete;
+
+		// слабые ссылки: текстура выгружается вместе с последним владельцем
+		std::map<std::string, std::weak_ptr<const sf::Texture>> m_textures;
+		Report m_report;
+		bool m_headless;
+		static const unsigned m_headlessMaximumSize;
+	};
+}
+
+#endif // !TEXTURECACHE_H
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "thumbnailatlas.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	ThumbnailAtlas::ThumbnailAtlas(const sf::Vector2u& slotSize, size_t slotCount)
+		: m_slotSize(slotSize), m_columns(0), m_frame(0), m_stop(false)
+	{
+		if (!slotSize.x || !slotSize.y || !slotCount)
+		{
+			throw std::runtime_error("GameSpace::ThumbnailAtlas::ThumbnailAtlas if (!slotSize.x || !slotSize.y || !slotCount)");
+		}
+		// ячейки раскладываются в одну текстуру не больше допустимого размера
+		const unsigned maxSize = sf::Texture::getMaximumSize();
+		m_columns = static_cast<unsigned>(std::min<size_t>(slotCount, maxSize / slotSize.x));
+		unsigned rows = m_columns ? static_cast<unsigned>((slotCount + m_columns - 1) / m_columns) : 0;
+		rows = std::min(rows, maxSize / slotSize.y);
+		if (!m_columns || !rows)
+		{
+			throw std::runtime_error("GameSpace::ThumbnailAtlas::ThumbnailAtlas if (!m_columns || !rows)");
+		}
+
+		m_texture = std::make_shared<sf::Texture>();
+		if (!m_texture->create(m_columns * slotSize.x, rows * slotSize.y))
+		{
+			throw std::runtime_error("GameSpace::ThumbnailAtlas::ThumbnailAtlas if (!m_texture->create(...))");
+		}
+
+		m_slots.resize(std::min<size_t>(slotCount, static_cast<size_t>(m_columns) * rows));
+		for (auto& slot : m_slots)
+		{
+			slot.m_lastUse = 0;
+		}
+		m_thread = std::thread(&ThumbnailAtlas::run, this);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	ThumbnailAtlas::~ThumbnailAtlas()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ThumbnailAtlas::run()
+	{
+		for (;;)
+		{
+			std::string path;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this]()
+				{
+					return m_stop || !m_requests.empty();
+				});
+				if (m_stop)
+				{
+					return;
+				}
+				path = m_requests.back();
+				m_requests.pop_back();
+			}
+
+			Decoded result;
+			result.m_path = path;
+			try
+			{
+				auto image = std::make_shared<sf::Image>();
+				if (Resources::load(*image, path))
+				{
+					fit(*image, m_slotSize);
+					result.m_image = image;
+				}
+			}
+			catch (const std::exception&)
+			{	// отсутствие изображения сообщается в update
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decoded.push_back(result);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ThumbnailAtlas::fit(sf::Image& image, const sf::Vector2u& size)
+	{
+		const sf::Vector2u source(image.getSize());
+		if (source.x <= size.x && source.y <= size.y)
+		{
+			return;
+		}
+		const double scale = std::min(static_cast<double>(size.x) / source.x, static_cast<double>(size.y) / source.y);
+		const unsigned width = std::max(1u, std::min(size.x, static_cast<unsigned>(source.x * scale)));
+		const unsigned height = std::max(1u, std::min(size.y, static_cast<unsigned>(source.y * scale)));
+
+		// каждый пиксель результата - среднее своего прямоугольника исходного изображения
+		const sf::Uint8* pixels = image.getPixelsPtr();
+		std::vector<sf::Uint8> result(static_cast<size_t>(width) * height * 4);
+		for (unsigned y = 0; y < height; ++y)
+		{
+			const unsigned top = y * source.y / height;
+			const unsigned bottom = std::max(top + 1, (y + 1) * source.y / height);
+			for (unsigned x = 0; x < width; ++x)
+			{
+				const unsigned left = x * source.x / width;
+				const unsigned right = std::max(left + 1, (x + 1) * source.x / width);
+				unsigned sum[4] = { 0, 0, 0, 0 };
+				for (unsigned sy = top; sy < bottom; ++sy)
+				{
+					const sf::Uint8* row = pixels + (static_cast<size_t>(sy) * source.x + left) * 4;
+					for (unsigned sx = left; sx < right; ++sx, row += 4)
+					{
+						sum[0] += row[0];
+						sum[1] += row[1];
+						sum[2] += row[2];
+						sum[3] += row[3];
+					}
+				}
+				const unsigned count = (bottom - top) * (right - left);
+				sf::Uint8* target = &result[(static_cast<size_t>(y) * width + x) * 4];
+				for (int channel = 0; channel < 4; ++channel)
+				{
+					target[channel] = static_cast<sf::Uint8>(sum[channel] / count);
+				}
+			}
+		}
+		image.create(width, height, result.data());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const TextureRegion* ThumbnailAtlas::get(const std::string& path)
+	{
+		const auto itLoaded = m_loaded.find(path);
+		if (itLoaded != m_loaded.end())
+		{
+			Slot& slot = m_slots[itLoaded->second];
+			slot.m_lastUse = m_frame;
+			return &slot.m_region;
+		}
+		if (m_failed.find(path) == m_failed.end())
+		{
+			m_wanted.push_back(path);
+		}
+		return nullptr;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void ThumbnailAtlas::update(size_t maxUploads)
+	{
+		// ячейки, видимые в прошлом кадре, не освобождаются
+		const std::uint64_t previous = m_frame++;
+
+		std::vector<Decoded> decoded;
+		bool requested = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			// миниатюры, ушедшие из вида до декодирования, больше не нужны
+			const std::set<std::string> wanted(m_wanted.begin(), m_wanted.end());
+			std::vector<std::string> requests;
+			for (const auto& path : m_requests)
+			{
+				if (wanted.find(path) != wanted.end())
+				{
+					requests.push_back(path);
+				}
+				else
+				{
+					m_pending.erase(path);
+				}
+			}
+			m_requests.swap(requests);
+			for (const auto& path : m_wanted)
+			{
+				if (m_pending.insert(path).second)
+				{
+					m_requests.push_back(path);
+					requested = true;
+				}
+			}
+
+			const size_t count = std::min(maxUploads, m_decoded.size());
+			decoded.assign(m_decoded.begin(), m_decoded.begin() + count);
+			m_decoded.erase(m_decoded.begin(), m_decoded.begin() + count);
+			for (const auto& item : decoded)
+			{
+				m_pending.erase(item.m_path);
+			}
+		}
+		m_wanted.clear();
+		if (requested)
+		{
+			m_wake.notify_one();
+		}
+
+		for (const auto& item : decoded)
+		{
+			if (!item.m_image)
+			{
+				std::cerr << "Thumbnail: cannot load " << item.m_path << std::endl;
+				m_failed.insert(item.m_path);
+				continue;
+			}
+			if (m_loaded.find(item.m_path) != m_loaded.end())
+			{
+				continue;
+			}
+
+			// свободная ячейка или давно не видимая
+			size_t best = m_slots.size();
+			for (size_t i = 0; i < m_slots.size(); ++i)
+			{
+				if (m_slots[i].m_path.empty())
+				{
+					best = i;
+					break;
+				}
+				if (m_slots[i].m_lastUse < previous && (best == m_slots.size() || m_slots[i].m_lastUse < m_slots[best].m_lastUse))
+				{
+					best = i;
+				}
+			}
+			if (best == m_slots.size())
+			{	// все ячейки видны, миниатюра будет запрошена снова
+				continue;
+			}
+
+			Slot& slot = m_slots[best];
+			if (!slot.m_path.empty())
+			{
+				m_loaded.erase(slot.m_path);
+			}
+			const unsigned x = static_cast<unsigned>(best % m_columns) * m_slotSize.x;
+			const unsigned y = static_cast<unsigned>(best / m_columns) * m_slotSize.y;
+			m_texture->update(*item.m_image, x, y);
+			slot.m_path = item.m_path;
+			slot.m_region.m_texture = m_texture;
+			slot.m_region.m_rect = sf::IntRect(x, y, item.m_image->getSize().x, item.m_image->getSize().y);
+			slot.m_lastUse = m_frame;
+			m_loaded[item.m_path] = best;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const sf::Vector2u& ThumbnailAtlas::getSlotSize() const
+	{
+		return m_slotSize;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef THUMBNAILATLAS_H
+#define THUMBNAILATLAS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <iostream>
+
+#include <SFML/Graphics.hpp>
+
+#include "atlas.h"
+#include "resources.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	общий атлас миниатюр с подгрузкой в фоне
+				одна текстура делится на ячейки одного размера, изображения
+				декодируются фоновым потоком, а в текстуру попадают в потоке отрисовки,
+				ячейки давно не видимых миниатюр занимают новые,
+				поэтому память не зависит от количества уровней
+	*/
+	class ThumbnailAtlas final
+	{
+		// @brief ячейка страницы
+		struct Slot
+		{
+			std::string m_path;			// пустой - ячейка свободна
+			TextureRegion m_region;		// участок с изображением внутри ячейки
+			std::uint64_t m_lastUse;	// кадр последнего обращения
+		};
+		// @brief изображение, декодированное фоновым потоком
+		struct Decoded
+		{
+			std::string m_path;
+			std::shared_ptr<sf::Image> m_image;	// nullptr - не удалось прочитать
+		};
+
+		sf::Vector2u m_slotSize;
+		unsigned m_columns;
+		std::shared_ptr<sf::Texture> m_texture;
+		std::vector<Slot> m_slots;
+		std::map<std::string, size_t> m_loaded;	// путь - ячейка
+		std::set<std::string> m_failed;			// не пытаться читать снова
+		std::vector<std::string> m_wanted;		// запрошены в текущем кадре
+		std::uint64_t m_frame;
+
+		// общие с фоновым потоком, под m_mutex
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::vector<std::string> m_requests;	// берутся с конца: последние запрошенные нужнее
+		std::set<std::string> m_pending;		// в очереди или декодируются
+		std::vector<Decoded> m_decoded;
+		bool m_stop;
+		std::thread m_thread;
+
+		ThumbnailAtlas(const ThumbnailAtlas&) = delete;
+		ThumbnailAtlas& operator=(const ThumbnailAtlas&) = delete;
+		/*
+			@brief фоновый поток: декодирует запросы и уменьшает изображения больше ячейки
+		*/
+		void run();
+		/*
+			@brief	уменьшает изображение, чтобы оно поместилось в ячейку, с сохранением пропорций
+			@param image изображение
+			@param size размер ячейки
+		*/
+		static void fit(sf::Image& image, const sf::Vector2u& size);
+	public:
+		/*
+			@brief создает текстуру страницы, вызывается из потока отрисовки
+			@param slotSize размер ячейки, изображения больше него уменьшаются
+			@param slotCount количество ячеек, не меньше числа видимых одновременно миниатюр
+		*/
+		ThumbnailAtlas(const sf::Vector2u& slotSize, size_t slotCount);
+		~ThumbnailAtlas();
+		/*
+			@brief	миниатюра, если она уже в текстуре, иначе запрашивает ее декодирование
+			@param path путь к изображению
+			@ret   участок текстуры или nullptr
+		*/
+		const TextureRegion* get(const std::string& path);
+		/*
+			@brief	отдает запросы кадра фоновому потоку, снимает устаревшие
+					и переносит в текстуру декодированные изображения,
+					вызывается из потока отрисовки один раз за кадр
+			@param maxUploads сколько изображений перенести за кадр
+		*/
+		void update(size_t maxUploads);
+		/*
+			@brief размер ячейки
+		*/
+		const sf::Vector2u& getSlotSize() const;
+	};
+}
+
+#endif // !THUMBNAILATLAS_H
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "tilelayer.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	TileSet::TileSet()
+		: m_maxSize(0, 0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TileSet::set(std::uint32_t gid, const TextureRegion& region)
+	{
+		if (gid >= m_regions.size())
+		{
+			m_regions.resize(gid + 1);
+		}
+		m_regions[gid] = region;
+		m_maxSize.x = std::max(m_maxSize.x, std::abs(region.m_rect.width));
+		m_maxSize.y = std::max(m_maxSize.y, std::abs(region.m_rect.height));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const sf::Vector2i& TileSet::getMaxSize() const
+	{
+		return m_maxSize;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TileSet::clear()
+	{
+		m_regions.clear();
+		m_maxSize = sf::Vector2i(0, 0);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	TileLayer::TileLayer(Kind kind, unsigned width, unsigned height, unsigned tileWidth, unsigned tileHeight)
+		:	m_kind(kind), m_width(width), m_height(height),
+			m_tileWidth(tileWidth), m_tileHeight(tileHeight),
+			m_gids(static_cast<size_t>(width) * height, 0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	TileLayer::TileLayer(TileLayer&& other)
+		:	m_kind(other.m_kind), m_width(other.m_width), m_height(other.m_height),
+			m_tileWidth(other.m_tileWidth), m_tileHeight(other.m_tileHeight),
+			m_gids(std::move(other.m_gids))
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	TileLayer& TileLayer::operator=(TileLayer&& other)
+	{
+		m_kind = other.m_kind;
+		m_width = other.m_width;
+		m_height = other.m_height;
+		m_tileWidth = other.m_tileWidth;
+		m_tileHeight = other.m_tileHeight;
+		m_gids = std::move(other.m_gids);
+		return *this;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
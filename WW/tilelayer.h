@@ -0,0 +1,88 @@
+#ifndef TILELAYER_H
+#define TILELAYER_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#include <SFML/Graphics.hpp>
+
+#include "atlas.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	набор тайлов уровня
+				сопоставляет глобальный номер тайла (gid) участку атласа
+	*/
+	class TileSet final
+	{
+		std::vector<TextureRegion> m_regions;	// индекс - gid, пустая текстура - нет тайла
+		sf::Vector2i m_maxSize;					// наибольший размер изображения тайла
+	public:
+		TileSet();
+		/*
+			@brief задает изображение для номера тайла
+			@param gid глобальный номер тайла
+			@param region участок атласа
+		*/
+		void set(std::uint32_t gid, const TextureRegion& region);
+		/*
+			@brief возвращает изображение тайла
+			@param gid глобальный номер тайла
+			@ret   участок атласа или nullptr, если тайл не задан
+		*/
+		const TextureRegion* get(std::uint32_t gid) const
+		{
+			if (gid < m_regions.size() && m_regions[gid].m_texture)
+			{
+				return &m_regions[gid];
+			}
+			return nullptr;
+		}
+		/*
+			@brief наибольший размер изображения тайла в пикселях
+		*/
+		const sf::Vector2i& getMaxSize() const;
+		/*
+			@brief удаляет все тайлы
+		*/
+		void clear();
+	};
+	/*
+		@brief	слой тайлов карты
+				хранит только номера тайлов плотным массивом,
+				изображения берутся из TileSet при построении отрисовки
+	*/
+	struct TileLayer
+	{
+		// @brief назначение слоя
+		enum class Kind{	TL_TRANSPARENT,	// декорация
+							TL_OPAQUE		// твердая поверхность
+						};
+		Kind m_kind;
+		unsigned m_width, m_height;			// размер в тайлах
+		unsigned m_tileWidth, m_tileHeight;	// размер клетки в пикселях
+		std::vector<std::uint32_t> m_gids;	// номера тайлов построчно, 0 - пусто
+
+		TileLayer(Kind kind, unsigned width, unsigned height, unsigned tileWidth, unsigned tileHeight);
+		TileLayer(const TileLayer& other) = default;
+		TileLayer& operator=(const TileLayer& other) = default;
+		// VS2013 не создает перемещение сам, а слои больших карт занимают мегабайты
+		TileLayer(TileLayer&& other);
+		TileLayer& operator=(TileLayer&& other);
+		/*
+			@brief номер тайла в клетке
+			@param x столбец
+			@param y строка
+		*/
+		std::uint32_t at(unsigned x, unsigned y) const
+		{
+			return m_gids[y * m_width + x];
+		}
+	};
+}
+
+#endif // !TILELAYER_H
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "tilerenderer.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	const unsigned TileRenderer::m_chunkSize = 16;
+	//////////////////////////////////////////////////////////////////////////
+	TileRenderer::TileRenderer()
+		: m_lastDrawCalls(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	TileRenderer::Chunk TileRenderer::buildChunk(const TileLayer& source, const TileSet& tiles, unsigned chunkX, unsigned chunkY)
+	{
+		Chunk chunk;
+
+		const unsigned firstX = chunkX * m_chunkSize;
+		const unsigned firstY = chunkY * m_chunkSize;
+		const unsigned lastX = std::min(firstX + m_chunkSize, source.m_width);
+		const unsigned lastY = std::min(firstY + m_chunkSize, source.m_height);
+
+		for (unsigned y = firstY; y < lastY; ++y)
+		{
+			for (unsigned x = firstX; x < lastX; ++x)
+			{
+				const TextureRegion* region = tiles.get(source.at(x, y));
+				if (!region)
+				{
+					continue;
+				}
+
+				auto itBatch = std::find_if(chunk.begin(), chunk.end(), [region](const Batch& batch)
+				{
+					return batch.m_texture == region->m_texture;
+				});
+				if (itBatch == chunk.end())
+				{
+					Batch batch;
+					batch.m_texture = region->m_texture;
+					batch.m_vertices.setPrimitiveType(sf::Quads);
+					chunk.push_back(batch);
+					itBatch = chunk.end() - 1;
+				}
+
+				const sf::IntRect& rect = region->m_rect;
+				const float left = static_cast<float>(x * source.m_tileWidth);
+				const float top = static_cast<float>(y * source.m_tileHeight);
+				const float right = left + std::abs(rect.width);
+				const float bottom = top + std::abs(rect.height);
+				// отрицательный размер участка означает отражение
+				const float texLeft = static_cast<float>(rect.left);
+				const float texTop = static_cast<float>(rect.top);
+				const float texRight = static_cast<float>(rect.left + rect.width);
+				const float texBottom = static_cast<float>(rect.top + rect.height);
+
+				sf::VertexArray& vertices = itBatch->m_vertices;
+				vertices.append(sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(texLeft, texTop)));
+				vertices.append(sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(texRight, texTop)));
+				vertices.append(sf::Vertex(sf::Vector2f(right, bottom), sf::Vector2f(texRight, texBottom)));
+				vertices.append(sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(texLeft, texBottom)));
+			}
+		}
+		return chunk;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TileRenderer::build(const std::vector<TileLayer>& layers, const TileSet& tiles)
+	{
+		clear();
+		for (const auto& source : layers)
+		{
+			Layer layer;
+			layer.m_chunksX = (source.m_width + m_chunkSize - 1) / m_chunkSize;
+			layer.m_chunksY = (source.m_height + m_chunkSize - 1) / m_chunkSize;
+			layer.m_chunkWidth = m_chunkSize * source.m_tileWidth;
+			layer.m_chunkHeight = m_chunkSize * source.m_tileHeight;
+			layer.m_overlapX = layer.m_chunkWidth ? (tiles.getMaxSize().x + layer.m_chunkWidth - 1) / layer.m_chunkWidth : 0;
+			layer.m_overlapY = layer.m_chunkHeight ? (tiles.getMaxSize().y + layer.m_chunkHeight - 1) / layer.m_chunkHeight : 0;
+			layer.m_chunks.reserve(layer.m_chunksX * layer.m_chunksY);
+			for (unsigned chunkY = 0; chunkY < layer.m_chunksY; ++chunkY)
+			{
+				for (unsigned chunkX = 0; chunkX < layer.m_chunksX; ++chunkX)
+				{
+					layer.m_chunks.push_back(buildChunk(source, tiles, chunkX, chunkY));
+				}
+			}
+			m_layers.push_back(layer);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t TileRenderer::rebuild(size_t index, const TileLayer& before, const TileLayer& after, const TileSet& tiles)
+	{
+		assert(index < m_layers.size());
+		assert(before.m_width == after.m_width && before.m_height == after.m_height);
+		Layer& layer = m_layers[index];
+		size_t rebuilt = 0;
+		for (unsigned chunkY = 0; chunkY < layer.m_chunksY; ++chunkY)
+		{
+			for (unsigned chunkX = 0; chunkX < layer.m_chunksX; ++chunkX)
+			{
+				const unsigned firstX = chunkX * m_chunkSize;
+				const unsigned lastX = std::min(firstX + m_chunkSize, after.m_width);
+				const unsigned lastY = std::min((chunkY + 1) * m_chunkSize, after.m_height);
+				bool changed = false;
+				for (unsigned y = chunkY * m_chunkSize; y < lastY && !changed; ++y)
+				{
+					const size_t row = static_cast<size_t>(y) * after.m_width;
+					changed = !std::equal(after.m_gids.begin() + row + firstX, after.m_gids.begin() + row + lastX, before.m_gids.begin() + row + firstX);
+				}
+				if (changed)
+				{
+					layer.m_chunks[chunkY * layer.m_chunksX + chunkX] = buildChunk(after, tiles, chunkX, chunkY);
+					++rebuilt;
+				}
+			}
+		}
+		return rebuilt;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TileRenderer::draw(sf::RenderWindow& render) const
+	{
+		m_lastDrawCalls = 0;
+
+		const sf::Vector2f viewSize = render.getView().getSize();
+		const sf::Vector2f viewTopLeft = render.getView().getCenter() - viewSize / 2.0f;
+
+		for (const auto& layer : m_layers)
+		{
+			if (layer.m_chunks.empty() || layer.m_chunkWidth == 0 || layer.m_chunkHeight == 0)
+			{
+				continue;
+			}
+			// номера видимых кусков вычисляются сразу, без перебора всех кусков слоя
+			const int firstX = std::max(0, static_cast<int>(std::floor(viewTopLeft.x / layer.m_chunkWidth)) - layer.m_overlapX);
+			const int firstY = std::max(0, static_cast<int>(std::floor(viewTopLeft.y / layer.m_chunkHeight)) - layer.m_overlapY);
+			const int lastX = std::min(	static_cast<int>(layer.m_chunksX) - 1,
+										static_cast<int>(std::floor((viewTopLeft.x + viewSize.x) / layer.m_chunkWidth)));
+			const int lastY = std::min(	static_cast<int>(layer.m_chunksY) - 1,
+										static_cast<int>(std::floor((viewTopLeft.y + viewSize.y) / layer.m_chunkHeight)));
+
+			for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+			{
+				for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+				{
+					for (const auto& batch : layer.m_chunks[chunkY * layer.m_chunksX + chunkX])
+					{
+						render.draw(batch.m_vertices, sf::RenderStates(batch.m_texture.get()));
+						++m_lastDrawCalls;
+					}
+				}
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TileRenderer::clear()
+	{
+		m_layers.clear();
+		m_lastDrawCalls = 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t TileRenderer::getLastDrawCalls() const
+	{
+		return m_lastDrawCalls;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
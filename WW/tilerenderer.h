@@ -0,0 +1,90 @@
+#ifndef TILERENDERER_H
+#define TILERENDERER_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/Graphics.hpp>
+
+#include "tilelayer.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	отрисовка статичных слоев тайлов
+				слой делится на квадратные куски, для каждого куска при загрузке
+				строится массив вершин на каждую страницу атласа, поэтому кусок
+				рисуется одним вызовом на страницу, а куски вне вида пропускаются
+	*/
+	class TileRenderer final
+	{
+		// @brief вершины куска, использующие одну страницу атласа
+		struct Batch
+		{
+			TexturePtr m_texture;
+			sf::VertexArray m_vertices;
+		};
+		// @brief кусок слоя
+		typedef std::vector<Batch> Chunk;
+		// @brief слой, разбитый на куски
+		struct Layer
+		{
+			unsigned m_chunksX, m_chunksY;			// количество кусков
+			unsigned m_chunkWidth, m_chunkHeight;	// размер куска в пикселях
+			int m_overlapX, m_overlapY;				// на сколько кусков тайлы выступают вправо и вниз
+			std::vector<Chunk> m_chunks;			// куски построчно
+		};
+
+		static const unsigned m_chunkSize;	// размер куска в тайлах
+
+		std::vector<Layer> m_layers;
+		mutable size_t m_lastDrawCalls;
+
+		TileRenderer(const TileRenderer&) = delete;
+		TileRenderer& operator=(const TileRenderer&) = delete;
+		/*
+			@brief строит вершины одного куска
+			@param source слой тайлов
+			@param tiles набор тайлов
+			@param chunkX номер куска по Х
+			@param chunkY номер куска по У
+			@ret   вершины, сгруппированные по страницам
+		*/
+		static Chunk buildChunk(const TileLayer& source, const TileSet& tiles, unsigned chunkX, unsigned chunkY);
+	public:
+		TileRenderer();
+		~TileRenderer() = default;
+		/*
+			@brief строит куски для всех слоев
+			@param layers слои тайлов в порядке отрисовки
+			@param tiles набор тайлов
+		*/
+		void build(const std::vector<TileLayer>& layers, const TileSet& tiles);
+		/*
+			@brief	перестраивает только куски слоя, в которых изменились номера тайлов
+			@param index номер слоя в порядке build
+			@param before прежний слой
+			@param after новый слой того же размера
+			@param tiles набор тайлов
+			@ret   количество перестроенных кусков
+		*/
+		size_t rebuild(size_t index, const TileLayer& before, const TileLayer& after, const TileSet& tiles);
+		/*
+			@brief рисует куски, пересекающиеся с текущим видом
+			@param render объект для отрисовки
+		*/
+		void draw(sf::RenderWindow& render) const;
+		/*
+			@brief удаляет все куски
+		*/
+		void clear();
+		/*
+			@brief количество вызовов отрисовки в последнем кадре
+		*/
+		size_t getLastDrawCalls() const;
+	};
+}
+
+#endif // !TILERENDERER_H
\ No newline at end of file
@@ -0,0 +1,579 @@
+#include "tmxreader.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	struct TmxReader::Names
+	{
+		XmlReader::Name m_map, m_properties, m_property, m_tileset, m_tile, m_image, m_layer, m_data,
+						m_objectgroup, m_object, m_player, m_animation, m_hud, m_live, m_coin, m_sound;
+		XmlReader::Name m_name, m_value, m_type, m_width, m_height, m_tilewidth, m_tileheight,
+						m_backgroundcolor, m_firstgid, m_id, m_source, m_encoding, m_compression,
+						m_gid, m_x, m_y, m_speed, m_defimgx, m_defimgwidth, m_defimgheight, m_initstate,
+						m_density, m_friction, m_xvelocity, m_yvelocity, m_lives, m_wincoin, m_file,
+						m_font, m_fontsize, m_srcX, m_srcY, m_srcWidth, m_srcHeight,
+						m_step, m_jump, m_getLive, m_getCoin;
+
+		explicit Names(XmlReader& reader)
+			:	m_map(reader.intern("map")), m_properties(reader.intern("properties")),
+				m_property(reader.intern("property")), m_tileset(reader.intern("tileset")),
+				m_tile(reader.intern("tile")), m_image(reader.intern("image")),
+				m_layer(reader.intern("layer")), m_data(reader.intern("data")),
+				m_objectgroup(reader.intern("objectgroup")), m_object(reader.intern("object")),
+				m_player(reader.intern("player")), m_animation(reader.intern("animation")),
+				m_hud(reader.intern("hud")), m_live(reader.intern("live")),
+				m_coin(reader.intern("coin")), m_sound(reader.intern("sound")),
+				m_name(reader.intern("name")), m_value(reader.intern("value")),
+				m_type(reader.intern("type")), m_width(reader.intern("width")),
+				m_height(reader.intern("height")), m_tilewidth(reader.intern("tilewidth")),
+				m_tileheight(reader.intern("tileheight")), m_backgroundcolor(reader.intern("backgroundcolor")),
+				m_firstgid(reader.intern("firstgid")), m_id(reader.intern("id")),
+				m_source(reader.intern("source")), m_encoding(reader.intern("encoding")),
+				m_compression(reader.intern("compression")), m_gid(reader.intern("gid")),
+				m_x(reader.intern("x")), m_y(reader.intern("y")), m_speed(reader.intern("speed")),
+				m_defimgx(reader.intern("defimgx")), m_defimgwidth(reader.intern("defimgwidth")),
+				m_defimgheight(reader.intern("defimgheight")), m_initstate(reader.intern("initstate")),
+				m_density(reader.intern("density")), m_friction(reader.intern("friction")),
+				m_xvelocity(reader.intern("xvelocity")), m_yvelocity(reader.intern("yvelocity")),
+				m_lives(reader.intern("lives")), m_wincoin(reader.intern("wincoin")),
+				m_file(reader.intern("file")), m_font(reader.intern("font")),
+				m_fontsize(reader.intern("fontsize")), m_srcX(reader.intern("srcX")),
+				m_srcY(reader.intern("srcY")), m_srcWidth(reader.intern("srcWidth")),
+				m_srcHeight(reader.intern("srcHeight")), m_step(reader.intern("step")),
+				m_jump(reader.intern("jump")), m_getLive(reader.intern("getLive")),
+				m_getCoin(reader.intern("getCoin"))
+		{}
+	};
+	//////////////////////////////////////////////////////////////////////////
+	struct TmxReader::Strings
+	{
+		LevelData& m_level;
+		std::unordered_map<std::string, std::uint32_t> m_index;
+		std::string m_key;	// буфер поиска, чтобы не создавать строку на каждое свойство
+
+		explicit Strings(LevelData& level) : m_level(level)
+		{
+			for (size_t i = 0; i < level.m_strings.size(); ++i)
+			{
+				m_index.insert(std::make_pair(level.m_strings[i], static_cast<std::uint32_t>(i)));
+			}
+		}
+		/*
+			@brief номер строки, новая строка добавляется в конец таблицы
+		*/
+		std::uint32_t intern(const StringView& value)
+		{
+			m_key.assign(value.m_data, value.m_size);
+			const auto found = m_index.find(m_key);
+			if (found != m_index.end())
+			{
+				return found->second;
+			}
+			const std::uint32_t index = static_cast<std::uint32_t>(m_level.m_strings.size());
+			m_level.m_strings.push_back(m_key);
+			m_index.insert(std::make_pair(m_key, index));
+			return index;
+		}
+	};
+	//////////////////////////////////////////////////////////////////////////
+	sf::Color TmxReader::readColor(const StringView& color)
+	{
+		if (color.empty())
+		{
+			return sf::Color(255, 255, 255, 255);
+		}
+		if ((color.m_size != 7 && color.m_size != 9) || color.m_data[0] != '#')
+		{
+			throw std::runtime_error("GameSpace::TmxReader::readColor if (color.m_size != 7 && color.m_size != 9)");
+		}
+		auto component = [&color](size_t offset) -> std::uint8_t
+		{
+			const char digits[3] = { color.m_data[offset], color.m_data[offset + 1], '\0' };
+			return static_cast<std::uint8_t>(std::strtoul(digits, nullptr, 16));
+		};
+		size_t colorOffset = 1;
+		std::uint8_t a = 255;
+		if (color.m_size == 9)
+		{
+			a = component(colorOffset); colorOffset += 2;
+		}
+		const std::uint8_t r = component(colorOffset); colorOffset += 2;
+		const std::uint8_t g = component(colorOffset); colorOffset += 2;
+		const std::uint8_t b = component(colorOffset);
+		return sf::Color(r, g, b, a);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TmxReader::readProperties(XmlReader& reader, const Names& names, std::map<std::string, std::string>& data)
+	{
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			data[reader.getAttribute(names.m_name).toString()] = reader.getAttribute(names.m_value).toString();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TmxReader::readTypedProperties(XmlReader& reader, const Names& names, Strings& strings, std::vector<LevelProperty>& data)
+	{
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			LevelProperty property;
+			property.m_name = strings.intern(reader.getAttribute(names.m_name));
+			const StringView value(reader.getAttribute(names.m_value));
+			const StringView type(reader.getAttribute(names.m_type, StringView()));
+
+			if (type == "bool")
+			{
+				property.m_type = LevelProperty::Type::PT_INT;
+				property.m_int = (value == "true" || value == "1") ? 1 : 0;
+			}
+			else if (type == "int" || (type.empty() && value.isInt()))
+			{
+				property.m_type = LevelProperty::Type::PT_INT;
+				property.m_int = value.toInt();
+			}
+			else if (type == "float" || (type.empty() && value.isFloat()))
+			{
+				property.m_type = LevelProperty::Type::PT_FLOAT;
+				property.m_float = value.toFloat();
+			}
+			else
+			{
+				property.m_type = LevelProperty::Type::PT_STRING;
+				property.m_string = strings.intern(value);
+			}
+			data.push_back(property);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	AnimationData TmxReader::readAnimation(XmlReader& reader, const Names& names)
+	{
+		using namespace std;
+
+		auto getStateFromStr = [](const string& src) -> Animation::MoveState
+		{
+			if (src == "stay_right")
+			{
+				return Animation::MoveState::MS_STAY_RIGHT;
+			}
+			else if (src == "stay_left")
+			{
+				return Animation::MoveState::MS_STAY_LEFT;
+			}
+			else if (src == "move_right")
+			{
+				return Animation::MoveState::MS_MOVE_RIGHT;
+			}
+			else if (src == "move_left")
+			{
+				return Animation::MoveState::MS_MOVE_LEFT;
+			}
+			else if (src == "jump_right")
+			{
+				return Animation::MoveState::MS_JUMP_RIGHT;
+			}
+			else if (src == "jump_left")
+			{
+				return Animation::MoveState::MS_JUMP_LEFT;
+			}
+			else if (src == "fall_right")
+			{
+				return Animation::MoveState::MS_FALL_RIGHT;
+			}
+			else if (src == "fall_left")
+			{
+				return Animation::MoveState::MS_FALL_LEFT;
+			}
+			throw std::runtime_error("GameSpace::TmxReader::readAnimation getStateFromStr");
+		};
+
+		AnimationData animation;
+		const int defxpos = reader.getAttribute(names.m_defimgx).toInt();
+		const int defwidth = reader.getAttribute(names.m_defimgwidth).toInt();
+		const int defheight = reader.getAttribute(names.m_defimgheight).toInt();
+		animation.m_defaultFrame = sf::IntRect(defxpos, defxpos, defwidth, defheight);
+		animation.m_initState = getStateFromStr(reader.getAttribute(names.m_initstate).toString());
+
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{	// имя элемента - название состояния
+			AnimationData::State stateData;
+			stateData.m_state = getStateFromStr(reader.getNameString(reader.getName()));
+			stateData.m_speed = reader.getAttribute(names.m_speed).toFloat();
+			const size_t stateDepth = reader.getDepth();
+			while (reader.nextChild(stateDepth))
+			{
+				const int x = reader.getAttribute(names.m_x).toInt();
+				const int y = reader.getAttribute(names.m_y).toInt();
+				const int width = reader.getAttribute(names.m_width).toInt();
+				const int height = reader.getAttribute(names.m_height).toInt();
+				stateData.m_frames.push_back(sf::IntRect(x, y, width, height));
+			}
+			animation.m_states.push_back(stateData);
+		}
+
+		return animation;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	PlayerData TmxReader::readPlayerFromFile(const std::string& playerCfg)
+	{
+		using namespace std;
+
+		XmlReader reader(playerCfg);
+		const Names names(reader);
+		if (!reader.nextChild(0) || reader.getName() != names.m_player)
+		{
+			throw runtime_error("GameSpace::TmxReader::readPlayerFromFile if (!rootElement)");
+		}
+
+		PlayerData player;
+		player.m_density = reader.getAttribute(names.m_density).toFloat();
+		player.m_friction = reader.getAttribute(names.m_friction).toFloat();
+		player.m_xvelocity = reader.getAttribute(names.m_xvelocity).toFloat();
+		player.m_yvelocity = reader.getAttribute(names.m_yvelocity).toFloat();
+		player.m_lives = reader.getAttribute(names.m_lives).toInt();
+		player.m_winCoins = reader.getAttribute(names.m_wincoin).toInt();
+		player.m_file = reader.getAttribute(names.m_file).toString();
+
+		auto readImgRect = [&reader, &names](sf::IntRect& result)
+		{
+			result.left = reader.getAttribute(names.m_srcX).toInt();
+			result.top = reader.getAttribute(names.m_srcY).toInt();
+			result.width = reader.getAttribute(names.m_srcWidth).toInt();
+			result.height = reader.getAttribute(names.m_srcHeight).toInt();
+		};
+
+		bool hasAnimation = false, hasHud = false, hasLive = false, hasCoin = false, hasSound = false;
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			const XmlReader::Name item = reader.getName();
+			if (item == names.m_animation)
+			{
+				player.m_animation = readAnimation(reader, names);
+				hasAnimation = true;
+			}
+			else if (item == names.m_hud)
+			{
+				player.m_hudFile = reader.getAttribute(names.m_file).toString();
+				player.m_fontFile = reader.getAttribute(names.m_font).toString();
+				player.m_fontSize = reader.getAttribute(names.m_fontsize).toInt();
+				hasHud = true;
+
+				const size_t hudDepth = reader.getDepth();
+				while (reader.nextChild(hudDepth))
+				{
+					if (reader.getName() == names.m_live)
+					{
+						readImgRect(player.m_liveRect);
+						hasLive = true;
+					}
+					else if (reader.getName() == names.m_coin)
+					{
+						readImgRect(player.m_coinRect);
+						hasCoin = true;
+					}
+				}
+			}
+			else if (item == names.m_sound)
+			{
+				player.m_stepSound = reader.getAttribute(names.m_step).toString();
+				player.m_jumpSound = reader.getAttribute(names.m_jump).toString();
+				player.m_getLiveSound = reader.getAttribute(names.m_getLive).toString();
+				player.m_getCoinSound = reader.getAttribute(names.m_getCoin).toString();
+				hasSound = true;
+			}
+		}
+
+		if (!hasAnimation)
+		{
+			throw runtime_error("GameSpace::TmxReader::readPlayerFromFile if (!animation)");
+		}
+		if (!hasHud)
+		{
+			throw runtime_error("GameSpace::TmxReader::readPlayerFromFile if (!hud)");
+		}
+		if (!hasLive)
+		{
+			throw runtime_error("GameSpace::TmxReader::readPlayerFromFile if (!live)");
+		}
+		if (!hasCoin)
+		{
+			throw runtime_error("GameSpace::TmxReader::readPlayerFromFile if (!coin)");
+		}
+		if (!hasSound)
+		{
+			throw runtime_error("GameSpace::TmxReader::readPlayerFromFile if (!sound)");
+		}
+		return player;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TmxReader::readTileset(XmlReader& reader, const Names& names, LevelData& level)
+	{
+		const int firstGid = reader.getAttribute(names.m_firstgid).toInt();
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			if (reader.getName() != names.m_tile)
+			{
+				continue;
+			}
+			const int tileId = firstGid + reader.getAttribute(names.m_id).toInt();
+			bool hasImage = false;
+			const size_t tileDepth = reader.getDepth();
+			while (reader.nextChild(tileDepth))
+			{
+				if (reader.getName() == names.m_image)
+				{
+					level.m_tiles[tileId] = level.addImage(reader.getAttribute(names.m_source).toString());
+					hasImage = true;
+				}
+			}
+			if (!hasImage)
+			{
+				throw std::runtime_error("GameSpace::TmxReader::readTileset if (!imageItem)");
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TmxReader::readLayer(	XmlReader& reader, const Names& names, const LevelData& level,
+								std::vector<TileLayer>& transparents, std::vector<TileLayer>& opaques)
+	{
+		std::map<std::string, std::string> layerProperties;
+		TileLayer tileLayer(TileLayer::Kind::TL_TRANSPARENT, level.m_width, level.m_height, level.m_tileWidth, level.m_tileHeight);
+		bool hasData = false;
+
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			if (reader.getName() == names.m_properties)
+			{
+				readProperties(reader, names, layerProperties);
+			}
+			else if (reader.getName() == names.m_data)
+			{
+				hasData = true;
+				StringView encoding;
+				if (reader.findAttribute(names.m_encoding, encoding))
+				{	// csv или base64, текст разбирается прямо из отображенного файла
+					const std::string encodingName(encoding.toString());
+					const std::string compression(reader.getAttribute(names.m_compression, StringView()).toString());
+					const StringView text(reader.readText());
+					LayerDecoder::decode(text.m_data, text.m_size, encodingName, compression, tileLayer.m_gids);
+				}
+				else
+				{	// старый формат: элемент tile на каждую клетку
+					size_t currentTileNum = 0;
+					const size_t dataDepth = reader.getDepth();
+					while (reader.nextChild(dataDepth))
+					{
+						if (currentTileNum < tileLayer.m_gids.size())
+						{
+							tileLayer.m_gids[currentTileNum] = LayerDecoder::clearFlags(reader.getAttribute(names.m_gid).toUInt());
+							++currentTileNum;
+						}
+					}
+				}
+			}
+		}
+
+		// свойства могут идти и до, и после данных, поэтому вид слоя задается в конце
+		const std::string& visible = layerProperties["visible"];
+		if (visible != "transparent" && visible != "opaque")
+		{
+			return;
+		}
+		if (!hasData)
+		{
+			throw std::runtime_error("GameSpace::TmxReader::readLayer if (!dataElement)");
+		}
+		if (visible == "transparent")
+		{
+			transparents.push_back(std::move(tileLayer));
+		}
+		else
+		{
+			tileLayer.m_kind = TileLayer::Kind::TL_OPAQUE;
+			opaques.push_back(std::move(tileLayer));
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void TmxReader::readObjectGroup(XmlReader& reader, const Names& names, Strings& strings, LevelData& level)
+	{
+		using namespace std;
+
+		const uint32_t playerType = strings.intern(StringView("player", 6));
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			LevelObject object;
+			object.m_type = strings.intern(reader.getAttribute(names.m_type));
+			StringView gid;
+			object.m_gid = reader.findAttribute(names.m_gid, gid) ? LayerDecoder::clearFlags(gid.toUInt()) : 0;
+			// Tiled пишет координаты объектов дробными, дробная часть отбрасывается, как в stoi
+			object.m_x = static_cast<int>(reader.getAttribute(names.m_x).toFloat());
+			object.m_y = static_cast<int>(reader.getAttribute(names.m_y).toFloat());
+
+			object.m_firstProperty = static_cast<uint32_t>(level.m_properties.size());
+			const size_t objectDepth = reader.getDepth();
+			while (reader.nextChild(objectDepth))
+			{
+				if (reader.getName() == names.m_properties)
+				{
+					readTypedProperties(reader, names, strings, level.m_properties);
+				}
+			}
+			object.m_propertyCount = static_cast<uint32_t>(level.m_properties.size()) - object.m_firstProperty;
+
+			if (object.m_type == playerType)
+			{	// изображения игроков тоже попадают в атлас
+				const LevelProperty* property = level.findProperty(object, "config");
+				if (!property || property->m_type != LevelProperty::Type::PT_STRING)
+				{
+					throw runtime_error("GameSpace::TmxReader::readObjectGroup if (!config)");
+				}
+				const string& config(level.getString(property->m_string));
+				if (level.m_players.find(config) == level.m_players.end())
+				{
+					const PlayerData player(readPlayerFromFile(config));
+					level.addImage(player.m_file);
+					level.addImage(player.m_hudFile);
+					level.m_players.insert(make_pair(config, player));
+
+					LevelSource playerSource;
+					playerSource.m_path = config;
+					playerSource.m_modified = 0;
+					playerSource.m_size = 0;
+					playerSource.m_hash = 0;
+					level.m_sources.push_back(playerSource);
+				}
+			}
+			level.m_objects.push_back(object);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	LevelData TmxReader::read(const std::string& mapCfg)
+	{
+		/*
+			описание формата
+			карта в формате tmx
+			у карты есть параметры width, height, tilewidth, tileheight
+			backgroundcolor задает цвет фона (поддерживается прозрачность)
+				+ в свойствах карты
+				gravityx гравитация по X (float)
+				gravityy гравитация по Y (float)
+				timewarp варп (модификация времени) (float)
+				steprate шагов физики в секунду, необязательно, по умолчанию 60,
+					0 - шаг физики на каждый кадр (float)
+				friction коэффицент трения для земли (float)
+
+			тайлсеты задаются отдельными изображениями
+
+				+ в свойствах слоя
+				visible = [transparent, opaque]
+				transparent - прозрачный слой
+				opaque - жёсткий слой
+				данные слоя: элементы tile, csv или base64 (без сжатия, zlib или gzip)
+
+			объекты на карте поверх карты (все объекты из тайлов)
+			у каждого объекта на карте есть тип
+			в зависимости от типа отличаются дополнительные свойства
+				тип player
+					+ config - задает расположение файла конфигурации игрока
+				тип movable (перемещаемые объекты)
+					+ density - плотность
+					+ friction - трение
+				тип platform (самодвигающиеся платформы)
+					+ dstx - значение назначения Х (левая граница)
+					+ dsty - значение назначения У (нижняя граница)
+					+ friction - трение верхней кромки
+					+ speed - скорость
+				тип jumping (батут для прыжков)
+					+ friction - трение верхней кромки платформы
+					+ restitution - упругость верхней кромки платформы
+				тип effect (объект-эффект)
+					+ friction - трение объекта
+					+ restitution - упругость объекта
+					+ live - бонус к жизни при касании
+					+ coin - бонус к монетам при касании
+					+ destroy - если "1", то уничтожать после касания, если "0", то нет
+		*/
+		using namespace std;
+
+		sf::Clock clock;
+		XmlReader reader(mapCfg);
+		const Names names(reader);
+		if (!reader.nextChild(0) || reader.getName() != names.m_map)
+		{
+			throw runtime_error("GameSpace::TmxReader::read if (!rootElement)");
+		}
+
+		LevelData level;
+		LevelSource source;
+		source.m_path = mapCfg;
+		source.m_modified = 0;
+		source.m_size = 0;
+		source.m_hash = 0;
+		level.m_sources.push_back(source);
+
+		level.m_width = reader.getAttribute(names.m_width).toInt();
+		level.m_height = reader.getAttribute(names.m_height).toInt();
+		level.m_tileWidth = reader.getAttribute(names.m_tilewidth).toInt();
+		level.m_tileHeight = reader.getAttribute(names.m_tileheight).toInt();
+		level.m_bgColor = readColor(reader.getAttribute(names.m_backgroundcolor, StringView()));
+
+		map<string, string> mapProperties;
+		vector<TileLayer> transparents, opaques;
+		Strings strings(level);
+
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			const XmlReader::Name item = reader.getName();
+			if (item == names.m_properties)
+			{
+				readProperties(reader, names, mapProperties);
+			}
+			else if (item == names.m_tileset)
+			{	// секция описывает набор тайлов
+				readTileset(reader, names, level);
+			}
+			else if (item == names.m_layer)
+			{	// секция описывает слой
+				readLayer(reader, names, level, transparents, opaques);
+			}
+			else if (item == names.m_objectgroup)
+			{	// секция описывает объекты
+				readObjectGroup(reader, names, strings, level);
+			}
+		}
+
+		level.m_timeWarp = stof(mapProperties["timewarp"]);
+		level.m_gravityX = stof(mapProperties["gravityx"]);
+		level.m_gravityY = stof(mapProperties["gravityy"]);
+		const auto itStepRate = mapProperties.find("steprate");
+		if (itStepRate != mapProperties.end())
+		{
+			level.m_stepRate = stof(itStepRate->second);
+		}
+		level.m_friction = stof(mapProperties["friction"]);
+
+		// прозрачные слои рисуются раньше твердых
+		level.m_layers.reserve(transparents.size() + opaques.size());
+		for (auto& layer : transparents)
+		{
+			level.m_layers.push_back(move(layer));
+		}
+		for (auto& layer : opaques)
+		{
+			level.m_layers.push_back(move(layer));
+		}
+
+		if (Diagnostics::isEnabled())
+		{
+			cout << "Tmx: " << mapCfg << " parsed in " << clock.getElapsedTime().asMilliseconds() << " ms" << endl;
+		}
+		return level;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
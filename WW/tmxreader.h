@@ -0,0 +1,97 @@
+#ifndef TMXREADER_H
+#define TMXREADER_H
+
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <iostream>
+
+#include <SFML/Graphics.hpp>
+
+#include "leveldata.h"
+#include "layerdecoder.h"
+#include "xmlreader.h"
+#include "diagnostics.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	читает уровень из tmx файла и файлов конфигурации игроков
+				файлы разбираются потоково через XmlReader без построения дерева,
+				изображения не загружаются, в LevelData попадают только пути
+	*/
+	class TmxReader final
+	{
+		// @brief номера имен элементов и атрибутов для одного XmlReader
+		struct Names;
+		// @brief таблица строк уровня без повторов на время разбора
+		struct Strings;
+		/*
+			@brief разбирает цвет #RRGGBB или #AARRGGBB
+			@param color значение атрибута, пустое - белый цвет
+			@ret   цвет
+		*/
+		static sf::Color readColor(const StringView& color);
+		/*
+			@brief выполняет чтение свойств
+			@param reader читатель в начале элемента properties
+			@param names имена
+			@param data результирующий ассоциативный массив
+		*/
+		static void readProperties(XmlReader& reader, const Names& names, std::map<std::string, std::string>& data);
+		/*
+			@brief	выполняет чтение свойств объекта с типами
+					тип берется из атрибута type, а без него определяется по значению
+			@param reader читатель в начале элемента properties
+			@param names имена
+			@param strings таблица, в которую попадают имена и строковые значения
+			@param data результирующие свойства, дописываются в конец
+		*/
+		static void readTypedProperties(XmlReader& reader, const Names& names, Strings& strings, std::vector<LevelProperty>& data);
+		/*
+			@brief читает анимацию
+			@param reader читатель в начале элемента animation
+			@param names имена
+			@ret   описание анимации
+		*/
+		static AnimationData readAnimation(XmlReader& reader, const Names& names);
+		/*
+			@brief читает описание игрока
+			@param playerCfg файл, дескриптор игрока
+			@ret   описание игрока
+		*/
+		static PlayerData readPlayerFromFile(const std::string& playerCfg);
+		/*
+			@brief читает набор тайлов
+			@param reader читатель в начале элемента tileset
+		*/
+		static void readTileset(XmlReader& reader, const Names& names, LevelData& level);
+		/*
+			@brief	читает слой, данные разбираются сразу в номера тайлов
+			@param reader читатель в начале элемента layer
+			@param transparents прозрачные слои
+			@param opaques твердые слои
+		*/
+		static void readLayer(	XmlReader& reader, const Names& names, const LevelData& level,
+								std::vector<TileLayer>& transparents, std::vector<TileLayer>& opaques);
+		/*
+			@brief читает объекты и упомянутых в них игроков
+			@param reader читатель в начале элемента objectgroup
+			@param strings таблица строк уровня
+		*/
+		static void readObjectGroup(XmlReader& reader, const Names& names, Strings& strings, LevelData& level);
+	public:
+		/*
+			@brief читает карту и всех упомянутых в ней игроков
+			@param mapCfg файл-карта
+			@ret   уровень, в m_sources перечислены прочитанные файлы
+		*/
+		static LevelData read(const std::string& mapCfg);
+	};
+}
+
+#endif // !TMXREADER_H
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "workerpool.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	unsigned WorkerPool::getThreadCount()
+	{
+		// hardware_concurrency может вернуть 0, если число ядер неизвестно
+		return std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	unsigned WorkerPool::forEach(	size_t count, const std::function<void(size_t)>& job,
+									const std::atomic<bool>* cancel)
+	{
+		std::atomic<size_t> next(0);
+		std::atomic<bool> failed(false);
+		std::exception_ptr error;
+
+		auto worker = [&]()
+		{
+			for (size_t i = next++; i < count; i = next++)
+			{
+				if (failed || (cancel && *cancel))
+				{
+					break;
+				}
+				try
+				{
+					job(i);
+				}
+				catch (...)
+				{
+					if (!failed.exchange(true))
+					{
+						error = std::current_exception();
+					}
+				}
+			}
+		};
+
+		// текущий поток тоже работает, поэтому запускается на один меньше
+		const unsigned threadCount = static_cast<unsigned>(std::min<size_t>(getThreadCount(), count));
+		std::vector<std::thread> threads;
+		for (unsigned i = 1; i < threadCount; ++i)
+		{
+			threads.push_back(std::thread(worker));
+		}
+		worker();
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+		return std::max(threadCount, 1u);
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+namespace GameSpace
+{
+	/*
+		@brief	параллельное выполнение независимых заданий
+				потоки забирают задания по одному, поэтому долгие задания
+				не задерживают остальные
+	*/
+	class WorkerPool final
+	{
+		WorkerPool() = delete;
+	public:
+		/*
+			@brief количество рабочих потоков, не меньше одного
+		*/
+		static unsigned getThreadCount();
+		/*
+			@brief	выполняет job(0) ... job(count - 1) на рабочих потоках и ждет их
+					после первой ошибки новые задания не выдаются, ошибка бросается здесь
+			@param count количество заданий
+			@param job задание, вызывается из разных потоков одновременно
+			@param cancel флаг отмены, проверяется перед каждым заданием
+			@ret   количество использованных потоков
+		*/
+		static unsigned forEach(size_t count, const std::function<void(size_t)>& job,
+								const std::atomic<bool>* cancel = nullptr);
+	};
+}
+
+#endif // !WORKERPOOL_H
\ No newline at end of file
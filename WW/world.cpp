@@ -42,471 +42,842 @@ namespace GameSpace
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	std::string World::readValFromXML(TiXmlElement* element, const std::string& name)
+	const float World::m_lowFilter = 0.4f;
+	const int World::m_maxSteps = 5;
+	const float World::m_tickFrame = 1.0f / 60.0f;
+	//////////////////////////////////////////////////////////////////////////
+	World::World()
+		:	m_region(m_entities), m_activeMargin(256.0f), m_viewSize(0.0f, 0.0f), m_levelBottom(0.0f),
+			m_groundBody(nullptr), m_input(std::make_shared<KeyboardInput>()), m_timeWarp(1.0f),
+			m_step(0.0f), m_accumulator(0.0f), m_alpha(1.0f), m_frameDelta(0.0f),
+			m_hotReload(false)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::buildAtlas(const LevelLoader::Result& prepared, const std::string& name)
 	{
-		const char* value = element->Attribute(name.c_str());
-		if (!value)
+		const LevelData& level = *prepared.m_level;
+		m_mapBgColor = level.m_bgColor;
+		resetTiming(level);
+		m_physWorld.reset(new b2World(b2Vec2(level.m_gravityX, level.m_gravityY)));
+		m_physWorld->SetContactListener(&m_contactDispatcher);
+
+		std::vector<ImagePtr> images;
+		for (const auto& image : prepared.m_images)
 		{
-			throw std::runtime_error("GameSpace::World::readValFromXML if (!value)");
+			images.push_back(image.second);
 		}
-		return std::string(value);
+		// при повторном запуске атлас со страницами в видеопамяти уже готов
+		m_atlas = m_assetCache.findAtlas(name, images);
+		if (m_atlas)
+		{
+			return;
+		}
+
+		// все изображения уровня, включая игроков, собираются в атлас
+		auto atlas = std::make_shared<TextureAtlas>();
+		for (const auto& image : prepared.m_images)
+		{
+			if (!atlas->contains(image.first))
+			{
+				atlas->add(image.first, *image.second);
+			}
+		}
+		atlas->build(m_textureCache, name);
+		m_atlas = atlas;
+		m_assetCache.putAtlas(name, images, m_atlas);
 	}
 	//////////////////////////////////////////////////////////////////////////
-	Animation World::readAnimationFromXML(TiXmlElement* rootElement)
+	void World::buildTiles(const LevelData& level)
 	{
 		using namespace std;
 
-		auto getStateFromStr = [](const string& src) -> Animation::MoveState
+		// одинаковые тайлы ссылаются на один участок атласа
+		for (const auto& tile : level.m_tiles)
 		{
-			if (src == "stay_right")
-			{
-				return Animation::MoveState::MS_STAY_RIGHT;
-			}
-			else if (src == "stay_left")
-			{
-				return Animation::MoveState::MS_STAY_LEFT;
-			}
-			else if (src == "move_right")
-			{
-				return Animation::MoveState::MS_MOVE_RIGHT;
-			}
-			else if (src == "move_left")
-			{
-				return Animation::MoveState::MS_MOVE_LEFT;
-			}
-			else if (src == "jump_right")
-			{
-				return Animation::MoveState::MS_JUMP_RIGHT;
-			}
-			else if (src == "jump_left")
-			{
-				return Animation::MoveState::MS_JUMP_LEFT;
-			}
-			else if (src == "fall_right")
-			{
-				return Animation::MoveState::MS_FALL_RIGHT;
-			}
-			else if (src == "fall_left")
-			{
-				return Animation::MoveState::MS_FALL_LEFT;
-			}
-			throw std::runtime_error("GameSpace::World::readAnimationFromXML getStateFromStr");
-		};
+			m_tileSet.set(tile.first, m_atlas->get(level.getTileImage(tile.first)));
+		}
+
+		m_tileLayers = level.m_layers;
+
+		const sf::Vector2f size(static_cast<float>(level.m_width * level.m_tileWidth),
+								static_cast<float>(level.m_height * level.m_tileHeight));
+		m_region.reset(size);
+		m_levelBottom = size.y;
 
-		const int defxpos = stoi(readValFromXML(rootElement, "defimgx"));
-		const int defypos = stoi(readValFromXML(rootElement, "defimgy"));
-		const int defwidth = stoi(readValFromXML(rootElement, "defimgwidth"));
-		const int defheight = stoi(readValFromXML(rootElement, "defimgheight"));
-		const Animation::MoveState defstate(getStateFromStr(readValFromXML(rootElement, "initstate")));
+		m_tileCollision.m_mainObject = nullptr;
+		m_tileCollision.m_mainObjectType = PhysicObject::Collision::PhysicObjectType::POT_HARD;
+		m_tileCollision.m_onCollide = nullptr;
+		m_tileCollision.m_onUnCollide = nullptr;
 
-		Animation animator(sf::IntRect(defxpos, defxpos, defwidth, defheight), defstate);
+		m_tileRenderer.build(m_tileLayers, m_tileSet);
+		buildGround(level);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::buildGround(const LevelData& level)
+	{
+		using namespace std;
 
-		for (TiXmlElement* state = rootElement->FirstChildElement(); state; state = state->NextSiblingElement())
+		if (m_groundBody)
 		{
-			const Animation::MoveState mstate(getStateFromStr(state->Value()));
-			animator.setStateSpeed(mstate, stof(readValFromXML(state, "speed")));
-			for (TiXmlElement* image = state->FirstChildElement(); image; image = image->NextSiblingElement())
+			m_physWorld->DestroyBody(m_groundBody);
+			m_groundBody = nullptr;
+		}
+		// все твердые клетки собираются в контуры на одном статическом теле
+		GroundBuilder ground(level.m_width, level.m_height, level.m_tileWidth, level.m_tileHeight);
+		for (const auto& layer : m_tileLayers)
+		{
+			if (layer.m_kind == TileLayer::Kind::TL_OPAQUE)
 			{
-				const int x = stoi(readValFromXML(image, "x"));
-				const int y = stoi(readValFromXML(image, "y"));
-				const int width = stoi(readValFromXML(image, "width"));
-				const int height = stoi(readValFromXML(image, "height"));
-				animator.addFrame(mstate, sf::IntRect(x, y, width, height));
+				ground.addLayer(layer, m_tileSet);
 			}
 		}
-
-		return animator;
+		m_groundBody = ground.build(m_physWorld.get(), level.m_friction, &m_tileCollision);
+		if (Diagnostics::isEnabled())
+		{
+			cout << "Ground: " << ground.getOutlineCount() << " outlines, " << ground.getVertexCount() << " vertices" << endl;
+		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	HUD World::readHUDFromXML(TiXmlElement* rootElement)
+	std::shared_ptr<Object> World::buildObject(const ObjectFactory::Resolver& resolver, const LevelLoader::Result& prepared, const LevelObject& object)
 	{
-		using namespace std;
-		sf::Image hudImage;
-		if (!hudImage.loadFromFile(readValFromXML(rootElement, "file")))
+		assert(m_physWorld && m_atlas);
+
+		const ObjectContext context(*prepared.m_level, prepared, *m_atlas, m_physWorld.get(), m_entities, object);
+		const std::shared_ptr<Object> gameObject(resolver.create(context));
+		if (!gameObject)
+		{	// незарегистрированные типы пропускаются
+			return nullptr;
+		}
+		const EntityStore::Entity entity = gameObject->getEntity();
+		if (entity >= m_gameObjects.size())
 		{
-			throw runtime_error("GameSpace::World::readHUDFromXML if (!hudImage.loadFromFile(...))");
+			m_gameObjects.resize(entity + 1);
 		}
+		m_gameObjects[entity] = gameObject;
+		m_region.add(entity);
 
-		const std::string fontFile = readValFromXML(rootElement, "font");
-		const int fontSize = stoi(readValFromXML(rootElement, "fontsize"));
-
-		auto readImgRect = [this](TiXmlElement* el, sf::IntRect& result)
+		const auto playerObject = std::dynamic_pointer_cast<PlayerObject>(gameObject);
+		if (playerObject)
 		{
-			result.left = stoi(readValFromXML(el, "srcX"));
-			result.top = stoi(readValFromXML(el, "srcY"));
-			result.width = stoi(readValFromXML(el, "srcWidth"));
-			result.height = stoi(readValFromXML(el, "srcHeight"));
-		};
-
-		TiXmlElement* live = rootElement->FirstChildElement("live");
-		if (!live)
+			m_controlView = std::bind(&PlayerObject::controlView, playerObject, std::placeholders::_1);
+			m_drawHUD = std::bind(&PlayerObject::drawHUD, playerObject, std::placeholders::_1);
+			m_playerWin = std::bind(&PlayerObject::isWin, playerObject);
+			m_playerFail = std::bind(&PlayerObject::isFail, playerObject);
+			m_player = playerObject;
+		}
+		return gameObject;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::clearLevel()
+	{
+		m_reload.reset(nullptr);
+		if (m_watcher)
 		{
-			throw runtime_error("GameSpace::World::readHUDFromXML if (!live)");
+			m_watcher->clear();
 		}
-		sf::IntRect liveRect;
-		readImgRect(live, liveRect);
-
-		TiXmlElement* coin = rootElement->FirstChildElement("coin");
-		if (!coin)
+		if (m_level)
 		{
-			throw std::runtime_error("GameSpace::World::readHUDFromXML if (!coin)");
+			try
+			{
+				m_input->end();
+			}
+			catch (const std::exception& e)
+			{	// неудачная запись повтора не мешает игре
+				std::cerr << "Input: " << e.what() << std::endl;
+			}
 		}
-		sf::IntRect coinRect;
-		readImgRect(coin, coinRect);
-
-		return HUD(fontFile, fontSize, hudImage, liveRect, coinRect);
+		m_region.clear();
+		// привязки держат игрока: его сущность освобождается вместе с остальными
+		m_controlView = nullptr;
+		m_drawHUD = nullptr;
+		m_playerWin = nullptr;
+		m_playerFail = nullptr;
+		m_gameObjects.clear();
+		m_entities.clear();
+		m_levelObjects.clear();
+		m_player.reset();
+		m_level.reset();
+		m_groundBody = nullptr;
+		m_tileRenderer.clear();
+		m_tileLayers.clear();
+		m_tileSet.clear();
+		m_physWorld.reset(nullptr);
+		m_atlas.reset();
+		m_lastLevel.clear();
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void World::loadPlayerFromFile(const std::string& playerCfg, int leftX, int bottomY)
+	bool World::runBuildStep()
 	{
-		using namespace std;
-		assert(m_physWorld);
+		assert(m_build && m_build->m_prepared);
+		const LevelData& level = *m_build->m_prepared->m_level;
+		sf::Clock clock;
 
-		TiXmlDocument playerFile(playerCfg.c_str());
-		if (!playerFile.LoadFile())
+		if (m_build->m_step == 0)
 		{
-			throw runtime_error("GameSpace::World::loadPlayerFromFile if (!playerFile.LoadFile())");
+			buildAtlas(*m_build->m_prepared, m_build->m_name);
+			// изображения уже в видеопамяти
+			m_build->m_prepared->m_images.clear();
 		}
-		TiXmlElement* rootElement = playerFile.FirstChildElement("player");
-		if (!rootElement)
+		else if (m_build->m_step == 1)
 		{
-			throw runtime_error("GameSpace::World::loadPlayerFromFile if (!rootElement)");
+			buildTiles(level);
+			// имена типов и свойств сопоставляются один раз, а не для каждого объекта
+			m_build->m_objects.reset(new ObjectFactory::Resolver(level));
 		}
-
-		const float density(stof(readValFromXML(rootElement, "density")));
-		const float friction(stof(readValFromXML(rootElement, "friction")));
-		const float xvelocity(stof(readValFromXML(rootElement, "xvelocity")));
-		const float yvelocity(stof(readValFromXML(rootElement, "yvelocity")));
-		const int lives(stoi(readValFromXML(rootElement, "lives")));
-		const int winCoins(stoi(readValFromXML(rootElement, "wincoin")));
-		const string file(readValFromXML(rootElement, "file"));
-		
-		TiXmlElement* animation = rootElement->FirstChildElement("animation");
-		if (!animation)
+		else if (m_build->m_step - 2 < level.m_objects.size())
 		{
-			throw runtime_error("GameSpace::World::loadPlayerFromFile if (!animation)");
+			m_levelObjects.push_back(buildObject(*m_build->m_objects, *m_build->m_prepared, level.m_objects[m_build->m_step - 2]));
 		}
-		const Animation animator(readAnimationFromXML(animation));
+		++m_build->m_step;
+		m_build->m_buildTime += clock.getElapsedTime();
 
-		TiXmlElement* hud = rootElement->FirstChildElement("hud");
-		if (!hud)
+		if (m_build->m_step < level.m_objects.size() + 2)
 		{
-			throw runtime_error("GameSpace::World::loadPlayerFromFile if (!hud)");
+			return false;
 		}
-		const HUD playerHud(readHUDFromXML(hud));
 
-		TiXmlElement* sound = rootElement->FirstChildElement("sound");;
-		if (!sound)
+		if (Diagnostics::isEnabled())
 		{
-			throw runtime_error("GameSpace::World::loadPlayerFromFile if (!sound)");
+			std::cout	<< "Load stages: build " << m_build->m_buildTime.asMilliseconds()
+						<< " ms (" << m_build->m_step << " steps)" << std::endl;
 		}
-		const PlayerSound playerSound(	readValFromXML(sound, "step"), 
-										readValFromXML(sound, "jump"),
-										readValFromXML(sound, "getLive"),
-										readValFromXML(sound, "getCoin"));
-
-		sf::Image playerImage;
-		if (!playerImage.loadFromFile(file))
+		m_lastLevel = m_build->m_name;
+		m_level = m_build->m_prepared->m_level;
+		m_build.reset(nullptr);
+		updateRegion(0.0f);
+		m_input->begin(m_lastLevel, m_level->m_stepRate);
+		if (m_watcher)
+		{
+			watchLevel();
+		}
+		// изображения уже в атласе, а прошлый атлас больше не нужен уровню:
+		// теперь их можно освободить, если память сверх бюджета
+		m_assetCache.trim();
+		if (Diagnostics::isEnabled())
+		{
+			m_textureCache.printReport(std::cout);
+			m_atlas->printReport(std::cout);
+			m_assetCache.printReport(std::cout);
+		}
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::loadFromFile(const std::string& level)
+	{
+		cancelPrefetch();
+		cancelLoad();
+		clearLevel();
+		m_textureCache.resetReport();
+		m_assetCache.resetReport();
+
+		m_build.reset(new Build);
+		m_build->m_name = level;
+		m_build->m_prepared = LevelLoader::load(level, m_assetCache);
+		m_build->m_step = 0;
+		while (!runBuildStep())
+		{
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::beginLoad(const std::string& level)
+	{
+		cancelLoad();
+		clearLevel();
+		m_textureCache.resetReport();
+		m_assetCache.resetReport();
+
+		m_build.reset(new Build);
+		m_build->m_name = level;
+		m_build->m_step = 0;
+		if (m_prefetch && m_prefetch->getPath() == level)
+		{	// уровень уже готовится или готов: подготовка продолжается без понижения приоритета
+			m_build->m_loader = std::move(m_prefetch);
+			m_build->m_loader->promote();
+			return;
+		}
+		cancelPrefetch();
+		m_build->m_loader.reset(new LevelLoader(level, m_assetCache));
+		m_build->m_loader->start();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::prefetch(const std::string& level)
+	{
+		if (m_build || (m_prefetch && m_prefetch->getPath() == level))
 		{
-			throw std::runtime_error("GameSpace::World::loadPlayerFromFile if (!playerImage.loadFromFile(file))");
+			return;
+		}
+		cancelPrefetch();
+		m_prefetch.reset(new LevelLoader(level, m_assetCache));
+		m_prefetch->start(true);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::cancelPrefetch()
+	{
+		// деструктор подготовки отменяет ее и дожидается потока
+		m_prefetch.reset(nullptr);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool World::updateLoad(sf::Time budget)
+	{
+		if (!m_build)
+		{
+			return true;
 		}
-		const int playerCenterX(static_cast<int>(leftX + animator.getDefaultFrame().width / 2.0));
-		const int playerCenterY(static_cast<int>(bottomY - animator.getDefaultFrame().height / 2.0));
-		auto player = make_shared<PlayerObject>(playerImage, playerCenterX, playerCenterY,
-												animator, m_physWorld.get(), density, friction, 
-												xvelocity, yvelocity, playerHud, playerSound, 
-												lives, winCoins);
-		m_gameObjects.push_back(player);
 
-		m_controlView = std::bind(&PlayerObject::controlView, player, std::placeholders::_1);
-		m_drawHUD = std::bind(&PlayerObject::drawHUD, player, std::placeholders::_1);
-		m_playerWin = std::bind(&PlayerObject::isWin, player);
-		m_playerFail = std::bind(&PlayerObject::isFail, player);
+		if (!m_build->m_prepared)
+		{	// фоновый поток еще разбирает уровень и декодирует изображения
+			if (!m_build->m_loader->isReady())
+			{
+				return false;
+			}
+			m_build->m_prepared = m_build->m_loader->takeResult();
+			m_build->m_loader.reset(nullptr);
+		}
+
+		// тела и текстуры создаются порциями, чтобы окно продолжало отвечать
+		sf::Clock clock;
+		do
+		{
+			if (runBuildStep())
+			{
+				return true;
+			}
+		}
+		while (clock.getElapsedTime() < budget);
+		return false;
 	}
 	//////////////////////////////////////////////////////////////////////////
-	sf::Color World::readColorFromXML(TiXmlElement* element, const std::string& name)
+	float World::getLoadProgress() const
 	{
-		using namespace std;
-		if (const char* colorPtr = element->Attribute(name.c_str()))
+		if (!m_build)
+		{
+			return 1.0f;
+		}
+		if (!m_build->m_prepared)
+		{	// первая половина - фоновая подготовка
+			return m_build->m_loader ? m_build->m_loader->getProgress() * 0.5f : 0.0f;
+		}
+		const size_t steps = m_build->m_prepared->m_level->m_objects.size() + 2;
+		return 0.5f + 0.5f * m_build->m_step / steps;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::cancelLoad()
+	{
+		if (m_build)
 		{
-			const string color(colorPtr);
-			int a = 255, r = 0, g = 0, b = 0;
-			string::size_type colorOffset = 1;
-			if (color.length() == 9)
+			m_build.reset(nullptr);
+			clearLevel();
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool World::isLoading() const
+	{
+		return m_build != nullptr;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	AssetCache& World::getAssetCache()
+	{
+		return m_assetCache;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::watchLevel()
+	{
+		assert(m_watcher && m_level);
+		std::vector<std::string> paths;
+		for (const auto& source : m_level->m_sources)
+		{
+			paths.push_back(source.m_path);
+		}
+		// изображения тайлов меняют атлас
+		paths.insert(paths.end(), m_level->m_images.begin(), m_level->m_images.end());
+		m_watcher->watch(paths);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::string World::describeObject(const LevelData& level, const LevelObject& object, bool position)
+	{
+		std::ostringstream result;
+		result << std::setprecision(9) << level.getString(object.m_type) << ' ' << object.m_gid;
+		if (position)
+		{
+			result << ' ' << object.m_x << ' ' << object.m_y;
+		}
+		for (std::uint32_t i = 0; i < object.m_propertyCount; ++i)
+		{
+			const LevelProperty& property = level.m_properties[object.m_firstProperty + i];
+			result << ' ' << level.getString(property.m_name) << '=';
+			switch (property.m_type)
 			{
-				a = stoi(color.substr(colorOffset, 2), 0, 16); colorOffset += 2;
+			case LevelProperty::Type::PT_INT:
+				result << property.m_int;
+				break;
+			case LevelProperty::Type::PT_FLOAT:
+				result << property.m_float;
+				break;
+			case LevelProperty::Type::PT_STRING:
+				result << '"' << level.getString(property.m_string) << '"';
+				break;
 			}
-			r = stoi(color.substr(colorOffset, 2), 0, 16); colorOffset += 2;
-			g = stoi(color.substr(colorOffset, 2), 0, 16); colorOffset += 2;
-			b = stoi(color.substr(colorOffset, 2), 0, 16);
-			return sf::Color(r, g, b, a);
-		}
-		return sf::Color(255, 255, 255, 255);
-	}
-	//////////////////////////////////////////////////////////////////////////
-	void World::readPropFromXML(TiXmlElement* element, std::map<std::string, std::string>& data)
-	{
-		while (element)
-		{
-			data[readValFromXML(element, "name")] = readValFromXML(element, "value");
-			element = element->NextSiblingElement();
-		}
-	}
-	//////////////////////////////////////////////////////////////////////////
-	void World::loadMapFromFile(const std::string& mapCfg)
-	{
-		/*
-			 
-			   tmx
-			    width, height, tilewidth, tileheight
-			backgroundcolor    ( )
-				+   
-				gravityx   X (float)
-				gravityy   Y (float)
-				timewarp  ( ) (float)
-				friction     (float)
-
-			   
-
-				+   
-				visible = [transparent, opaque]
-				transparent -  
-				opaque -  
-
-			     (   )
-			      
-			      
-				 player
-					+ config -     
-				 movable ( )
-					+ density - 
-					+ friction - 
-				 platform ( )
-					+ dstx -    ( )
-					+ dsty -    ( )
-					+ friction -   
-					+ speed - 
-				 jumping (  )
-					+ friction -    
-					+ restitution -    
-				 effect (-)
-					+ friction -  
-					+ restitution -  
-					+ live -     
-					+ coin -     
-					+ destroy -  "1",    ,  "0",  
-		*/
+		}
+		return result.str();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool World::patchLevel(const LevelLoader::Result& prepared)
+	{
 		using namespace std;
+		assert(m_level && m_physWorld && m_atlas);
+		const LevelData& before = *m_level;
+		const LevelData& after = *prepared.m_level;
+
+		// размер карты и слоев, изображения и файлы игроков задают атлас и все тела:
+		// такие правки пересобирают уровень целиком
+		if (after.m_width != before.m_width || after.m_height != before.m_height ||
+			after.m_tileWidth != before.m_tileWidth || after.m_tileHeight != before.m_tileHeight ||
+			after.m_layers.size() != m_tileLayers.size() || after.m_images != before.m_images)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < after.m_layers.size(); ++i)
+		{
+			const TileLayer& layer = after.m_layers[i];
+			const TileLayer& live = m_tileLayers[i];
+			if (layer.m_kind != live.m_kind || layer.m_width != live.m_width || layer.m_height != live.m_height ||
+				layer.m_tileWidth != live.m_tileWidth || layer.m_tileHeight != live.m_tileHeight)
+			{
+				return false;
+			}
+		}
+		vector<ImagePtr> images;
+		for (const auto& image : prepared.m_images)
+		{
+			images.push_back(image.second);
+		}
+		if (m_assetCache.findAtlas(m_lastLevel, images) != m_atlas)
+		{	// изменилось содержимое изображения
+			return false;
+		}
+		if (after.m_sources.size() != before.m_sources.size())
+		{
+			return false;
+		}
+		for (size_t i = 0; i < after.m_sources.size(); ++i)
+		{
+			const LevelSource& source = after.m_sources[i];
+			if (source.m_path != before.m_sources[i].m_path ||
+				(source.m_path != m_lastLevel && source.m_hash != before.m_sources[i].m_hash))
+			{
+				return false;
+			}
+		}
 
-		TiXmlDocument mapFile(mapCfg.c_str());
-		if (!mapFile.LoadFile())
-		{
-			throw runtime_error("GameSpace::World::loadMapFromFile if (!mapFile.LoadFile())");
-		}
-		TiXmlElement* rootElement = mapFile.FirstChildElement("map");
-
-		const int xTileDim(stoi(readValFromXML(rootElement, "width")));
-		const int yTileDim(stoi(readValFromXML(rootElement, "height")));
-		const int tileWidth(stoi(readValFromXML(rootElement, "tilewidth")));
-		const int tileHeight(stoi(readValFromXML(rootElement, "tileheight")));
-		m_mapBgColor = readColorFromXML(rootElement, "backgroundcolor");
-		
-		map<string, string> mapProperties;
-		readPropFromXML(rootElement->FirstChildElement("properties")->FirstChildElement(), mapProperties);
-		m_timeWarp = stof(mapProperties["timewarp"]);
-		m_physWorld.reset(new b2World(
-							b2Vec2(	stof(mapProperties["gravityx"]), 
-									stof(mapProperties["gravityy"])	)
-										));
-		m_physWorld->SetContactListener(&m_contactDispatcher);
-
-		map<int, sf::Image> tiles;
-		vector<TiXmlElement*> transparents, opaques, objects;
-
-		for (	TiXmlElement* mapItem = rootElement->FirstChildElement();
-				mapItem;
-				mapItem = mapItem->NextSiblingElement())
+		// объекты сопоставляются по описанию, игрок - без учета положения,
+		// совпавшие объекты остаются живыми со своим состоянием
+		const shared_ptr<PlayerObject> player(m_player.lock());
+		multimap<string, size_t> previous, players;
+		for (size_t i = 0; i < before.m_objects.size(); ++i)
 		{
-			if (strcmp(mapItem->Value(), "tileset") == 0)
-			{	//    
-				const int firstGid(stoi(readValFromXML(mapItem, "firstgid")));
-				for (	TiXmlElement* tileItem = mapItem->FirstChildElement();
-						tileItem;
-						tileItem = tileItem->NextSiblingElement())
-				{
-					const int tileId(firstGid + stoi(readValFromXML(tileItem, "id")));
-					TiXmlElement* imageItem = tileItem->FirstChildElement("image");
-					if (!imageItem)
-					{
-						throw runtime_error("GameSpace::World::loadMapFromFile if (!imageItem)");
-					}
-					if (!tiles[tileId].loadFromFile(readValFromXML(imageItem, "source")))
-					{
-						throw runtime_error("GameSpace::World::loadMapFromFile if (!tiles[tileId].loadFromFile(...))");
-					}
-				}
+			const shared_ptr<Object> live(m_levelObjects[i].lock());
+			if (player && live == player)
+			{
+				players.insert(make_pair(describeObject(before, before.m_objects[i], false), i));
 			}
-			else if (strcmp(mapItem->Value(), "layer") == 0)
-			{	//   
-				map<string, string> layerProperties;
-				readPropFromXML(mapItem->FirstChildElement("properties")->FirstChildElement(), layerProperties);
-				if (layerProperties["visible"] == "transparent")
-				{
-					transparents.push_back(mapItem);
-				}
-				else if (layerProperties["visible"] == "opaque")
+			else
+			{
+				previous.insert(make_pair(describeObject(before, before.m_objects[i], true), i));
+			}
+		}
+		vector<weak_ptr<Object>> objects(after.m_objects.size());
+		vector<size_t> added;
+		for (size_t i = 0; i < after.m_objects.size(); ++i)
+		{
+			auto itMatch = players.find(describeObject(after, after.m_objects[i], false));
+			if (itMatch == players.end())
+			{
+				itMatch = previous.find(describeObject(after, after.m_objects[i], true));
+				if (itMatch == previous.end())
 				{
-					opaques.push_back(mapItem);
+					added.push_back(i);
+					continue;
 				}
+				objects[i] = m_levelObjects[itMatch->second];
+				previous.erase(itMatch);
 			}
-			else if (strcmp(mapItem->Value(), "objectgroup") == 0)
-			{	//   
-				objects.push_back(mapItem);
+			else
+			{
+				objects[i] = m_levelObjects[itMatch->second];
+				players.erase(itMatch);
 			}
 		}
+		if (!players.empty())
+		{	// игрок убран или у него другой тип или файл конфигурации
+			return false;
+		}
 
-		auto processLayer = [&](vector<TiXmlElement*>& layer,
-								function<shared_ptr<Object>(const sf::Image&, int, int)> make)
+		// параметры карты
+		m_mapBgColor = after.m_bgColor;
+		if (after.m_timeWarp != before.m_timeWarp || after.m_stepRate != before.m_stepRate)
 		{
-			for (const auto& item : layer)
+			resetTiming(after);
+		}
+		m_physWorld->SetGravity(b2Vec2(after.m_gravityX, after.m_gravityY));
+
+		// тайлы
+		size_t chunks = 0;
+		const bool tilesChanged = after.m_tiles != before.m_tiles;
+		bool groundChanged = after.m_friction != before.m_friction;
+		if (tilesChanged)
+		{	// номер тайла указывает на другое изображение: меняться могут любые куски
+			m_tileSet.clear();
+			for (const auto& tile : after.m_tiles)
 			{
-				int currentTileNum = 0;
-				for (TiXmlElement* dataItem = item->FirstChildElement("data")->FirstChildElement();
-					dataItem;
-					dataItem = dataItem->NextSiblingElement())
+				m_tileSet.set(tile.first, m_atlas->get(after.getTileImage(tile.first)));
+			}
+			m_tileLayers = after.m_layers;
+			m_tileRenderer.build(m_tileLayers, m_tileSet);
+			groundChanged = true;
+		}
+		else
+		{
+			for (size_t i = 0; i < after.m_layers.size(); ++i)
+			{
+				const size_t rebuilt = m_tileRenderer.rebuild(i, m_tileLayers[i], after.m_layers[i], m_tileSet);
+				chunks += rebuilt;
+				if (rebuilt && m_tileLayers[i].m_kind == TileLayer::Kind::TL_OPAQUE)
 				{
-					auto curTile = tiles.find(stoi(readValFromXML(dataItem, "gid")));
-					if (curTile != tiles.end())
-					{
-						const auto curTileSize = curTile->second.getSize();
-						const int xpos = static_cast<int>((currentTileNum % xTileDim) * tileWidth + curTileSize.x / 2.0);
-						const int ypos = static_cast<int>((currentTileNum / xTileDim) * tileHeight + curTileSize.y / 2.0);
-						m_gameObjects.push_back(make(curTile->second, xpos, ypos));
-					}
-					++currentTileNum;
+					groundChanged = true;
 				}
+				m_tileLayers[i] = after.m_layers[i];
 			}
-		};
+		}
+		if (groundChanged)
+		{
+			buildGround(after);
+		}
 
-		processLayer(transparents, [](const sf::Image& source, int x, int y)
+		// объекты
+		size_t removed = 0;
+		for (const auto& item : previous)
 		{
-			return make_shared<SimpleObject>(source, x, y);
-		});
+			const shared_ptr<Object> live(m_levelObjects[item.second].lock());
+			if (!live)
+			{
+				continue;
+			}
+			m_entities.removeBody(live->getEntity());
+			removeObject(live->getEntity());
+			++removed;
+		}
+		const ObjectFactory::Resolver resolver(after);
+		for (const size_t index : added)
+		{
+			objects[index] = buildObject(resolver, prepared, after.m_objects[index]);
+		}
 
-		processLayer(opaques, [&](const sf::Image& source, int x, int y)
+		m_levelObjects.swap(objects);
+		m_level = prepared.m_level;
+		updateRegion(0.0f);
+		if (Diagnostics::isEnabled())
+		{
+			cout	<< "Reload: ";
+			if (tilesChanged)
+			{
+				cout << "all";
+			}
+			else
+			{
+				cout << chunks;
+			}
+			cout	<< " tile chunks, ground " << (groundChanged ? "rebuilt" : "kept")
+					<< ", objects +" << added.size() << " -" << removed << endl;
+		}
+		return true;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::rebuildLevel(std::unique_ptr<LevelLoader::Result> prepared)
+	{
+		PhysicObject::BodyState playerState;
+		bool restore = false;
+		{	// прежний игрок не должен пережить свою сущность
+			const std::shared_ptr<PlayerObject> player(m_player.lock());
+			restore = player && player->getBodyState(playerState);
+		}
+		const std::string name(m_lastLevel);
+
+		clearLevel();
+		m_build.reset(new Build);
+		m_build->m_name = name;
+		m_build->m_prepared = std::move(prepared);
+		m_build->m_step = 0;
+		while (!runBuildStep())
 		{
-			return make_shared<HardObject>(source, x, y, m_physWorld.get(), stof(mapProperties["friction"]));
-		});
+		}
 
-		for (const auto& item : objects)
+		const std::shared_ptr<PlayerObject> rebuilt(m_player.lock());
+		if (restore && rebuilt)
+		{
+			rebuilt->setBodyState(playerState);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::setHotReload(bool enabled)
+	{
+		m_hotReload = enabled;
+		if (!enabled)
 		{
-			for (	TiXmlElement* objectItem = item->FirstChildElement();
-					objectItem;
-					objectItem = objectItem->NextSiblingElement())
+			m_reload.reset(nullptr);
+			m_watcher.reset(nullptr);
+			return;
+		}
+		if (!m_watcher)
+		{
+			m_watcher.reset(new FileWatcher);
+			if (m_level && !m_build)
+			{
+				watchLevel();
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::updateHotReload()
+	{
+		if (!m_hotReload || !m_watcher || m_build || !m_level)
+		{
+			return;
+		}
+		if (m_watcher->poll())
+		{	// правка во время подготовки начинает ее заново
+			if (Diagnostics::isEnabled())
+			{
+				std::cout << "Reload: " << m_lastLevel << " changed" << std::endl;
+			}
+			// загрузчик читает через кэш, поэтому измененные файлы сбрасываются из него
+			for (const auto& path : m_watcher->getChanged())
 			{
-				const string objectType(readValFromXML(objectItem, "type"));
-				const int gid(stoi(readValFromXML(objectItem, "gid")));
-				const int leftX(stoi(readValFromXML(objectItem, "x")));
-				const int bottomY(stoi(readValFromXML(objectItem, "y")));
+				m_assetCache.invalidate(path);
+			}
+			m_reload.reset(new LevelLoader(m_lastLevel, m_assetCache));
+			m_reload->start();
+		}
+		if (!m_reload || !m_reload->isReady())
+		{
+			return;
+		}
 
-				map<string, string> properties;
-				readPropFromXML(objectItem->FirstChildElement("properties")->FirstChildElement(), properties);
+		std::unique_ptr<LevelLoader::Result> prepared;
+		try
+		{
+			prepared = m_reload->takeResult();
+		}
+		catch (const std::exception& e)
+		{	// файл сохранен с ошибкой: мир остается прежним до следующего сохранения
+			std::cerr << "Reload: " << e.what() << std::endl;
+			m_reload.reset(nullptr);
+			return;
+		}
+		m_reload.reset(nullptr);
 
-				if (objectType == "player")
-				{
-					loadPlayerFromFile(properties["config"], leftX, bottomY);
-				}
-				else if (objectType == "movable")
-				{
-					const auto tileSize = tiles[gid].getSize();
-					const int centerX = static_cast<int>(leftX + tileSize.x / 2.0);
-					const int centerY = static_cast<int>(bottomY - tileSize.y / 2.0);
-					m_gameObjects.push_back(make_shared<MoveObject>(tiles[gid],
-												centerX, centerY,
-												0, 0, tileSize.x, tileSize.y,
-												m_physWorld.get(),
-												stof(properties["density"]),
-												stof(properties["friction"]))
-											);
-				}
-				else if (objectType == "platform")
-				{
-					const auto tileSize = tiles[gid].getSize();
-					const int centerX = static_cast<int>(leftX + tileSize.x / 2.0);
-					const int centerY = static_cast<int>(bottomY - tileSize.y / 2.0);
-					const int dstCenterX = static_cast<int>(stof(properties["dstx"]) + tileSize.x / 2.0);
-					const int dstCenterY = static_cast<int>(stof(properties["dsty"]) - tileSize.y / 2.0);
-					m_gameObjects.push_back(make_shared<PlatformObject>(tiles[gid],
-																		centerX, centerY,
-																		0, 0, tileSize.x, tileSize.y,
-																		m_physWorld.get(),	
-																		dstCenterX, dstCenterY, 
-																		stof(properties["friction"]), 
-																		stof(properties["speed"]))
-											);
-				}
-				else if (objectType == "jumping")
-				{
-					const auto tileSize = tiles[gid].getSize();
-					const int centerX = static_cast<int>(leftX + tileSize.x / 2.0);
-					const int centerY = static_cast<int>(bottomY - tileSize.y / 2.0);
-					m_gameObjects.push_back(make_shared<JumpingObject>(	tiles[gid],
-																		centerX, centerY,
-																		0, 0, tileSize.x, tileSize.y,
-																		m_physWorld.get(),
-																		stof(properties["friction"]),
-																		stof(properties["restitution"]))
-											);
-				}
-				else if (objectType == "effect")
-				{
-					const auto tileSize = tiles[gid].getSize();
-					const int centerX = static_cast<int>(leftX + tileSize.x / 2.0);
-					const int centerY = static_cast<int>(bottomY - tileSize.y / 2.0);
-					m_gameObjects.push_back(make_shared<EffectObject>(	tiles[gid], 
-																		centerX, centerY, 
-																		0, 0, tileSize.x, tileSize.y,
-																		m_physWorld.get(), 
-																		stof(properties["friction"]), 
-																		stof(properties["restitution"]),
-																		stoi(properties["live"]), 
-																		stoi(properties["coin"]), 
-																		(properties["destroy"] == "1"))
-											);
-				}
-				// TO DO   
+		sf::Clock clock;
+		if (patchLevel(*prepared))
+		{
+			// изображения уже в атласе
+			watchLevel();
+			if (Diagnostics::isEnabled())
+			{
+				std::cout << "Reload: patched in " << clock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+			}
+		}
+		else
+		{
+			rebuildLevel(std::move(prepared));
+			if (Diagnostics::isEnabled())
+			{
+				std::cout << "Reload: rebuilt in " << clock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
 			}
 		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void World::loadFromFile(const std::string& level)
+	void World::setInput(const std::shared_ptr<InputSource>& input)
 	{
-		m_gameObjects.clear();
-		m_physWorld.reset(nullptr);
-		loadMapFromFile(level);
-		m_lastLevel = level;
+		if (!input)
+		{
+			throw std::runtime_error("GameSpace::World::setInput if (!input)");
+		}
+		m_input = input;
+		if (m_level && !m_build)
+		{
+			m_input->begin(m_lastLevel, m_level->m_stepRate);
+		}
 	}
 	//////////////////////////////////////////////////////////////////////////
-	void World::runGameTiming(float delta)
+	void World::setActiveMargin(float margin)
 	{
-		delta *= m_timeWarp;
-
-		for (auto& itGameObject : m_gameObjects)
+		m_activeMargin = margin;
+		if (m_level && !m_build)
 		{
-			itGameObject->logic(delta);
-			itGameObject->animate(delta);
+			updateRegion(0.0f);
 		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::setViewSize(const sf::Vector2f& size)
+	{
+		m_viewSize = size;
+		if (m_level && !m_build)
+		{
+			updateRegion(0.0f);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::resetTiming(const LevelData& level)
+	{
+		m_timeWarp = level.m_timeWarp;
+		m_step = level.m_stepRate > 0.0f ? 1.0f / level.m_stepRate : 0.0f;
+		m_accumulator = 0.0f;
+		m_alpha = 1.0f;
+		m_frameDelta = 0.0f;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::runStep(float delta)
+	{
+		// ровно один снимок на шаг, даже без игрока, чтобы повтор не сдвигался
+		const InputSource::Actions actions = m_input->next();
+		const std::shared_ptr<PlayerObject> player(m_player.lock());
+		if (player)
+		{
+			player->setActions(actions);
+		}
+
+		// спящие объекты далеко от камеры не обрабатываются,
+		// из активных логику выполняют только объекты с поведением
+		updateRegion(delta);
+		m_entities.runBehaviours(m_region.getActive(), delta);
 
 		const int32 velocityIterations = 6;
 		const int32 positionIterations = 2;
 
 		m_physWorld->Step(delta, velocityIterations, positionIterations);
 
-		m_gameObjects.remove_if([](std::shared_ptr<Object>& obj){	return obj->destroy(); });
+		// уничтоженные в игре и упавшие за нижнюю границу карты объекты удаляются,
+		// спящие объекты не двигаются, поэтому проверяются только активные
+		std::vector<EntityStore::Entity> removed;
+		for (const EntityStore::Entity entity : m_region.getActive())
+		{
+			Object* const behaviour = m_entities.getBehaviour(entity);
+			if (behaviour && behaviour->destroy())
+			{
+				removed.push_back(entity);
+			}
+			else if ((!player || entity != player->getEntity()) &&
+					m_entities.isMovable(entity) && m_entities.getBounds(entity).top > m_levelBottom)
+			{
+				m_entities.removeBody(entity);
+				removed.push_back(entity);
+			}
+		}
+		for (const EntityStore::Entity entity : removed)
+		{
+			removeObject(entity);
+		}
+		m_region.refresh();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::updateRegion(float delta)
+	{
+		const std::shared_ptr<PlayerObject> player(m_player.lock());
+		if (!player || m_activeMargin < 0.0f)
+		{	// без игрока камере не за кем следить: активны все объекты
+			const float infinity = std::numeric_limits<float>::max() / 4.0f;
+			m_region.update(sf::FloatRect(-infinity, -infinity, 2.0f * infinity, 2.0f * infinity), delta);
+			return;
+		}
+		// камера следует за игроком
+		const sf::FloatRect bounds(m_entities.getBounds(player->getEntity()));
+		const sf::Vector2f half(m_viewSize.x / 2.0f + m_activeMargin, m_viewSize.y / 2.0f + m_activeMargin);
+		const sf::Vector2f center(bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f);
+		m_region.update(sf::FloatRect(center.x - half.x, center.y - half.y, 2.0f * half.x, 2.0f * half.y), delta);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::removeObject(EntityStore::Entity entity)
+	{
+		m_region.remove(entity);
+		m_gameObjects[entity].reset();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::runGameTiming(float frameTime)
+	{
+		if (m_step <= 0.0f)
+		{	// шаг на кадр: длительность кадра сглаживается
+			m_frameDelta = frameTime * m_lowFilter + m_frameDelta * (1 - m_lowFilter);
+			runStep(m_frameDelta * m_timeWarp);
+			m_alpha = 1.0f;
+			return;
+		}
+
+		m_accumulator += frameTime * m_timeWarp;
+		int steps = 0;
+		while (m_accumulator >= m_step && steps < m_maxSteps)
+		{
+			m_entities.saveBodies(m_region.getActive());
+			runStep(m_step);
+			m_accumulator -= m_step;
+			++steps;
+		}
+		if (m_accumulator >= m_step)
+		{	// кадр длиннее m_maxSteps шагов: отставание отбрасывается,
+			// иначе каждый следующий кадр считал бы еще больше шагов
+			m_accumulator = std::fmod(m_accumulator, m_step);
+		}
+		m_alpha = m_accumulator / m_step;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::setHeadless(bool headless)
+	{
+		m_textureCache.setHeadless(headless);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void World::runTick()
+	{
+		assert(m_physWorld);
+		m_entities.saveBodies(m_region.getActive());
+		runStep(getTickStep());
+		m_accumulator = 0.0f;
+		m_alpha = 1.0f;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	float World::getTickStep() const
+	{
+		return m_step > 0.0f ? m_step : m_tickFrame * m_timeWarp;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t World::getBodyCount() const
+	{
+		return m_physWorld ? static_cast<size_t>(m_physWorld->GetBodyCount()) : 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t World::getContactCount() const
+	{
+		return m_physWorld ? static_cast<size_t>(m_physWorld->GetContactCount()) : 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool World::hasPlayer() const
+	{
+		return !m_player.expired();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t World::getObjectCount() const
+	{
+		return m_entities.getSize();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	size_t World::getActiveObjectCount() const
+	{
+		return m_region.getActive().size();
 	}
 	//////////////////////////////////////////////////////////////////////////
 	void World::runDrawing(sf::RenderWindow& render)
 	{
+		m_entities.interpolate(m_region.getActive(), m_alpha);
+
 		assert(m_controlView);
 		m_controlView(render);
 
@@ -515,10 +886,9 @@ namespace GameSpace
 		bgShape.setFillColor(m_mapBgColor);
 		render.draw(bgShape);
 
-		for (auto& itGameObject : m_gameObjects)
-		{
-			itGameObject->draw(render);
-		}
+		m_tileRenderer.draw(render);
+
+		m_entities.draw(m_region.getActive(), render);
 
 		assert(m_drawHUD);
 		m_drawHUD(render);
@@ -2,27 +2,44 @@
 #define WORLD_H
 
 #include <memory>
-#include <list>
 #include <string>
 #include <algorithm>
 #include <vector>
 #include <map>
 #include <functional>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
 
 #include <SFML/Graphics.hpp>
 #include <Box2D/Box2D.h>
-#include <tinyxml.h>
 
 #include "object.h"
 #include "animation.h"
 #include "hud.h"
 #include "music.h"
+#include "texturecache.h"
+#include "atlas.h"
+#include "tilelayer.h"
+#include "tilerenderer.h"
+#include "ground.h"
+#include "leveldata.h"
+#include "levelfile.h"
+#include "assetcache.h"
+#include "levelloader.h"
+#include "objectfactory.h"
+#include "filewatcher.h"
+#include "input.h"
+#include "activeregion.h"
+#include "entitystore.h"
+#include "diagnostics.h"
 
 namespace GameSpace
 {
 	//////////////////////////////////////////////////////////////////////////
-	//  -  
+	// Класс - диспетчер столкновений
 	//////////////////////////////////////////////////////////////////////////
 	class ContactDispatcher : public b2ContactListener
 	{
@@ -30,7 +47,7 @@ namespace GameSpace
 		void EndContact(b2Contact* contact) override;
 	};
 	//////////////////////////////////////////////////////////////////////////
-	//   
+	// Класс игрового мира
 	//////////////////////////////////////////////////////////////////////////
 	class World final
 	{
@@ -38,7 +55,39 @@ namespace GameSpace
 
 		std::unique_ptr<b2World> m_physWorld;
 
-		std::list<std::shared_ptr<Object>> m_gameObjects;
+		// состояние объектов по компонентам: шаг и отрисовка проходят по его массивам
+		EntityStore m_entities;
+		// объекты по номерам сущностей, пустые - номер свободен
+		std::vector<std::shared_ptr<Object>> m_gameObjects;
+		// объекты рядом с камерой: только они выполняют логику, двигаются и рисуются
+		ActiveRegion m_region;
+		float m_activeMargin;		// поле вокруг вида в пикселях, отрицательное - активны все объекты
+		sf::Vector2f m_viewSize;	// размер вида, задается до первого шага
+		float m_levelBottom;		// нижняя граница карты, упавшие ниже объекты удаляются
+
+		// реестр текстур, общих для объектов уровня
+		TextureCache m_textureCache;
+		// ресурсы, которые переживают загрузку уровня
+		AssetCache m_assetCache;
+		// атлас изображений текущего уровня, общий с m_assetCache
+		AtlasPtr m_atlas;
+
+		// слои тайлов в порядке отрисовки, хранятся отдельно от объектов
+		std::vector<TileLayer> m_tileLayers;
+		TileSet m_tileSet;
+		TileRenderer m_tileRenderer;
+		// дескриптор столкновений, общий для всех твердых тайлов
+		PhysicObject::Collision m_tileCollision;
+		// статическое тело твердых слоев
+		b2Body* m_groundBody;
+
+		// уровень, по которому собран мир, общий с m_assetCache
+		LevelPtr m_level;
+		// объекты мира по номерам объектов уровня, пустые - не созданы или уничтожены в игре
+		std::vector<std::weak_ptr<Object>> m_levelObjects;
+		std::weak_ptr<PlayerObject> m_player;
+		// управление игроком, снимок запрашивается на каждый шаг
+		std::shared_ptr<InputSource> m_input;
 
 		std::string m_lastLevel;
 
@@ -46,104 +95,271 @@ namespace GameSpace
 		World& operator=(const World& other) = delete;
 
 		/*
-			@brief    XML 
-			@param element XML 
-			@param name  
-			@ret   
+			@brief	функция для контроля вида
+					вызывается перед рисованием
 		*/
-		std::string readValFromXML(TiXmlElement* element, const std::string& name);
+		std::function<void(sf::RenderWindow&)> m_controlView;
 		/*
-			@brief    XML 
-			@param rootElement  XML 
-			@ret   
+			@brief функция для отрисовки информационных панелей пользователя
 		*/
-		Animation readAnimationFromXML(TiXmlElement* rootElement);
+		std::function<void(sf::RenderWindow&)> m_drawHUD;
 		/*
-			@brief  HUD  XML 
-			@param rootElement  ,  HUD
-			@ret    HUD
+			@brief проверка игрока на выйгрыш
 		*/
-		HUD readHUDFromXML(TiXmlElement* rootElement);
+		std::function<bool()> m_playerWin;
 		/*
-			@brief        
-			@param playerCfg ,  
-			@param leftX  
-			@param bottomY  
+			@brief проверка игрока на проигрыш
 		*/
-		void loadPlayerFromFile(const std::string& playerCfg, int leftX, int bottomY);
+		std::function<bool()> m_playerFail;
 		/*
-			@brief	   
-					  
+			@brief цвет заднего фона
 		*/
-		std::function<void(sf::RenderWindow&)> m_controlView;
+		sf::Color m_mapBgColor;
 		/*
-			@brief      
+			@brief параметр модификации времени
 		*/
-		std::function<void(sf::RenderWindow&)> m_drawHUD;
+		float m_timeWarp;
 		/*
-			@brief    
+			@brief	шаг физики в секундах игрового времени, 0 - шаг на кадр
+					постоянный шаг делает игру одинаковой при любой частоте кадров
 		*/
-		std::function<bool()> m_playerWin;
+		float m_step;
+		float m_accumulator;	// игровое время, еще не отработанное шагами
+		float m_alpha;			// доля шага после последнего шага, для отрисовки
+		float m_frameDelta;		// сглаженная длительность кадра при шаге на кадр
+		static const float m_lowFilter;
+		static const int m_maxSteps;	// больше шагов за кадр игра замедляется, а не копит отставание
+		static const float m_tickFrame;	// кадр отдельного шага уровня без постоянного шага
+		// @brief незавершенная сборка уровня
+		struct Build
+		{
+			std::string m_name;
+			std::unique_ptr<LevelLoader> m_loader;				// пока идет фоновая подготовка
+			std::unique_ptr<LevelLoader::Result> m_prepared;	// после подготовки
+			size_t m_step;										// следующий шаг сборки
+			std::unique_ptr<ObjectFactory::Resolver> m_objects;	// создание объектов, после сборки тайлов
+			sf::Time m_buildTime;								// время всех шагов сборки
+		};
+		std::unique_ptr<Build> m_build;
+		// упреждающая подготовка уровня, который игрок вероятно выберет следующим
+		std::unique_ptr<LevelLoader> m_prefetch;
+		// перезагрузка уровня на лету при правке его файлов (режим разработки)
+		bool m_hotReload;
+		std::unique_ptr<FileWatcher> m_watcher;
+		std::unique_ptr<LevelLoader> m_reload;	// подготовка измененного уровня
 		/*
-			@brief    
+			@brief создает мир физики и собирает атлас из подготовленных изображений
+			@param prepared подготовленный уровень
+			@param name имя уровня для отчетов
 		*/
-		std::function<bool()> m_playerFail;
+		void buildAtlas(const LevelLoader::Result& prepared, const std::string& name);
 		/*
-			@brief   
+			@brief строит слои тайлов, их отрисовку и столкновения
+			@param level уровень
 		*/
-		sf::Color m_mapBgColor;
+		void buildTiles(const LevelData& level);
 		/*
-			@brief   
+			@brief строит тело твердых слоев заново, прежнее тело удаляется
+			@param level уровень
 		*/
-		float m_timeWarp;
+		void buildGround(const LevelData& level);
+		/*
+			@brief	создает объект карты через ObjectFactory
+					игрок дополнительно привязывается к виду, HUD и проверкам конца уровня
+			@param resolver типы объектов, сопоставленные с уровнем
+			@param prepared подготовленный уровень
+			@param object описание объекта
+			@ret   объект или nullptr для незарегистрированного типа
+		*/
+		std::shared_ptr<Object> buildObject(const ObjectFactory::Resolver& resolver, const LevelLoader::Result& prepared, const LevelObject& object);
+		/*
+			@brief удаляет все объекты уровня
+		*/
+		void clearLevel();
 		/*
-			@brief   
-			@param element     
-			@param name  
-			@ret   
+			@brief	выполняет один шаг сборки: атлас, тайлы или один объект
+			@ret	завершена ли сборка
 		*/
-		sf::Color readColorFromXML(TiXmlElement* element, const std::string& name);
+		bool runBuildStep();
 		/*
-			@brief   
-			@param element   
-			@param data   
+			@brief задает шаг физики уровня и сбрасывает накопленное время
 		*/
-		void readPropFromXML(TiXmlElement* element, std::map<std::string, std::string>& data);
+		void resetTiming(const LevelData& level);
 		/*
-			@brief     tmx 
-			@param mapCfg -
+			@brief	выполняет один шаг логики и физики
+			@param delta длительность шага игрового времени в секундах
 		*/
-		void loadMapFromFile(const std::string& mapCfg);
+		void runStep(float delta);
+		/*
+			@brief	обновляет активную область вокруг игрока
+			@param delta игровое время с прошлого обновления в секундах
+		*/
+		void updateRegion(float delta);
+		/*
+			@brief	удаляет объект из мира и активной области
+			@param entity сущность объекта
+		*/
+		void removeObject(EntityStore::Entity entity);
+		/*
+			@brief передает наблюдателю файлы текущего уровня: исходные файлы и изображения
+		*/
+		void watchLevel();
+		/*
+			@brief	описание объекта уровня для сопоставления при перезагрузке
+			@param position учитывать ли положение
+		*/
+		static std::string describeObject(const LevelData& level, const LevelObject& object, bool position);
+		/*
+			@brief	применяет к живому миру только отличия измененного уровня:
+					перестраивает измененные куски тайлов и тело твердых слоев,
+					создает новые и удаляет убранные объекты, остальные объекты
+					и игрок сохраняют свое состояние
+			@param prepared подготовленный измененный уровень
+			@ret   false, если отличия требуют полной пересборки, мир при этом не меняется
+		*/
+		bool patchLevel(const LevelLoader::Result& prepared);
+		/*
+			@brief	пересобирает мир из подготовленного уровня целиком,
+					положение и скорость игрока сохраняются
+		*/
+		void rebuildLevel(std::unique_ptr<LevelLoader::Result> prepared);
 	public:
-		World() = default;
+		World();
 		~World() = default;
 		/*
-			@brief   
-			@param level   
+			@brief выполняет загрузку уровня
+			@param level файл с уровнем
 		*/
 		void loadFromFile(const std::string& level);
 		/*
-			@brief    
-			@param delta     
+			@brief	начинает загрузку уровня в фоне
+					предыдущий уровень удаляется сразу
+			@param level файл с уровнем
+		*/
+		void beginLoad(const std::string& level);
+		/*
+			@brief	начинает упреждающую подготовку уровня с низким приоритетом
+					если затем начнется загрузка этого уровня, она продолжит подготовку,
+					загрузка другого уровня подготовку отменяет
+			@param level файл с уровнем
+		*/
+		void prefetch(const std::string& level);
+		/*
+			@brief прерывает упреждающую подготовку
+		*/
+		void cancelPrefetch();
+		/*
+			@brief	продолжает загрузку, вызывается каждый кадр
+			@param budget время, которое можно потратить в этом кадре
+			@ret	завершена ли загрузка
+		*/
+		bool updateLoad(sf::Time budget);
+		/*
+			@brief доля выполненной загрузки от 0 до 1
+		*/
+		float getLoadProgress() const;
+		/*
+			@brief прерывает загрузку, мир остается пустым
+		*/
+		void cancelLoad();
+		/*
+			@brief идет ли загрузка
+		*/
+		bool isLoading() const;
+		/*
+			@brief ресурсы, переживающие загрузку уровня, с бюджетами памяти и статистикой
+		*/
+		AssetCache& getAssetCache();
+		/*
+			@brief	включает перезагрузку уровня на лету при изменении его файлов
+			@param enabled включить или выключить
+		*/
+		void setHotReload(bool enabled);
+		/*
+			@brief	проверяет изменения файлов уровня и применяет их, вызывается каждый кадр игры
+					измененный уровень подготавливается в фоне, ошибка в файле
+					только выводится в консоль, мир остается прежним
+		*/
+		void updateHotReload();
+		/*
+			@brief	заменяет источник управления, по умолчанию клавиатура
+					источник узнает о начале каждого уровня и его удалении
+			@param input источник
+		*/
+		void setInput(const std::shared_ptr<InputSource>& input);
+		/*
+			@brief	задает поле активной области вокруг вида
+					объекты за полем спят: не выполняют логику, их тела выключены
+			@param margin поле в пикселях, отрицательное - активны все объекты
+		*/
+		void setActiveMargin(float margin);
+		/*
+			@brief	задает размер вида, вокруг которого строится активная область
+					задается до первого шага, чтобы шаги не зависели от наличия окна
+			@param size размер вида в пикселях
+		*/
+		void setViewSize(const sf::Vector2f& size);
+		/*
+			@brief	выполняет проработку игрового времени
+					при постоянном шаге выполняет от 0 до m_maxSteps шагов физики,
+					остаток времени переходит в следующий кадр
+			@param frameTime длительность кадра в секундах
+		*/
+		void runGameTiming(float frameTime);
+		/*
+			@brief	режим без окна: текстуры не загружаются в видеопамять,
+					задается до загрузки уровня
+			@param headless включить или выключить
+		*/
+		void setHeadless(bool headless);
+		/*
+			@brief	выполняет ровно один шаг физики независимо от времени кадра
+					для прогона уровня без окна, уровень без постоянного шага
+					получает шаг одного кадра при 60 кадрах в секунду
+		*/
+		void runTick();
+		/*
+			@brief длительность шага runTick в секундах игрового времени
+		*/
+		float getTickStep() const;
+		/*
+			@brief количество тел в мире физики
+		*/
+		size_t getBodyCount() const;
+		/*
+			@brief количество контактов в мире физики, включая еще не касающиеся пары
+		*/
+		size_t getContactCount() const;
+		/*
+			@brief есть ли на уровне игрок, без него проверки выигрыша и проигрыша недоступны
+		*/
+		bool hasPlayer() const;
+		/*
+			@brief количество объектов уровня
+		*/
+		size_t getObjectCount() const;
+		/*
+			@brief количество объектов в активной области
 		*/
-		void runGameTiming(float delta);
+		size_t getActiveObjectCount() const;
 		/*
-			@brief   
+			@brief	выполняет прорисовку объектов
+					объекты рисуются между двумя последними шагами физики
 		*/
 		void runDrawing(sf::RenderWindow& render);
 		/*
-			@brief   
-			@ret     
+			@brief проверка на выйгрышь
+			@ret   выйгран ли уровень
 		*/
 		bool isWin();
 		/*
-			@brief   
-			@ret     
+			@brief проверка на проигрышь
+			@ret   проигран ли уровень
 		*/
 		bool isFail();
 		/*
-			@brief  ,     
-			@ret     
+			@brief возвращает путь, по которому был загружен уровень
+			@ret   путь к уровню
 		*/
 		const std::string& getLastLevel() const;
 	};
@@ -0,0 +1,538 @@
+#include "xmlreader.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		// числа короткие, поэтому копируются в буфер с завершающим нулем
+		const size_t numberBufferSize = 64;
+
+		bool copyNumber(const StringView& value, char (&buffer)[numberBufferSize])
+		{
+			if (value.m_size == 0 || value.m_size >= numberBufferSize)
+			{
+				return false;
+			}
+			std::memcpy(buffer, value.m_data, value.m_size);
+			buffer[value.m_size] = '\0';
+			return true;
+		}
+
+		bool isSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	int StringView::toInt() const
+	{
+		char buffer[numberBufferSize];
+		char* end = nullptr;
+		const long value = copyNumber(*this, buffer) ? std::strtol(buffer, &end, 10) : 0;
+		if (!end || *end != '\0')
+		{
+			throw std::runtime_error("GameSpace::StringView::toInt if (!end || *end != '\\0')");
+		}
+		return static_cast<int>(value);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	std::uint32_t StringView::toUInt() const
+	{
+		char buffer[numberBufferSize];
+		char* end = nullptr;
+		const unsigned long value = copyNumber(*this, buffer) ? std::strtoul(buffer, &end, 10) : 0;
+		if (!end || *end != '\0')
+		{
+			throw std::runtime_error("GameSpace::StringView::toUInt if (!end || *end != '\\0')");
+		}
+		return static_cast<std::uint32_t>(value);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	float StringView::toFloat() const
+	{
+		char buffer[numberBufferSize];
+		char* end = nullptr;
+		const double value = copyNumber(*this, buffer) ? std::strtod(buffer, &end) : 0.0;
+		if (!end || *end != '\0')
+		{
+			throw std::runtime_error("GameSpace::StringView::toFloat if (!end || *end != '\\0')");
+		}
+		return static_cast<float>(value);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool StringView::isInt() const
+	{
+		char buffer[numberBufferSize];
+		char* end = nullptr;
+		if (copyNumber(*this, buffer))
+		{
+			std::strtol(buffer, &end, 10);
+		}
+		return end && *end == '\0';
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool StringView::isFloat() const
+	{
+		char buffer[numberBufferSize];
+		char* end = nullptr;
+		if (copyNumber(*this, buffer))
+		{
+			std::strtod(buffer, &end);
+		}
+		return end && *end == '\0';
+	}
+	//////////////////////////////////////////////////////////////////////////
+	XmlReader::XmlReader(const std::string& path)
+	{
+		m_resource = Resources::open(path);
+		if (!m_resource)
+		{
+			throw std::runtime_error("GameSpace::XmlReader::XmlReader if (!m_resource)");
+		}
+		init(reinterpret_cast<const char*>(m_resource->getData()), m_resource->getSize());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	XmlReader::XmlReader(const char* data, size_t size)
+	{
+		init(data, size);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void XmlReader::init(const char* data, size_t size)
+	{
+		m_pos = data ? data : "";
+		m_end = m_pos + size;
+		m_event = Event::XE_EOF;
+		m_name = 0;
+		m_pendingEnd = false;
+		m_buckets.assign(64, 0);
+
+		// метка порядка байт UTF-8
+		if (m_end - m_pos >= 3 && std::memcmp(m_pos, "\xEF\xBB\xBF", 3) == 0)
+		{
+			m_pos += 3;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	XmlReader::Name XmlReader::intern(const char* data, size_t size)
+	{
+		// FNV-1a
+		std::uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+		}
+
+		const size_t mask = m_buckets.size() - 1;
+		for (size_t bucket = hash & mask;; bucket = (bucket + 1) & mask)
+		{
+			const Name name = m_buckets[bucket];
+			if (name == 0)
+			{
+				m_names.push_back(std::string(data, size));
+				m_buckets[bucket] = static_cast<Name>(m_names.size());
+				const Name result = m_buckets[bucket];
+				if (m_names.size() * 2 > m_buckets.size())
+				{
+					rehash();
+				}
+				return result;
+			}
+			const std::string& existing = m_names[name - 1];
+			if (existing.size() == size && std::memcmp(existing.data(), data, size) == 0)
+			{
+				return name;
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void XmlReader::rehash()
+	{
+		std::vector<std::string> names;
+		names.swap(m_names);
+		m_buckets.assign(m_buckets.size() * 2, 0);
+		for (const auto& name : names)
+		{	// номера сохраняются, так как имена добавляются в прежнем порядке
+			intern(name.data(), name.size());
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	XmlReader::Name XmlReader::intern(const char* name)
+	{
+		return intern(name, std::strlen(name));
+	}
+	//////////////////////////////////////////////////////////////////////////
+	const std::string& XmlReader::getNameString(Name name) const
+	{
+		if (name == 0 || name > m_names.size())
+		{
+			throw std::runtime_error("GameSpace::XmlReader::getNameString if (name == 0 || name > m_names.size())");
+		}
+		return m_names[name - 1];
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void XmlReader::skipPast(const char* marker)
+	{
+		const size_t length = std::strlen(marker);
+		for (; m_end - m_pos >= static_cast<std::ptrdiff_t>(length); ++m_pos)
+		{
+			if (std::memcmp(m_pos, marker, length) == 0)
+			{
+				m_pos += length;
+				return;
+			}
+		}
+		throw std::runtime_error("GameSpace::XmlReader::skipPast if (!marker)");
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void XmlReader::skipSpaces()
+	{
+		while (m_pos < m_end && isSpace(*m_pos))
+		{
+			++m_pos;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	StringView XmlReader::readName()
+	{
+		const char* begin = m_pos;
+		while (m_pos < m_end && !isSpace(*m_pos) && *m_pos != '/' && *m_pos != '>' && *m_pos != '=')
+		{
+			++m_pos;
+		}
+		if (m_pos == begin)
+		{
+			throw std::runtime_error("GameSpace::XmlReader::readName if (m_pos == begin)");
+		}
+		return StringView(begin, m_pos - begin);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	StringView XmlReader::decode(const char* begin, const char* end)
+	{
+		const char* amp = static_cast<const char*>(std::memchr(begin, '&', end - begin));
+		if (!amp)
+		{	// обычный случай: значение указывает прямо в документ
+			return StringView(begin, end - begin);
+		}
+
+		m_decoded.push_back(std::string(begin, amp));
+		std::string& result = m_decoded.back();
+		for (const char* it = amp; it < end;)
+		{
+			if (*it != '&')
+			{
+				result += *it++;
+				continue;
+			}
+			const char* semicolon = static_cast<const char*>(std::memchr(it, ';', end - it));
+			if (!semicolon)
+			{
+				throw std::runtime_error("GameSpace::XmlReader::decode if (!semicolon)");
+			}
+			const StringView entity(it + 1, semicolon - it - 1);
+			if (entity == "amp")
+			{
+				result += '&';
+			}
+			else if (entity == "lt")
+			{
+				result += '<';
+			}
+			else if (entity == "gt")
+			{
+				result += '>';
+			}
+			else if (entity == "quot")
+			{
+				result += '"';
+			}
+			else if (entity == "apos")
+			{
+				result += '\'';
+			}
+			else if (entity.m_size > 1 && entity.m_data[0] == '#')
+			{	// код символа записывается в UTF-8
+				const bool hex = entity.m_data[1] == 'x';
+				const std::string digits(entity.m_data + (hex ? 2 : 1), entity.m_data + entity.m_size);
+				char* digitsEnd = nullptr;
+				const unsigned long code = std::strtoul(digits.c_str(), &digitsEnd, hex ? 16 : 10);
+				if (digits.empty() || *digitsEnd != '\0' || code > 0x10FFFF)
+				{
+					throw std::runtime_error("GameSpace::XmlReader::decode if (!code)");
+				}
+				if (code < 0x80)
+				{
+					result += static_cast<char>(code);
+				}
+				else if (code < 0x800)
+				{
+					result += static_cast<char>(0xC0 | (code >> 6));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else if (code < 0x10000)
+				{
+					result += static_cast<char>(0xE0 | (code >> 12));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else
+				{
+					result += static_cast<char>(0xF0 | (code >> 18));
+					result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+			}
+			else
+			{
+				throw std::runtime_error("GameSpace::XmlReader::decode if (!entity)");
+			}
+			it = semicolon + 1;
+		}
+		return StringView(result.data(), result.size());
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void XmlReader::readStartTag()
+	{
+		const StringView name = readName();
+		m_name = intern(name.m_data, name.m_size);
+		m_stack.push_back(m_name);
+
+		for (;;)
+		{
+			skipSpaces();
+			if (m_pos >= m_end)
+			{
+				throw std::runtime_error("GameSpace::XmlReader::readStartTag if (m_pos >= m_end)");
+			}
+			if (*m_pos == '>')
+			{
+				++m_pos;
+				return;
+			}
+			if (*m_pos == '/')
+			{
+				if (m_end - m_pos < 2 || m_pos[1] != '>')
+				{
+					throw std::runtime_error("GameSpace::XmlReader::readStartTag if (m_pos[1] != '>')");
+				}
+				m_pos += 2;
+				m_pendingEnd = true;
+				return;
+			}
+
+			Attribute attribute;
+			const StringView attributeName = readName();
+			attribute.m_name = intern(attributeName.m_data, attributeName.m_size);
+			skipSpaces();
+			if (m_pos >= m_end || *m_pos != '=')
+			{
+				throw std::runtime_error("GameSpace::XmlReader::readStartTag if (*m_pos != '=')");
+			}
+			++m_pos;
+			skipSpaces();
+			if (m_pos >= m_end || (*m_pos != '"' && *m_pos != '\''))
+			{
+				throw std::runtime_error("GameSpace::XmlReader::readStartTag if (!quote)");
+			}
+			const char quote = *m_pos++;
+			const char* valueEnd = static_cast<const char*>(std::memchr(m_pos, quote, m_end - m_pos));
+			if (!valueEnd)
+			{
+				throw std::runtime_error("GameSpace::XmlReader::readStartTag if (!valueEnd)");
+			}
+			attribute.m_value = decode(m_pos, valueEnd);
+			m_pos = valueEnd + 1;
+			m_attributes.push_back(attribute);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void XmlReader::readEndTag()
+	{
+		const StringView name = readName();
+		skipSpaces();
+		if (m_pos >= m_end || *m_pos != '>')
+		{
+			throw std::runtime_error("GameSpace::XmlReader::readEndTag if (*m_pos != '>')");
+		}
+		++m_pos;
+
+		m_name = intern(name.m_data, name.m_size);
+		if (m_stack.empty() || m_stack.back() != m_name)
+		{
+			throw std::runtime_error("GameSpace::XmlReader::readEndTag if (m_stack.back() != m_name)");
+		}
+		m_stack.pop_back();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	XmlReader::Event XmlReader::next()
+	{
+		if (m_pendingEnd)
+		{	// <a/> выдается как пара XE_START и XE_END
+			m_pendingEnd = false;
+			m_attributes.clear();
+			m_stack.pop_back();
+			return m_event = Event::XE_END;
+		}
+		m_attributes.clear();
+		m_decoded.clear();
+
+		for (;;)
+		{
+			if (m_pos >= m_end)
+			{
+				if (!m_stack.empty())
+				{
+					throw std::runtime_error("GameSpace::XmlReader::next if (!m_stack.empty())");
+				}
+				m_name = 0;
+				return m_event = Event::XE_EOF;
+			}
+
+			if (*m_pos != '<')
+			{
+				const char* begin = m_pos;
+				const char* end = static_cast<const char*>(std::memchr(m_pos, '<', m_end - m_pos));
+				m_pos = end ? end : m_end;
+				const char* first = begin;
+				while (first < m_pos && isSpace(*first))
+				{
+					++first;
+				}
+				if (first == m_pos)
+				{	// пробелы между элементами
+					continue;
+				}
+				m_text = decode(begin, m_pos);
+				return m_event = Event::XE_TEXT;
+			}
+
+			++m_pos;
+			if (m_pos >= m_end)
+			{
+				throw std::runtime_error("GameSpace::XmlReader::next if (m_pos >= m_end)");
+			}
+			if (*m_pos == '?')
+			{
+				skipPast("?>");
+			}
+			else if (*m_pos == '!')
+			{
+				if (m_end - m_pos >= 3 && std::memcmp(m_pos, "!--", 3) == 0)
+				{
+					skipPast("-->");
+				}
+				else if (m_end - m_pos >= 8 && std::memcmp(m_pos, "![CDATA[", 8) == 0)
+				{
+					m_pos += 8;
+					const char* begin = m_pos;
+					skipPast("]]>");
+					m_text = StringView(begin, m_pos - 3 - begin);
+					return m_event = Event::XE_TEXT;
+				}
+				else
+				{	// DOCTYPE без внутренних объявлений
+					skipPast(">");
+				}
+			}
+			else if (*m_pos == '/')
+			{
+				++m_pos;
+				readEndTag();
+				return m_event = Event::XE_END;
+			}
+			else
+			{
+				readStartTag();
+				return m_event = Event::XE_START;
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool XmlReader::nextChild(size_t depth)
+	{
+		for (;;)
+		{
+			switch (next())
+			{
+			case Event::XE_START:
+				if (m_stack.size() == depth + 1)
+				{
+					return true;
+				}
+				break;
+			case Event::XE_END:
+				if (m_stack.size() < depth)
+				{
+					return false;
+				}
+				break;
+			case Event::XE_TEXT:
+				break;
+			case Event::XE_EOF:
+				throw std::runtime_error("GameSpace::XmlReader::nextChild if (XE_EOF)");
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	StringView XmlReader::readText()
+	{
+		if (m_event != Event::XE_START)
+		{
+			throw std::runtime_error("GameSpace::XmlReader::readText if (m_event != Event::XE_START)");
+		}
+		const size_t depth = m_stack.size();
+		for (;;)
+		{
+			switch (next())
+			{
+			case Event::XE_TEXT:
+				if (m_stack.size() == depth)
+				{
+					return m_text;
+				}
+				break;
+			case Event::XE_END:
+				if (m_stack.size() < depth)
+				{
+					return StringView();
+				}
+				break;
+			case Event::XE_START:
+				break;
+			case Event::XE_EOF:
+				throw std::runtime_error("GameSpace::XmlReader::readText if (XE_EOF)");
+			}
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	bool XmlReader::findAttribute(Name name, StringView& result) const
+	{
+		for (const auto& attribute : m_attributes)
+		{
+			if (attribute.m_name == name)
+			{
+				result = attribute.m_value;
+				return true;
+			}
+		}
+		return false;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	StringView XmlReader::getAttribute(Name name) const
+	{
+		StringView result;
+		if (!findAttribute(name, result))
+		{
+			throw std::runtime_error("GameSpace::XmlReader::getAttribute if (!findAttribute(name, result)) " + getNameString(name));
+		}
+		return result;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	StringView XmlReader::getAttribute(Name name, const StringView& defaultValue) const
+	{
+		StringView result;
+		return findAttribute(name, result) ? result : defaultValue;
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#ifndef XMLREADER_H
+#define XMLREADER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstring>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <stdexcept>
+
+#include "resources.h"
+
+namespace GameSpace
+{
+	/*
+		@brief	участок текста без владения (аналог string_view)
+				указывает в разбираемый документ и живет, пока жив XmlReader
+	*/
+	struct StringView
+	{
+		const char* m_data;
+		size_t m_size;
+
+		StringView() : m_data(""), m_size(0)
+		{}
+		StringView(const char* data, size_t size) : m_data(data), m_size(size)
+		{}
+		bool empty() const
+		{ return m_size == 0; }
+		bool operator==(const char* other) const
+		{ return std::strncmp(m_data, other, m_size) == 0 && other[m_size] == '\0'; }
+		bool operator!=(const char* other) const
+		{ return !(*this == other); }
+		std::string toString() const
+		{ return std::string(m_data, m_size); }
+		/*
+			@brief	разбирает значение целиком как число
+					при лишних символах бросает исключение
+		*/
+		int toInt() const;
+		std::uint32_t toUInt() const;
+		float toFloat() const;
+		/*
+			@brief является ли значение целиком числом
+		*/
+		bool isInt() const;
+		bool isFloat() const;
+	};
+	/*
+		@brief	потоковый (pull) разборщик XML
+				документ берется через Resources и не копируется, события
+				выдаются по одному, имена элементов и атрибутов сравниваются
+				как числа после intern, значения выдаются как StringView
+	*/
+	class XmlReader final
+	{
+	public:
+		// @brief номер имени, 0 - имя не встречалось
+		typedef unsigned Name;
+		// @brief событие разбора
+		enum class Event
+		{
+			XE_START,	// открывающий тег, атрибуты доступны
+			XE_END,		// закрывающий тег (для <a/> выдается сразу после XE_START)
+			XE_TEXT,	// текст или CDATA
+			XE_EOF		// конец документа
+		};
+	private:
+		struct Attribute
+		{
+			Name m_name;
+			StringView m_value;
+		};
+
+		ResourcePtr m_resource;
+		const char* m_pos;
+		const char* m_end;
+
+		Event m_event;
+		Name m_name;					// имя текущего элемента
+		StringView m_text;
+		std::vector<Attribute> m_attributes;
+		std::vector<Name> m_stack;		// открытые элементы
+		bool m_pendingEnd;				// текущий элемент закрыт в самом теге
+		std::deque<std::string> m_decoded;	// значения, в которых были ссылки на символы
+
+		std::vector<std::string> m_names;	// имена по номеру - 1
+		std::vector<Name> m_buckets;		// открытая адресация по хэшу имени
+
+		XmlReader(const XmlReader&) = delete;
+		XmlReader& operator=(const XmlReader&) = delete;
+		/*
+			@brief номер имени, при отсутствии имя добавляется
+		*/
+		Name intern(const char* data, size_t size);
+		/*
+			@brief удваивает таблицу имен
+		*/
+		void rehash();
+		/*
+			@brief пропускает текст до маркера включительно
+		*/
+		void skipPast(const char* marker);
+		/*
+			@brief пропускает пробельные символы
+		*/
+		void skipSpaces();
+		/*
+			@brief читает имя до пробела, '/', '>' или '='
+		*/
+		StringView readName();
+		/*
+			@brief	возвращает значение как есть или с раскрытыми ссылками
+					(&amp; &lt; &gt; &quot; &apos; &#N; &#xN;)
+		*/
+		StringView decode(const char* begin, const char* end);
+		/*
+			@brief разбирает открывающий тег, m_pos указывает за '<'
+		*/
+		void readStartTag();
+		/*
+			@brief разбирает закрывающий тег, m_pos указывает за "</"
+		*/
+		void readEndTag();
+		/*
+			@brief общая инициализация после задания буфера
+		*/
+		void init(const char* data, size_t size);
+	public:
+		/*
+			@brief открывает ресурс
+			@param path путь к XML документу
+		*/
+		explicit XmlReader(const std::string& path);
+		/*
+			@brief разбирает документ в памяти, память должна жить дольше читателя
+		*/
+		XmlReader(const char* data, size_t size);
+		~XmlReader() = default;
+		/*
+			@brief номер имени для сравнения с getName и поиска атрибутов
+		*/
+		Name intern(const char* name);
+		/*
+			@brief	переходит к следующему событию
+					значения с раскрытыми ссылками живут до следующего вызова
+		*/
+		Event next();
+		/*
+			@brief	переходит к следующему дочернему элементу
+					вложенные элементы, которые не разбирались, пропускаются
+			@param depth глубина родителя (getDepth в его XE_START)
+			@ret   найден ли элемент, false - родитель закрыт
+		*/
+		bool nextChild(size_t depth);
+		/*
+			@brief	читает текст текущего элемента, вызывается в XE_START
+			@ret   первый участок текста или пустой, если текста нет
+		*/
+		StringView readText();
+		/*
+			@brief текущее событие
+		*/
+		Event getEvent() const
+		{ return m_event; }
+		/*
+			@brief имя текущего элемента
+		*/
+		Name getName() const
+		{ return m_name; }
+		/*
+			@brief строка имени по номеру
+		*/
+		const std::string& getNameString(Name name) const;
+		/*
+			@brief количество открытых элементов, включая текущий
+		*/
+		size_t getDepth() const
+		{ return m_stack.size(); }
+		/*
+			@brief ищет атрибут текущего элемента
+			@param name номер имени
+			@param result значение атрибута
+			@ret   найден ли атрибут
+		*/
+		bool findAttribute(Name name, StringView& result) const;
+		/*
+			@brief значение обязательного атрибута, при отсутствии бросает исключение
+		*/
+		StringView getAttribute(Name name) const;
+		/*
+			@brief значение необязательного атрибута или пустое
+		*/
+		StringView getAttribute(Name name, const StringView& defaultValue) const;
+		/*
+			@brief текст события XE_TEXT
+		*/
+		StringView getText() const
+		{ return m_text; }
+	};
+}
+
+#endif // !XMLREADER_H
\ No newline at end of file
@@ -0,0 +1,598 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <algorithm>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <SFML/Graphics.hpp>
+#include <Box2D/Box2D.h>
+#include <tinyxml.h>
+
+#include "object.h"
+#include "entitystore.h"
+#include "tmxreader.h"
+#include "layerdecoder.h"
+
+namespace
+{
+	using namespace GameSpace;
+	/*
+		@brief	объект в прежнем устройстве мира: спрайт внутри объекта,
+				объекты в std::list<std::shared_ptr<...>>, каждый шаг и кадр
+				вызывают каждому объекту виртуальные функции, в основном пустые
+	*/
+	class LegacyObject
+	{
+		sf::Sprite m_sprite;
+	protected:
+		sf::Sprite& getSprite()
+		{
+			return m_sprite;
+		}
+	public:
+		LegacyObject(const sf::Texture& texture, const sf::IntRect& rect, const sf::Vector2f& position)
+		{
+			m_sprite.setTexture(texture);
+			m_sprite.setTextureRect(rect);
+			m_sprite.setOrigin(rect.width / 2.0f, rect.height / 2.0f);
+			m_sprite.setPosition(position);
+		}
+		virtual ~LegacyObject() = default;
+		virtual void logic(float delta)
+		{
+		}
+		virtual void animate(float delta)
+		{
+		}
+		virtual bool destroy()
+		{
+			return false;
+		}
+		virtual void saveState()
+		{
+		}
+		virtual void interpolate(float alpha)
+		{
+		}
+		virtual void draw(sf::RenderTarget& render)
+		{
+			render.draw(m_sprite);
+		}
+	};
+	/*
+		@brief прежний объект с телом: положение до шага хранится в объекте
+	*/
+	class LegacyPhysicObject final : public LegacyObject
+	{
+		b2Body* m_body;
+		b2Vec2 m_previousPosition;
+		float32 m_previousAngle;
+		bool m_hasPrevious;
+	public:
+		LegacyPhysicObject(const sf::Texture& texture, const sf::IntRect& rect, const sf::Vector2f& position, b2Body* body)
+			: LegacyObject(texture, rect, position), m_body(body), m_previousAngle(0.0f), m_hasPrevious(false)
+		{
+		}
+		virtual void saveState() override
+		{
+			m_previousPosition = m_body->GetPosition();
+			m_previousAngle = m_body->GetAngle();
+			m_hasPrevious = true;
+		}
+		virtual void interpolate(float alpha) override
+		{
+			b2Vec2 bodyPosition = m_body->GetPosition();
+			float32 bodyAngle = m_body->GetAngle();
+			if (m_hasPrevious)
+			{
+				bodyPosition = alpha * bodyPosition + (1.0f - alpha) * m_previousPosition;
+				bodyAngle = alpha * bodyAngle + (1.0f - alpha) * m_previousAngle;
+			}
+			getSprite().setPosition(std::floor(PhysicObject::mapPhysicToPixel(bodyPosition.x)),
+									std::floor(PhysicObject::mapPhysicToPixel(bodyPosition.y)));
+			getSprite().setRotation(bodyAngle * 57.2957795f);
+		}
+	};
+	// @brief время одного кадра по частям в микросекундах
+	struct FrameTime
+	{
+		sf::Int64 m_update;			// запоминание тел, логика, анимация, проверка уничтожения
+		sf::Int64 m_interpolate;
+		sf::Int64 m_draw;
+	};
+	/*
+		@brief итог прогона в JSON
+	*/
+	void printResult(const char* name, const std::vector<FrameTime>& frames, bool last)
+	{
+		double update = 0.0, interpolate = 0.0, draw = 0.0;
+		std::vector<sf::Int64> totals;
+		for (const auto& frame : frames)
+		{
+			update += frame.m_update;
+			interpolate += frame.m_interpolate;
+			draw += frame.m_draw;
+			totals.push_back(frame.m_update + frame.m_interpolate + frame.m_draw);
+		}
+		std::sort(totals.begin(), totals.end());
+		const double count = static_cast<double>(frames.size());
+		std::cout	<< "  \"" << name << "\": { \"update_us\": " << update / count
+					<< ", \"interpolate_us\": " << interpolate / count
+					<< ", \"draw_us\": " << draw / count
+					<< ", \"frame_us\": " << (update + interpolate + draw) / count
+					<< ", \"frame_p50_us\": " << totals[totals.size() / 2] << " }" << (last ? "" : ",") << std::endl;
+	}
+	/*
+		@brief средняя длительность кадра
+	*/
+	double getMean(const std::vector<FrameTime>& frames)
+	{
+		double total = 0.0;
+		for (const auto& frame : frames)
+		{
+			total += static_cast<double>(frame.m_update + frame.m_interpolate + frame.m_draw);
+		}
+		return total / frames.size();
+	}
+	// @brief карта, прочитанная прежним способом: свойства объектов хранятся строками
+	struct LegacyMap
+	{
+		struct Object
+		{
+			std::string m_type;
+			std::uint32_t m_gid;
+			int m_x, m_y;
+			std::vector<std::pair<std::string, std::string>> m_properties;
+		};
+		int m_width, m_height, m_tileWidth, m_tileHeight;
+		std::map<int, std::string> m_tiles;
+		std::vector<TileLayer> m_layers;
+		std::vector<Object> m_objects;
+	};
+	/*
+		@brief атрибут элемента TinyXML, отсутствующий атрибут - ошибка
+	*/
+	std::string readLegacyValue(TiXmlElement* element, const char* name)
+	{
+		const char* value = element->Attribute(name);
+		if (!value)
+		{
+			throw std::runtime_error("ww-bench: readLegacyValue if (!value)");
+		}
+		return std::string(value);
+	}
+	/*
+		@brief	прежнее чтение карты через дерево TinyXML, как в TmxReader до потокового XmlReader:
+				документ строится целиком, числа разбираются через копии строк,
+				данные слоя декодируются из текста элемента
+				файлы игроков не читаются, поэтому сравнение немного в пользу прежнего способа
+	*/
+	LegacyMap readLegacyMap(const std::string& path)
+	{
+		using namespace std;
+
+		TiXmlDocument mapFile(path.c_str());
+		if (!mapFile.LoadFile())
+		{
+			throw runtime_error("ww-bench: readLegacyMap if (!mapFile.LoadFile())");
+		}
+		TiXmlElement* rootElement = mapFile.FirstChildElement("map");
+		if (!rootElement)
+		{
+			throw runtime_error("ww-bench: readLegacyMap if (!rootElement)");
+		}
+
+		LegacyMap level;
+		level.m_width = stoi(readLegacyValue(rootElement, "width"));
+		level.m_height = stoi(readLegacyValue(rootElement, "height"));
+		level.m_tileWidth = stoi(readLegacyValue(rootElement, "tilewidth"));
+		level.m_tileHeight = stoi(readLegacyValue(rootElement, "tileheight"));
+
+		vector<TiXmlElement*> transparents, opaques, objects;
+		for (TiXmlElement* mapItem = rootElement->FirstChildElement(); mapItem; mapItem = mapItem->NextSiblingElement())
+		{
+			if (strcmp(mapItem->Value(), "tileset") == 0)
+			{
+				const int firstGid(stoi(readLegacyValue(mapItem, "firstgid")));
+				for (TiXmlElement* tileItem = mapItem->FirstChildElement(); tileItem; tileItem = tileItem->NextSiblingElement())
+				{
+					TiXmlElement* imageItem = tileItem->FirstChildElement("image");
+					if (imageItem)
+					{
+						level.m_tiles[firstGid + stoi(readLegacyValue(tileItem, "id"))] = readLegacyValue(imageItem, "source");
+					}
+				}
+			}
+			else if (strcmp(mapItem->Value(), "layer") == 0)
+			{
+				map<string, string> layerProperties;
+				TiXmlElement* properties = mapItem->FirstChildElement("properties");
+				for (TiXmlElement* item = properties ? properties->FirstChildElement() : nullptr; item; item = item->NextSiblingElement())
+				{
+					layerProperties[readLegacyValue(item, "name")] = readLegacyValue(item, "value");
+				}
+				if (layerProperties["visible"] == "transparent")
+				{
+					transparents.push_back(mapItem);
+				}
+				else if (layerProperties["visible"] == "opaque")
+				{
+					opaques.push_back(mapItem);
+				}
+			}
+			else if (strcmp(mapItem->Value(), "objectgroup") == 0)
+			{
+				objects.push_back(mapItem);
+			}
+		}
+
+		auto processLayer = [&](vector<TiXmlElement*>& layers, TileLayer::Kind kind)
+		{
+			for (const auto& item : layers)
+			{
+				TileLayer tileLayer(kind, level.m_width, level.m_height, level.m_tileWidth, level.m_tileHeight);
+				TiXmlElement* dataElement = item->FirstChildElement("data");
+				if (!dataElement)
+				{
+					throw runtime_error("ww-bench: readLegacyMap if (!dataElement)");
+				}
+				const char* encoding = dataElement->Attribute("encoding");
+				if (encoding)
+				{
+					const char* compression = dataElement->Attribute("compression");
+					const char* text = dataElement->GetText();
+					LayerDecoder::decode(	text ? text : "", text ? strlen(text) : 0, encoding, compression ? compression : "",
+											tileLayer.m_gids);
+				}
+				else
+				{
+					size_t currentTileNum = 0;
+					for (TiXmlElement* dataItem = dataElement->FirstChildElement();
+						dataItem && currentTileNum < tileLayer.m_gids.size();
+						dataItem = dataItem->NextSiblingElement())
+					{
+						tileLayer.m_gids[currentTileNum++] = LayerDecoder::clearFlags(static_cast<uint32_t>(stoul(readLegacyValue(dataItem, "gid"))));
+					}
+				}
+				level.m_layers.push_back(tileLayer);
+			}
+		};
+		processLayer(transparents, TileLayer::Kind::TL_TRANSPARENT);
+		processLayer(opaques, TileLayer::Kind::TL_OPAQUE);
+
+		for (const auto& item : objects)
+		{
+			for (TiXmlElement* objectItem = item->FirstChildElement(); objectItem; objectItem = objectItem->NextSiblingElement())
+			{
+				LegacyMap::Object object;
+				object.m_type = readLegacyValue(objectItem, "type");
+				const char* gid = objectItem->Attribute("gid");
+				object.m_gid = gid ? LayerDecoder::clearFlags(static_cast<uint32_t>(stoul(gid))) : 0;
+				object.m_x = stoi(readLegacyValue(objectItem, "x"));
+				object.m_y = stoi(readLegacyValue(objectItem, "y"));
+				if (TiXmlElement* properties = objectItem->FirstChildElement("properties"))
+				{
+					for (TiXmlElement* property = properties->FirstChildElement(); property; property = property->NextSiblingElement())
+					{
+						object.m_properties.push_back(make_pair(readLegacyValue(property, "name"), readLegacyValue(property, "value")));
+					}
+				}
+				level.m_objects.push_back(object);
+			}
+		}
+		return level;
+	}
+	/*
+		@brief медиана длительностей в миллисекундах
+	*/
+	double getMedian(std::vector<double> times)
+	{
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+	/*
+		@brief	сравнение разбора одной карты прежним чтением через TinyXML и TmxReader
+		@param path путь к tmx файлу
+		@param runs число прогонов каждого способа
+	*/
+	int runTmx(const std::string& path, long runs)
+	{
+		using namespace GameSpace;
+
+		// сообщения загрузки уровня не должны попасть в JSON
+		std::streambuf* const output = std::cout.rdbuf(std::cerr.rdbuf());
+		try
+		{
+			std::vector<double> before, after;
+			size_t layers = 0, objects = 0;
+			bool same = true;
+			for (long run = 0; run < runs; ++run)
+			{
+				sf::Clock clock;
+				const LegacyMap legacy(readLegacyMap(path));
+				before.push_back(clock.restart().asMicroseconds() / 1000.0);
+				const LevelData level(TmxReader::read(path));
+				after.push_back(clock.restart().asMicroseconds() / 1000.0);
+
+				// оба способа должны дать одинаковые слои и объекты
+				layers = level.m_layers.size();
+				objects = level.m_objects.size();
+				same = same && legacy.m_layers.size() == layers && legacy.m_objects.size() == objects;
+				for (size_t i = 0; same && i < layers; ++i)
+				{
+					same = legacy.m_layers[i].m_gids == level.m_layers[i].m_gids;
+				}
+			}
+
+			std::cout.rdbuf(output);
+			std::string escaped;
+			for (const char c : path)
+			{
+				if (c == '"' || c == '\\')
+				{
+					escaped += '\\';
+				}
+				escaped += c;
+			}
+			const double legacyMs = getMedian(before);
+			const double currentMs = getMedian(after);
+			std::cout	<< "{" << std::endl
+						<< "  \"map\": \"" << escaped << "\"," << std::endl
+						<< "  \"runs\": " << runs << "," << std::endl
+						<< "  \"layers\": " << layers << "," << std::endl
+						<< "  \"objects\": " << objects << "," << std::endl
+						<< "  \"same_result\": " << (same ? "true" : "false") << "," << std::endl
+						<< "  \"tinyxml_ms\": " << legacyMs << "," << std::endl
+						<< "  \"xmlreader_ms\": " << currentMs << "," << std::endl
+						<< "  \"speedup\": " << (currentMs > 0.0 ? legacyMs / currentMs : 0.0) << std::endl
+						<< "}" << std::endl;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout.rdbuf(output);
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+}
+
+/*
+	сравнение покадровой работы мира над сущностями при прежнем и новом хранении объектов
+	ww-bench [-n <entities>] [-frames <frames>] [-draw]
+		-n       число сущностей, по умолчанию 100000: 40% декораций, 49% неподвижных тел,
+		         10% подвижных тел и 1% эффектов
+		-frames  число измеряемых кадров, по умолчанию 300
+		-draw    рисовать в текстуру вне экрана, без ключа измеряются только шаг и интерполяция
+	шаг Box2D одинаков в обоих случаях и не измеряется, результат выводится в JSON
+
+	сравнение разбора карты прежним чтением через TinyXML и потоковым TmxReader
+	ww-bench -tmx <level.tmx> [-runs <runs>]
+		-runs    число прогонов каждого способа, по умолчанию 5, выводится медиана
+*/
+int main(int argc, char* argv[])
+{
+	using namespace GameSpace;
+
+	long count = 100000;
+	long frames = 300;
+	bool drawing = false;
+	std::string tmx;
+	long runs = 5;
+	bool valid = true;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "-n" && i + 1 < argc)
+		{
+			count = std::strtol(argv[++i], nullptr, 10);
+			valid = valid && count > 0;
+		}
+		else if (arg == "-frames" && i + 1 < argc)
+		{
+			frames = std::strtol(argv[++i], nullptr, 10);
+			valid = valid && frames > 0;
+		}
+		else if (arg == "-draw")
+		{
+			drawing = true;
+		}
+		else if (arg == "-tmx" && i + 1 < argc)
+		{
+			tmx = argv[++i];
+		}
+		else if (arg == "-runs" && i + 1 < argc)
+		{
+			runs = std::strtol(argv[++i], nullptr, 10);
+			valid = valid && runs > 0;
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+	if (!valid)
+	{
+		std::cerr << "usage: ww-bench [-n <entities>] [-frames <frames>] [-draw] | -tmx <level.tmx> [-runs <runs>]" << std::endl;
+		return 2;
+	}
+	if (!tmx.empty())
+	{
+		return runTmx(tmx, runs);
+	}
+
+	try
+	{
+		// без отрисовки текстура не загружается в видеопамять
+		std::unique_ptr<sf::RenderTexture> target;
+		const auto texture = std::make_shared<sf::Texture>();
+		if (drawing)
+		{
+			target.reset(new sf::RenderTexture);
+			sf::Image image;
+			image.create(128, 128, sf::Color::White);
+			if (!target->create(1280, 720) || !texture->loadFromImage(image))
+			{
+				throw std::runtime_error("ww-bench: cannot create render texture");
+			}
+		}
+		const TexturePtr shared(texture);
+
+		b2World physWorld(b2Vec2(0.0f, 10.0f));
+		EntityStore entities;
+		// объекты освобождают сущности раньше, чем удаляется хранилище
+		std::vector<std::shared_ptr<Object>> objects;
+		std::list<std::shared_ptr<LegacyObject>> legacy;
+		objects.reserve(static_cast<size_t>(count));
+
+		// сущности сеткой, чтобы тела не касались друг друга;
+		// прежние объекты создаются вперемешку с новыми, как при загрузке уровня
+		const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+		size_t bodies = 0, movable = 0;
+		for (long i = 0; i < count; ++i)
+		{
+			const int x = 24 + (i % columns) * 48;
+			const int y = 24 + (i / columns) * 48;
+			const sf::IntRect frame((i % 4) * 32, (i / 4 % 4) * 32, 32, 32);
+			const long kind = i % 100;
+			std::shared_ptr<Object> object;
+			if (kind < 40)
+			{
+				object = std::make_shared<SimpleObject>(entities, shared, x, y, frame.left, frame.top, frame.width, frame.height);
+			}
+			else if (kind < 89)
+			{
+				object = std::make_shared<HardObject>(	entities, shared, x, y, frame.left, frame.top, frame.width, frame.height,
+														&physWorld, 0.5f);
+			}
+			else if (kind < 99)
+			{
+				object = std::make_shared<MoveObject>(	entities, shared, x, y, frame.left, frame.top, frame.width, frame.height,
+														&physWorld, 1.0f, 0.5f);
+				++movable;
+			}
+			else
+			{
+				object = std::make_shared<EffectObject>(entities, shared, x, y, frame.left, frame.top, frame.width, frame.height,
+														&physWorld, 0.5f, 0.0f, 0, 1, true);
+			}
+			objects.push_back(object);
+
+			const sf::Vector2f position(static_cast<float>(x), static_cast<float>(y));
+			b2Body* const body = entities.getBody(object->getEntity());
+			if (body)
+			{
+				legacy.push_back(std::make_shared<LegacyPhysicObject>(*texture, frame, position, body));
+				++bodies;
+			}
+			else
+			{
+				legacy.push_back(std::make_shared<LegacyObject>(*texture, frame, position));
+			}
+		}
+		std::vector<EntityStore::Entity> active;
+		for (const auto& object : objects)
+		{
+			active.push_back(object->getEntity());
+		}
+
+		const float delta = 1.0f / 60.0f;
+		const float alpha = 0.5f;
+		const long warmup = std::min(frames, 10L);
+
+		std::vector<FrameTime> before;
+		for (long frame = 0; frame < warmup + frames; ++frame)
+		{
+			FrameTime time = { 0, 0, 0 };
+			sf::Clock clock;
+			for (const auto& object : legacy)
+			{
+				object->saveState();
+			}
+			for (const auto& object : legacy)
+			{
+				object->logic(delta);
+				object->animate(delta);
+			}
+			for (const auto& object : legacy)
+			{
+				object->destroy();
+			}
+			time.m_update = clock.restart().asMicroseconds();
+			for (const auto& object : legacy)
+			{
+				object->interpolate(alpha);
+			}
+			time.m_interpolate = clock.restart().asMicroseconds();
+			if (target)
+			{
+				target->clear();
+				for (const auto& object : legacy)
+				{
+					object->draw(*target);
+				}
+				target->display();
+				time.m_draw = clock.restart().asMicroseconds();
+			}
+			if (frame >= warmup)
+			{
+				before.push_back(time);
+			}
+		}
+
+		std::vector<FrameTime> after;
+		for (long frame = 0; frame < warmup + frames; ++frame)
+		{
+			FrameTime time = { 0, 0, 0 };
+			sf::Clock clock;
+			entities.saveBodies(active);
+			entities.runBehaviours(active, delta);
+			for (const EntityStore::Entity entity : active)
+			{
+				Object* const behaviour = entities.getBehaviour(entity);
+				if (behaviour)
+				{
+					behaviour->destroy();
+				}
+			}
+			time.m_update = clock.restart().asMicroseconds();
+			entities.interpolate(active, alpha);
+			time.m_interpolate = clock.restart().asMicroseconds();
+			if (target)
+			{
+				target->clear();
+				entities.draw(active, *target);
+				target->display();
+				time.m_draw = clock.restart().asMicroseconds();
+			}
+			if (frame >= warmup)
+			{
+				after.push_back(time);
+			}
+		}
+
+		const double speedup = getMean(after) > 0.0 ? getMean(before) / getMean(after) : 0.0;
+		std::cout	<< "{" << std::endl
+					<< "  \"entities\": " << count << "," << std::endl
+					<< "  \"bodies\": " << bodies << "," << std::endl
+					<< "  \"movable_bodies\": " << movable << "," << std::endl
+					<< "  \"frames\": " << frames << "," << std::endl
+					<< "  \"draw\": " << (drawing ? "true" : "false") << "," << std::endl;
+		printResult("before", before, false);
+		printResult("after", after, false);
+		std::cout	<< "  \"speedup\": " << speedup << std::endl
+					<< "}" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include <SFML/Graphics.hpp>
+
+#include "qoicodec.h"
+
+/*
+	конвертер изображений в QOI
+	wwimg <image> [-o <result.qoi>]
+		image любое изображение, которое читает SFML (png, bmp, tga, jpg)
+		-o путь к результату, по умолчанию рядом с исходным с расширением .qoi
+*/
+int main(int argc, char* argv[])
+{
+	using namespace GameSpace;
+
+	std::string source, converted;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "-o" && i + 1 < argc)
+		{
+			converted = argv[++i];
+		}
+		else if (source.empty())
+		{
+			source = arg;
+		}
+		else
+		{
+			source.clear();
+			break;
+		}
+	}
+	if (source.empty())
+	{
+		std::cerr << "usage: wwimg <image> [-o <result.qoi>]" << std::endl;
+		return 2;
+	}
+	if (converted.empty())
+	{
+		const size_t dot = source.find_last_of('.');
+		const size_t slash = source.find_last_of("/\\");
+		converted = (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+			? source.substr(0, dot) + ".qoi" : source + ".qoi";
+	}
+
+	try
+	{
+		sf::Image image;
+		if (!image.loadFromFile(source))
+		{
+			throw std::runtime_error("wwimg: cannot read " + source);
+		}
+		std::vector<std::uint8_t> data;
+		QoiCodec::encode(image.getPixelsPtr(), image.getSize().x, image.getSize().y, data);
+
+		const std::string temporary(converted + ".tmp");
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw std::runtime_error("wwimg: cannot create " + temporary);
+		}
+		const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+		if (fclose(file) != 0 || !written)
+		{
+			remove(temporary.c_str());
+			throw std::runtime_error("wwimg: write failed");
+		}
+		remove(converted.c_str());
+		if (rename(temporary.c_str(), converted.c_str()) != 0)
+		{
+			remove(temporary.c_str());
+			throw std::runtime_error("wwimg: cannot rename " + temporary);
+		}
+		std::cout	<< source << " -> " << converted << std::endl
+					<< "  " << image.getSize().x << "x" << image.getSize().y
+					<< ", " << data.size() << " bytes" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,143 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+
+#include "leveldata.h"
+#include "levelfile.h"
+#include "tmxreader.h"
+#include "levelindex.h"
+#include "xmlreader.h"
+
+namespace
+{
+	using namespace GameSpace;
+	/*
+		@brief	собирает оглавление всех уровней из config.xml
+		@param index путь к результату
+		@param config файл конфигурации игры
+	*/
+	int buildIndex(const std::string& index, const std::string& config)
+	{
+		XmlReader reader(config);
+		if (!reader.nextChild(0) || reader.getName() != reader.intern("game"))
+		{
+			throw std::runtime_error("wwlc: " + config + " has no game element");
+		}
+		const XmlReader::Name levels = reader.intern("levels");
+		const XmlReader::Name img = reader.intern("img");
+		const XmlReader::Name file = reader.intern("file");
+
+		std::vector<LevelIndex::Entry> entries;
+		const size_t depth = reader.getDepth();
+		while (reader.nextChild(depth))
+		{
+			if (reader.getName() != levels)
+			{
+				continue;
+			}
+			const size_t levelsDepth = reader.getDepth();
+			while (reader.nextChild(levelsDepth))
+			{
+				// уровни компилируются заодно, поэтому игре не придется разбирать tmx
+				entries.push_back(LevelIndex::build(reader.getAttribute(file).toString(), reader.getAttribute(img).toString()));
+				const LevelIndex::Entry& entry = entries.back();
+				std::cout	<< "  " << entry.m_levelFile << ": " << entry.m_width << "x" << entry.m_height
+							<< " tiles, " << entry.m_objectCount << " objects, thumbnail "
+							<< entry.m_imageWidth << "x" << entry.m_imageHeight << std::endl;
+			}
+		}
+		LevelIndex::write(entries, index);
+		std::cout << index << ": " << entries.size() << " levels" << std::endl;
+		return 0;
+	}
+}
+
+/*
+	компилятор уровней
+	wwlc <map.tmx> [-o <result.wwl>] [-f]
+		-o путь к результату, по умолчанию рядом с картой
+		-f компилировать, даже если результат не устарел
+	wwlc -i <levels.wwi> <config.xml>
+		-i собрать оглавление уровней для экрана выбора уровня
+*/
+int main(int argc, char* argv[])
+{
+	using namespace GameSpace;
+
+	std::string source, compiled, index;
+	bool force = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "-o" && i + 1 < argc)
+		{
+			compiled = argv[++i];
+		}
+		else if (arg == "-i" && i + 1 < argc)
+		{
+			index = argv[++i];
+		}
+		else if (arg == "-f")
+		{
+			force = true;
+		}
+		else if (source.empty())
+		{
+			source = arg;
+		}
+		else
+		{
+			source.clear();
+			break;
+		}
+	}
+	if (source.empty())
+	{
+		std::cerr << "usage: wwlc <map.tmx> [-o <result.wwl>] [-f]" << std::endl
+				  << "       wwlc -i <levels.wwi> <config.xml>" << std::endl;
+		return 2;
+	}
+	if (!index.empty())
+	{
+		try
+		{
+			return buildIndex(index, source);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
+	if (compiled.empty())
+	{
+		compiled = LevelFile::getCompiledPath(source);
+	}
+
+	try
+	{
+		if (!force && LevelFile::isCurrent(compiled))
+		{
+			std::cout << compiled << " is up to date" << std::endl;
+			return 0;
+		}
+
+		LevelData level(TmxReader::read(source));
+		LevelFile::write(level, compiled);
+
+		MappedFile result;
+		result.open(compiled);
+		std::cout	<< source << " -> " << compiled << std::endl
+					<< "  layers: " << level.m_layers.size()
+					<< ", objects: " << level.m_objects.size()
+					<< ", players: " << level.m_players.size()
+					<< ", images: " << level.m_images.size() << std::endl
+					<< "  size: " << level.m_sources.front().m_size << " -> " << result.getSize() << " bytes" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "deflater.h"
+
+namespace GameSpace
+{
+	//////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		const std::uint16_t lengthBase[29] = {
+			3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		const std::uint8_t lengthExtra[29] = {
+			0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		const std::uint16_t distBase[30] = {
+			1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		const std::uint8_t distExtra[30] = {
+			0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	}
+	//////////////////////////////////////////////////////////////////////////
+	Deflater::Deflater(std::vector<std::uint8_t>& out)
+		: m_out(out), m_bitBuf(0), m_bitCount(0)
+	{
+
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::bits(std::uint32_t value, unsigned count)
+	{
+		m_bitBuf |= value << m_bitCount;
+		m_bitCount += count;
+		while (m_bitCount >= 8)
+		{
+			m_out.push_back(static_cast<std::uint8_t>(m_bitBuf));
+			m_bitBuf >>= 8;
+			m_bitCount -= 8;
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::code(std::uint32_t value, unsigned length)
+	{
+		std::uint32_t reversed = 0;
+		for (unsigned i = 0; i < length; ++i)
+		{
+			reversed = (reversed << 1) | ((value >> i) & 1);
+		}
+		bits(reversed, length);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::literal(unsigned symbol)
+	{
+		// фиксированный код RFC 1951, 3.2.6
+		if (symbol < 144)
+		{
+			code(0x30 + symbol, 8);
+		}
+		else if (symbol < 256)
+		{
+			code(0x190 + symbol - 144, 9);
+		}
+		else if (symbol < 280)
+		{
+			code(symbol - 256, 7);
+		}
+		else
+		{
+			code(0xC0 + symbol - 280, 8);
+		}
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::match(unsigned length, unsigned distance)
+	{
+		unsigned lengthCode = 28;
+		while (lengthBase[lengthCode] > length)
+		{
+			--lengthCode;
+		}
+		literal(257 + lengthCode);
+		bits(length - lengthBase[lengthCode], lengthExtra[lengthCode]);
+
+		unsigned distCode = 29;
+		while (distBase[distCode] > distance)
+		{
+			--distCode;
+		}
+		code(distCode, 5);
+		bits(distance - distBase[distCode], distExtra[distCode]);
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::flush()
+	{
+		if (m_bitCount > 0)
+		{
+			m_out.push_back(static_cast<std::uint8_t>(m_bitBuf));
+		}
+		m_bitBuf = 0;
+		m_bitCount = 0;
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::compress(const std::uint8_t* data, size_t size)
+	{
+		// последний блок, фиксированные коды
+		bits(1, 1);
+		bits(1, 2);
+
+		const size_t hashSize = static_cast<size_t>(1) << m_hashBits;
+		const size_t none = static_cast<size_t>(-1);
+		std::vector<size_t> head(hashSize, none);
+		std::vector<size_t> prev(m_windowSize, none);
+
+		auto hashAt = [data](size_t pos) -> size_t
+		{
+			const std::uint32_t value = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16);
+			return (value * 2654435761u) >> (32 - m_hashBits);
+		};
+		auto insert = [&](size_t pos)
+		{
+			const size_t hash = hashAt(pos);
+			prev[pos % m_windowSize] = head[hash];
+			head[hash] = pos;
+		};
+
+		size_t pos = 0;
+		while (pos < size)
+		{
+			unsigned bestLength = 0;
+			size_t bestDistance = 0;
+			if (pos + m_minMatch <= size)
+			{
+				const size_t limit = std::min<size_t>(m_maxMatch, size - pos);
+				size_t candidate = head[hashAt(pos)];
+				for (unsigned chain = 0;
+					chain < m_maxChain && candidate != none && pos - candidate <= m_windowSize;
+					++chain, candidate = prev[candidate % m_windowSize])
+				{
+					unsigned length = 0;
+					while (length < limit && data[candidate + length] == data[pos + length])
+					{
+						++length;
+					}
+					if (length > bestLength)
+					{
+						bestLength = length;
+						bestDistance = pos - candidate;
+						if (length == limit)
+						{
+							break;
+						}
+					}
+				}
+			}
+
+			if (bestLength >= m_minMatch)
+			{
+				match(bestLength, static_cast<unsigned>(bestDistance));
+				for (size_t end = pos + bestLength; pos < end; ++pos)
+				{
+					if (pos + m_minMatch <= size)
+					{
+						insert(pos);
+					}
+				}
+			}
+			else
+			{
+				literal(data[pos]);
+				if (pos + m_minMatch <= size)
+				{
+					insert(pos);
+				}
+				++pos;
+			}
+		}
+		literal(256);
+		flush();
+	}
+	//////////////////////////////////////////////////////////////////////////
+	void Deflater::deflateZlib(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out)
+	{
+		// CMF: deflate, окно 32 КБ; FLG дополняет заголовок до кратного 31
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		Deflater deflater(out);
+		deflater.compress(data, size);
+
+		std::uint32_t a = 1, b = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		const std::uint32_t adler = (b << 16) | a;
+		out.push_back(static_cast<std::uint8_t>(adler >> 24));
+		out.push_back(static_cast<std::uint8_t>(adler >> 16));
+		out.push_back(static_cast<std::uint8_t>(adler >> 8));
+		out.push_back(static_cast<std::uint8_t>(adler));
+	}
+	//////////////////////////////////////////////////////////////////////////
+}
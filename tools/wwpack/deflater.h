@@ -0,0 +1,66 @@
+#ifndef DEFLATER_H
+#define DEFLATER_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace GameSpace
+{
+	/*
+		@brief	упаковщик deflate для wwpack
+				повторы ищутся по цепочкам хэшей в окне 32 КБ,
+				результат пишется одним блоком с фиксированными кодами Хаффмана
+				в обертке zlib, распаковывается Inflater::inflateZlib
+	*/
+	class Deflater final
+	{
+		static const unsigned m_windowSize = 32768;
+		static const unsigned m_hashBits = 15;
+		static const unsigned m_maxChain = 64;		// кандидатов на позицию
+		static const unsigned m_minMatch = 3;
+		static const unsigned m_maxMatch = 258;
+
+		std::vector<std::uint8_t>& m_out;
+		std::uint32_t m_bitBuf;
+		unsigned m_bitCount;
+
+		explicit Deflater(std::vector<std::uint8_t>& out);
+		Deflater(const Deflater&) = delete;
+		Deflater& operator=(const Deflater&) = delete;
+		/*
+			@brief дописывает count бит, младшие идут первыми
+		*/
+		void bits(std::uint32_t value, unsigned count);
+		/*
+			@brief дописывает код Хаффмана, старшие биты кода идут первыми
+		*/
+		void code(std::uint32_t value, unsigned length);
+		/*
+			@brief литерал или код длины фиксированным кодом
+		*/
+		void literal(unsigned symbol);
+		/*
+			@brief повтор: длина и расстояние
+		*/
+		void match(unsigned length, unsigned distance);
+		/*
+			@brief сбрасывает неполный байт
+		*/
+		void flush();
+		/*
+			@brief сжимает данные одним блоком
+		*/
+		void compress(const std::uint8_t* data, size_t size);
+	public:
+		/*
+			@brief сжимает данные в поток zlib
+			@param data исходные данные
+			@param size размер
+			@param out буфер, к которому дописывается результат
+		*/
+		static void deflateZlib(const std::uint8_t* data, size_t size, std::vector<std::uint8_t>& out);
+	};
+}
+
+#endif // !DEFLATER_H
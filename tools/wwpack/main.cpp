@@ -0,0 +1,311 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+#include "mappedfile.h"
+#include "binarystream.h"
+#include "resourcepack.h"
+#include "qoicodec.h"
+#include "deflater.h"
+
+#include <SFML/Graphics.hpp>
+
+namespace
+{
+	using namespace GameSpace;
+	/*
+		@brief собирает файлы каталога рекурсивно, файл добавляется как есть
+		@param path файл или каталог
+		@param files результат
+	*/
+	void collect(const std::string& path, std::vector<std::string>& files)
+	{
+#ifdef _WIN32
+		const DWORD attributes = GetFileAttributesA(path.c_str());
+		if (attributes == INVALID_FILE_ATTRIBUTES)
+		{
+			throw std::runtime_error("wwpack: " + path + " not found");
+		}
+		if (!(attributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			files.push_back(path);
+			return;
+		}
+		WIN32_FIND_DATAA data;
+		HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+		if (find == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+		do
+		{
+			const std::string name(data.cFileName);
+			if (name != "." && name != "..")
+			{
+				collect(path + "/" + name, files);
+			}
+		} while (FindNextFileA(find, &data));
+		FindClose(find);
+#else
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0)
+		{
+			throw std::runtime_error("wwpack: " + path + " not found");
+		}
+		if (!S_ISDIR(info.st_mode))
+		{
+			files.push_back(path);
+			return;
+		}
+		DIR* dir = opendir(path.c_str());
+		if (!dir)
+		{
+			return;
+		}
+		while (dirent* item = readdir(dir))
+		{
+			const std::string name(item->d_name);
+			if (name != "." && name != "..")
+			{
+				collect(path + "/" + name, files);
+			}
+		}
+		closedir(dir);
+#endif
+	}
+	/*
+		@brief имеет ли имя расширение .png
+	*/
+	bool isPng(const std::string& name)
+	{
+		if (name.size() < 4)
+		{
+			return false;
+		}
+		std::string extension(name.substr(name.size() - 4));
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		return extension == ".png";
+	}
+	/*
+		@brief дописывает данные в файл архива
+	*/
+	void write(FILE* file, const void* data, size_t size)
+	{
+		if (size && fwrite(data, 1, size, file) != size)
+		{
+			throw std::runtime_error("wwpack: write failed");
+		}
+	}
+}
+
+/*
+	упаковщик ресурсов
+	wwpack <result.pak> <path>... [-z] [-q]
+		path файлы и каталоги, имена записей - пути как они заданы
+		-z сжимать записи, которые от этого уменьшаются хотя бы на восьмую часть
+		-q перекодировать PNG в QOI под прежним именем, игра декодирует его быстрее
+*/
+int main(int argc, char* argv[])
+{
+	using namespace GameSpace;
+
+	std::string target;
+	std::vector<std::string> sources;
+	bool compress = false, quick = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "-z")
+		{
+			compress = true;
+		}
+		else if (arg == "-q")
+		{
+			quick = true;
+		}
+		else if (target.empty())
+		{
+			target = arg;
+		}
+		else
+		{
+			sources.push_back(arg);
+		}
+	}
+	if (target.empty() || sources.empty())
+	{
+		std::cerr << "usage: wwpack <result.pak> <path>... [-z] [-q]" << std::endl;
+		return 2;
+	}
+
+	const std::string temporary(target + ".tmp");
+	FILE* file = nullptr;
+	try
+	{
+		std::vector<std::string> files;
+		for (const auto& source : sources)
+		{
+			collect(source, files);
+		}
+
+		std::vector<ResourcePack::Entry> entries;
+		std::vector<std::string> paths;
+		for (const auto& path : files)
+		{
+			ResourcePack::Entry entry;
+			entry.m_name = ResourcePack::normalize(path);
+			if (entry.m_name == ResourcePack::normalize(target) || entry.m_name == ResourcePack::normalize(temporary))
+			{
+				continue;
+			}
+			entry.m_flags = 0;
+			entry.m_offset = entry.m_size = entry.m_packedSize = 0;
+			entry.m_modified = 0;
+			MappedFile::getModifiedTime(path, entry.m_modified);
+			entries.push_back(entry);
+			paths.push_back(path);
+		}
+		// оглавление ищется двоичным поиском, пути идут вместе с записями
+		std::vector<size_t> order(entries.size());
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&entries](size_t a, size_t b)
+		{
+			return entries[a].m_name < entries[b].m_name;
+		});
+		{
+			std::vector<ResourcePack::Entry> sortedEntries;
+			std::vector<std::string> sortedPaths;
+			for (size_t index : order)
+			{
+				if (!sortedEntries.empty() && sortedEntries.back().m_name == entries[index].m_name)
+				{
+					throw std::runtime_error("wwpack: duplicate entry " + entries[index].m_name);
+				}
+				sortedEntries.push_back(entries[index]);
+				sortedPaths.push_back(paths[index]);
+			}
+			entries.swap(sortedEntries);
+			paths.swap(sortedPaths);
+		}
+
+		// размер оглавления зависит только от имен, поэтому данные пишутся сразу за ним,
+		// а оглавление с готовыми смещениями - в конце на свое место
+		file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			throw std::runtime_error("wwpack: cannot create " + temporary);
+		}
+		const std::vector<std::uint8_t> padding(ResourcePack::m_alignment, 0);
+		std::uint64_t position = ResourcePack::getIndexSize(entries);
+		write(file, std::vector<std::uint8_t>(static_cast<size_t>(position), 0).data(), static_cast<size_t>(position));
+
+		std::uint64_t totalSize = 0, totalPacked = 0;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			ResourcePack::Entry& entry = entries[i];
+			const size_t tail = static_cast<size_t>(position % ResourcePack::m_alignment);
+			if (tail)
+			{
+				write(file, padding.data(), ResourcePack::m_alignment - tail);
+				position += ResourcePack::m_alignment - tail;
+			}
+
+			MappedFile source;
+			if (!source.open(paths[i]))
+			{
+				throw std::runtime_error("wwpack: cannot read " + paths[i]);
+			}
+			const std::uint8_t* data = source.getData();
+			size_t size = source.getSize();
+
+			std::vector<std::uint8_t> converted;
+			if (quick && isPng(entry.m_name))
+			{
+				sf::Image image;
+				if (!image.loadFromMemory(data, size))
+				{
+					throw std::runtime_error("wwpack: cannot decode " + paths[i]);
+				}
+				QoiCodec::encode(image.getPixelsPtr(), image.getSize().x, image.getSize().y, converted);
+				entry.m_flags |= ResourcePack::m_qoi;
+				data = converted.data();
+				size = converted.size();
+			}
+			entry.m_offset = position;
+			entry.m_size = entry.m_packedSize = size;
+
+			std::vector<std::uint8_t> packed;
+			if (compress && size)
+			{
+				Deflater::deflateZlib(data, size, packed);
+			}
+			if (!packed.empty() && packed.size() <= size - size / 8)
+			{
+				entry.m_flags |= ResourcePack::m_deflated;
+				entry.m_packedSize = packed.size();
+				write(file, packed.data(), packed.size());
+			}
+			else
+			{
+				write(file, data, size);
+			}
+			position += entry.m_packedSize;
+			totalSize += entry.m_size;
+			totalPacked += entry.m_packedSize;
+		}
+
+		BinaryWriter writer;
+		ResourcePack::writeIndex(writer, entries);
+		if (fseek(file, 0, SEEK_SET) != 0)
+		{
+			throw std::runtime_error("wwpack: seek failed");
+		}
+		write(file, writer.getData().data(), writer.getData().size());
+		const int closed = fclose(file);
+		file = nullptr;
+		if (closed != 0)
+		{
+			throw std::runtime_error("wwpack: write failed");
+		}
+		remove(target.c_str());
+		if (rename(temporary.c_str(), target.c_str()) != 0)
+		{
+			throw std::runtime_error("wwpack: cannot rename " + temporary);
+		}
+
+		std::cout	<< target << ": " << entries.size() << " entries" << std::endl
+					<< "  size: " << totalSize << " -> " << totalPacked << " bytes, archive " << position << " bytes" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		if (file)
+		{
+			fclose(file);
+		}
+		remove(temporary.c_str());
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
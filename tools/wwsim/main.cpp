@@ -0,0 +1,319 @@
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#include "world.h"
+#include "input.h"
+#include "resources.h"
+#include "config.h"
+
+namespace
+{
+	using namespace GameSpace;
+	/*
+		@brief	управление по сценарию из командной строки
+				сценарий - серии через запятую вида <действия>*<шаги>, например R*120,RJ*10,-*30:
+				L - влево, R - вправо, J - прыжок, "-" - без действий, без числа шагов серия длится один шаг
+				после конца сценария действий нет
+	*/
+	class ScriptInput final : public InputSource
+	{
+		std::vector<Replay::Run> m_runs;
+		size_t m_run;
+		std::uint32_t m_step;
+	public:
+		explicit ScriptInput(const std::string& script)
+			: m_run(0), m_step(0)
+		{
+			std::istringstream stream(script);
+			std::string entry;
+			while (std::getline(stream, entry, ','))
+			{
+				const size_t star = entry.find('*');
+				Replay::Run run;
+				run.m_actions = 0;
+				run.m_length = 1;
+				if (star != std::string::npos)
+				{
+					const long length = std::strtol(entry.c_str() + star + 1, nullptr, 10);
+					if (length <= 0)
+					{
+						throw std::runtime_error("ww-sim: bad step count in script entry " + entry);
+					}
+					run.m_length = static_cast<std::uint32_t>(length);
+				}
+				for (const char c : entry.substr(0, star))
+				{
+					switch (c)
+					{
+					case 'L': case 'l':
+						run.m_actions |= IA_LEFT;
+						break;
+					case 'R': case 'r':
+						run.m_actions |= IA_RIGHT;
+						break;
+					case 'J': case 'j':
+						run.m_actions |= IA_JUMP;
+						break;
+					case '-':
+						break;
+					default:
+						throw std::runtime_error("ww-sim: bad action in script entry " + entry);
+					}
+				}
+				m_runs.push_back(run);
+			}
+		}
+		virtual void begin(const std::string&, float) override
+		{
+			m_run = 0;
+			m_step = 0;
+		}
+		virtual Actions next() override
+		{
+			if (m_run >= m_runs.size())
+			{
+				return 0;
+			}
+			const Actions actions = m_runs[m_run].m_actions;
+			if (++m_step >= m_runs[m_run].m_length)
+			{
+				++m_run;
+				m_step = 0;
+			}
+			return actions;
+		}
+	};
+	/*
+		@brief строка в кавычках для JSON
+	*/
+	std::string quote(const std::string& value)
+	{
+		std::ostringstream result;
+		result << '"';
+		for (const char c : value)
+		{
+			if (c == '"' || c == '\\')
+			{
+				result << '\\' << c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+			}
+			else
+			{
+				result << c;
+			}
+		}
+		result << '"';
+		return result.str();
+	}
+	/*
+		@brief	длительность шага по рангу в отсортированном ряду
+		@param sorted длительности по возрастанию, не пустые
+		@param fraction доля от 0 до 1
+	*/
+	sf::Int64 percentile(const std::vector<sf::Int64>& sorted, double fraction)
+	{
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+		return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+	}
+}
+
+/*
+	прогон уровня без окна и звука
+	ww-sim [<level.tmx>] [-n <ticks>] [-margin <pixels>] [-view <width>x<height>] [-script <script>] [-replay <file.wwr>]
+		-n       число шагов физики, по умолчанию длина повтора или 600,
+		         прогон заканчивается раньше при выигрыше или проигрыше
+		-margin  поле активной области вокруг вида, отрицательное - активны все объекты,
+		         по умолчанию из config.xml, как в игре
+		-view    размер вида, по умолчанию размер окна из config.xml, как в игре
+		-script  управление по сценарию, например R*120,RJ*10,-*30
+		-replay  управление из файла повтора, уровень по умолчанию берется из него
+	результат выводится в JSON, сообщения загрузки - в поток ошибок
+*/
+int main(int argc, char* argv[])
+{
+	using namespace GameSpace;
+
+	std::string level, script, replay;
+	long requested = -1;
+	float margin = 0.0f;
+	bool hasMargin = false;
+	sf::Vector2f view(0.0f, 0.0f);
+	bool hasView = false;
+	bool valid = true;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "-n" && i + 1 < argc)
+		{
+			requested = std::strtol(argv[++i], nullptr, 10);
+			valid = valid && requested > 0;
+		}
+		else if (arg == "-margin" && i + 1 < argc)
+		{
+			margin = static_cast<float>(std::atof(argv[++i]));
+			hasMargin = true;
+		}
+		else if (arg == "-view" && i + 1 < argc)
+		{
+			char* end = nullptr;
+			view.x = static_cast<float>(std::strtol(argv[++i], &end, 10));
+			view.y = *end == 'x' || *end == 'X' ? static_cast<float>(std::strtol(end + 1, nullptr, 10)) : 0.0f;
+			hasView = true;
+			valid = valid && view.x > 0.0f && view.y > 0.0f;
+		}
+		else if (arg == "-script" && i + 1 < argc)
+		{
+			script = argv[++i];
+		}
+		else if (arg == "-replay" && i + 1 < argc)
+		{
+			replay = argv[++i];
+		}
+		else if (level.empty() && arg[0] != '-')
+		{
+			level = arg;
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+	if (!valid || (level.empty() && replay.empty()) || (!script.empty() && !replay.empty()))
+	{
+		std::cerr << "usage: ww-sim [<level.tmx>] [-n <ticks>] [-margin <pixels>] [-view <width>x<height>] [-script <script>] [-replay <file.wwr>]" << std::endl;
+		return 2;
+	}
+
+	// сообщения загрузки уровня не должны попасть в JSON
+	std::streambuf* const output = std::cout.rdbuf(std::cerr.rdbuf());
+	try
+	{
+		Resources::mount("Resources.pak");
+		if (!hasView || !hasMargin)
+		{	// активная область строится, как в игре: вокруг вида размером с окно и с полем из config.xml
+			Config::ScreenConfig screen;
+			Config::SimulationConfig simulation;
+			Config::readSimulation("config.xml", screen, simulation);
+			if (!hasView)
+			{
+				view = sf::Vector2f(static_cast<float>(screen.m_width), static_cast<float>(screen.m_height));
+			}
+			if (!hasMargin)
+			{
+				margin = simulation.m_activeMargin;
+			}
+		}
+
+		std::shared_ptr<InputSource> input;
+		std::string inputName("none");
+		if (!replay.empty())
+		{
+			const Replay recorded(Replay::read(replay));
+			if (level.empty())
+			{
+				level = recorded.m_level;
+			}
+			if (requested < 0)
+			{
+				requested = static_cast<long>(recorded.getStepCount());
+			}
+			input = std::make_shared<ReplayInput>(replay);
+			inputName = "replay";
+		}
+		else
+		{	// без сценария игрок стоит на месте
+			input = std::make_shared<ScriptInput>(script);
+			inputName = script.empty() ? "none" : "script";
+		}
+		if (requested < 0)
+		{
+			requested = 600;
+		}
+
+		World world;
+		world.setHeadless(true);
+		world.setInput(input);
+		world.setViewSize(view);
+		world.setActiveMargin(margin);
+		sf::Clock loadClock;
+		world.loadFromFile(level);
+		const sf::Time loadTime = loadClock.getElapsedTime();
+
+		std::vector<sf::Int64> ticks;
+		ticks.reserve(static_cast<size_t>(requested));
+		size_t maxBodies = world.getBodyCount();
+		size_t maxContacts = world.getContactCount();
+		size_t maxActive = world.getActiveObjectCount();
+		std::string result(world.hasPlayer() ? "running" : "none");
+		sf::Clock runClock;
+		while (ticks.size() < static_cast<size_t>(requested))
+		{
+			sf::Clock tickClock;
+			world.runTick();
+			ticks.push_back(tickClock.getElapsedTime().asMicroseconds());
+			maxBodies = std::max(maxBodies, world.getBodyCount());
+			maxContacts = std::max(maxContacts, world.getContactCount());
+			maxActive = std::max(maxActive, world.getActiveObjectCount());
+			if (world.hasPlayer())
+			{
+				if (world.isWin())
+				{
+					result = "win";
+					break;
+				}
+				if (world.isFail())
+				{
+					result = "fail";
+					break;
+				}
+			}
+		}
+		const double seconds = runClock.getElapsedTime().asMicroseconds() / 1e6;
+
+		std::vector<sf::Int64> sorted(ticks);
+		std::sort(sorted.begin(), sorted.end());
+		const bool empty = sorted.empty();
+
+		std::cout.rdbuf(output);
+		std::cout	<< "{" << std::endl
+					<< "  \"level\": " << quote(level) << "," << std::endl
+					<< "  \"input\": " << quote(inputName) << "," << std::endl
+					<< "  \"view\": [" << view.x << ", " << view.y << "]," << std::endl
+					<< "  \"margin\": " << margin << "," << std::endl
+					<< "  \"ticks\": " << ticks.size() << "," << std::endl
+					<< "  \"requested_ticks\": " << requested << "," << std::endl
+					<< "  \"step_seconds\": " << world.getTickStep() << "," << std::endl
+					<< "  \"load_ms\": " << loadTime.asMilliseconds() << "," << std::endl
+					<< "  \"run_seconds\": " << seconds << "," << std::endl
+					<< "  \"ticks_per_second\": " << (seconds > 0.0 ? ticks.size() / seconds : 0.0) << "," << std::endl
+					<< "  \"tick_us\": { \"p50\": " << (empty ? 0 : percentile(sorted, 0.5))
+					<< ", \"p99\": " << (empty ? 0 : percentile(sorted, 0.99))
+					<< ", \"max\": " << (empty ? 0 : sorted.back()) << " }," << std::endl
+					<< "  \"bodies\": " << world.getBodyCount() << "," << std::endl
+					<< "  \"max_bodies\": " << maxBodies << "," << std::endl
+					<< "  \"contacts\": " << world.getContactCount() << "," << std::endl
+					<< "  \"max_contacts\": " << maxContacts << "," << std::endl
+					<< "  \"objects\": " << world.getObjectCount() << "," << std::endl
+					<< "  \"active_objects\": " << world.getActiveObjectCount() << "," << std::endl
+					<< "  \"max_active_objects\": " << maxActive << "," << std::endl
+					<< "  \"result\": " << quote(result) << std::endl
+					<< "}" << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cout.rdbuf(output);
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file